@@ -0,0 +1,322 @@
+#include "AggregateSimulator.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace RRS {
+
+namespace {
+
+// A member is packed in a 32-bit word, one byte per field:
+//   0: bits 0-1 the state, bit 2 a peer at or beyond 'maxRoundsInB' was heard from in this round,
+//      bit 3 the rumor was learned in this round
+//   1: age
+//   2: peers heard from in this round that are behind, i.e. 'numLess' of the state machine
+//   3: peers heard from in this round that are not behind, 'numGreaterOrEqual'
+// and its rounds in B and in C in the low and high bytes of a 16-bit word. Delivering messages
+// only touches the first word.
+const uint32_t k_stateMask = 0x3;
+const uint32_t k_sawMaxB = 0x4;
+const uint32_t k_learned = 0x8;
+const int      k_ageShift = 8;
+const int      k_lessShift = 16;
+const int      k_geShift = 24;
+
+const uint32_t k_unknown = static_cast<uint32_t>(RumorStateMachine::State::UNKNOWN);
+const uint32_t k_new = static_cast<uint32_t>(RumorStateMachine::State::NEW);
+const uint32_t k_known = static_cast<uint32_t>(RumorStateMachine::State::KNOWN);
+const uint32_t k_old = static_cast<uint32_t>(RumorStateMachine::State::OLD);
+
+// Members whose PUSH target is prefetched ahead of their turn
+const uint32_t k_prefetchDistance = 16;
+
+uint32_t field(uint32_t member, int shift)
+{
+    return (member >> shift) & 0xff;
+}
+
+// Add one to a byte field, saturating
+uint32_t increment(uint32_t member, int shift)
+{
+    return field(member, shift) < 0xff ? member + (uint32_t(1) << shift) : member;
+}
+
+// 'ifTrue' if 'condition' is 1, 'ifFalse' if it is 0, without a branch
+uint32_t select(uint32_t condition, uint32_t ifTrue, uint32_t ifFalse)
+{
+    return ifFalse ^ ((ifTrue ^ ifFalse) & (0 - condition));
+}
+
+bool isActive(uint32_t member)
+{
+    return (member & k_stateMask) != k_unknown && (member & k_learned) == 0;
+}
+
+// Finalizer of splitmix64
+uint64_t mix(uint64_t z)
+{
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+} // anonymous namespace
+
+// PRIVATE METHODS
+void AggregateSimulator::advanceStates(RoundStats& stats)
+{
+    const uint32_t maxRoundsTotal = static_cast<uint32_t>(m_networkConfig.maxRoundsTotal());
+    const uint32_t maxRoundsInB = static_cast<uint32_t>(m_networkConfig.maxRoundsInB());
+    const uint32_t maxRoundsInC = static_cast<uint32_t>(m_networkConfig.maxRoundsInC());
+    uint32_t numNew = 0;
+    uint32_t numKnown = 0;
+    uint32_t numOld = 0;
+
+    // 'RumorStateMachine::advanceRound' with selects instead of branches, on 32-bit lanes since
+    // SSE2 has no 64-bit compares, so that the loop is vectorized
+    uint32_t* const members = m_members.data();
+    uint16_t* const rounds = m_rounds.data();
+    const size_t size = m_members.size();
+    for (size_t i = 0; i < size; ++i) {
+        const uint32_t member = members[i];
+        const uint32_t state = member & k_stateMask;
+        const uint32_t isNew = state == k_new;
+        const uint32_t isKnown = state == k_known;
+        const uint32_t isOld = state == k_old;
+        const uint32_t age = field(member, k_ageShift);
+        const uint32_t age1 = age + (age < 0xff);
+        const uint32_t age2 = age1 + (age1 < 0xff);
+        const uint32_t roundsInB = rounds[i] & 0xff;
+        const uint32_t roundsInC = rounds[i] >> 8;
+
+        // NEW: one more round in B, two if most peers are not behind
+        const uint32_t numLess = field(member, k_lessShift);
+        const uint32_t numGreaterOrEqual = field(member, k_geShift);
+        const uint32_t roundsInB2 = roundsInB + 1 + (numGreaterOrEqual > numLess);
+        const uint32_t roundsInB1 = select(roundsInB2 > 0xff, 0xff, roundsInB2);
+        const uint32_t toKnown = ((member & k_sawMaxB) != 0) | (roundsInB1 >= maxRoundsInB);
+        const uint32_t expired = age1 >= maxRoundsTotal;
+        const uint32_t fromNew = select(expired, k_old, select(toKnown, k_known, k_new));
+
+        // KNOWN: one more round in C
+        const uint32_t roundsInC1 = roundsInC + (roundsInC < 0xff);
+        const uint32_t fromKnown = select(expired | (roundsInC1 >= maxRoundsInC), k_old, k_known);
+
+        const uint32_t nextState = select(isNew, fromNew, select(isKnown, fromKnown, state));
+        const uint32_t nextAge = select(isOld, age2, select(state == k_unknown, age, age1));
+        const uint32_t nextRoundsInB = select(isNew, roundsInB1, roundsInB);
+        const uint32_t nextRoundsInC = select(isKnown, roundsInC1, roundsInC);
+        members[i] = nextState | (nextAge << k_ageShift);
+        rounds[i] = static_cast<uint16_t>(nextRoundsInB | (nextRoundsInC << 8));
+
+        numNew += nextState == k_new;
+        numKnown += nextState == k_known;
+        numOld += nextState == k_old;
+    }
+
+    stats.m_numMembers[k_unknown] = size - numNew - numKnown - numOld;
+    stats.m_numMembers[k_new] = numNew;
+    stats.m_numMembers[k_known] = numKnown;
+    stats.m_numMembers[k_old] = numOld;
+}
+
+void AggregateSimulator::deliverMessages(RoundStats& stats)
+{
+    uint32_t* const members = m_members.data();
+    const uint32_t size = networkSize();
+
+    // The PUSH targets are random, load them ahead of time
+    uint32_t targets[k_prefetchDistance];
+    auto prefetch = [&](uint32_t from) {
+        if (from < size && isActive(members[from])) {
+            targets[from % k_prefetchDistance] = peerOf(from, m_round);
+#if defined(__GNUC__)
+            __builtin_prefetch(&members[targets[from % k_prefetchDistance]], 1);
+#endif
+        }
+    };
+    for (uint32_t from = 0; from < k_prefetchDistance; ++from) {
+        prefetch(from);
+    }
+
+    for (uint32_t from = 0; from < size; ++from) {
+        // Members that learned the rumor in this round did not push at its start. Since a member
+        // that is active stays so, the prefetched target is valid.
+        const bool active = isActive(members[from]);
+        const uint32_t to = targets[from % k_prefetchDistance];
+        prefetch(from + k_prefetchDistance);
+        if (!active) {
+            continue;
+        }
+
+        ++stats.m_numPushMessages;
+        if (isLost(from, to, m_round, Message::Type::PUSH)) {
+            ++stats.m_numLost;
+            continue;
+        }
+
+        // 'to' may have pushed to 'from' earlier in this round. If it got the PULL back it
+        // ignores this PUSH, otherwise 'from' ignores its PULL.
+        const uint32_t receiver = members[to];
+        const bool pushedBack = to < from && isActive(receiver) && peerOf(to, m_round) == from &&
+                                !isLost(to, from, m_round, Message::Type::PUSH);
+        if (pushedBack && !isLost(from, to, m_round, Message::Type::PULL)) {
+            ++stats.m_numDuplicates;
+            continue;
+        }
+
+        // The PULL is built before the PUSH is applied
+        const bool knewRumor = (receiver & k_stateMask) != k_unknown;
+        const int theirRound = static_cast<int>(field(receiver, k_ageShift));
+        members[to] = received(receiver, static_cast<int>(field(members[from], k_ageShift)));
+        if (!knewRumor) {
+            --stats.m_numMembers[k_unknown];
+            ++stats.m_numMembers[members[to] & k_stateMask];
+        }
+
+        ++stats.m_numPullMessages;
+        if (isLost(to, from, m_round, Message::Type::PULL)) {
+            ++stats.m_numLost;
+            continue;
+        }
+        if (pushedBack) {
+            ++stats.m_numDuplicates;
+            continue;
+        }
+
+        // An empty PULL still counts the peer, as behind
+        const uint32_t sender = members[from];
+        if (knewRumor) {
+            members[from] = received(sender, theirRound);
+        }
+        else if ((sender & k_stateMask) == k_new) {
+            members[from] = increment(sender, k_lessShift);
+        }
+    }
+}
+
+// PRIVATE CONST METHODS
+uint32_t AggregateSimulator::received(uint32_t member, int theirRound) const
+{
+    const uint32_t state = member & k_stateMask;
+    if (state == k_unknown) {
+        if (theirRound > m_networkConfig.maxRoundsTotal()) {
+            return k_old | k_learned;
+        }
+        member = k_new | k_learned;
+    }
+    else if (state != k_new) {
+        return member;
+    }
+
+    // Compared at the next 'advanceRound', once the age is incremented
+    const int nextAge = static_cast<int>(field(member, k_ageShift)) + 1;
+    if (theirRound < nextAge) {
+        return increment(member, k_lessShift);
+    }
+    if (theirRound >= m_networkConfig.maxRoundsInB()) {
+        return member | k_sawMaxB;
+    }
+    return increment(member, k_geShift);
+}
+
+// CONSTRUCTORS
+AggregateSimulator::AggregateSimulator(uint32_t networkSize,
+                                       const NetworkConfig& networkConfig,
+                                       uint64_t seed,
+                                       double lossRate)
+: m_networkConfig(networkConfig)
+, m_members(networkSize, k_unknown)
+, m_rounds(networkSize, 0)
+, m_seed(mix(seed))
+, m_lossThreshold(0)
+, m_round(0)
+, m_numActive(0)
+{
+    assert(networkSize >= 2);
+    assert(networkConfig.maxRoundsTotal() < 0xff);
+    if (lossRate >= 1) {
+        m_lossThreshold = UINT64_MAX;
+    }
+    else if (lossRate > 0) {
+        m_lossThreshold = static_cast<uint64_t>(lossRate * 18446744073709551616.0);
+    }
+}
+
+// PUBLIC METHODS
+void AggregateSimulator::start(uint32_t member)
+{
+    if ((m_members[member] & k_stateMask) == k_unknown) {
+        m_members[member] = k_new;
+        ++m_numActive;
+    }
+}
+
+AggregateSimulator::RoundStats AggregateSimulator::advanceRound()
+{
+    RoundStats stats = {};
+    stats.m_round = m_round;
+    advanceStates(stats);
+    deliverMessages(stats);
+    m_numActive = stats.m_numMembers[k_new] + stats.m_numMembers[k_known];
+    ++m_round;
+    return stats;
+}
+
+std::vector<AggregateSimulator::RoundStats> AggregateSimulator::run(int maxRounds)
+{
+    std::vector<RoundStats> rounds;
+    while (!done() && static_cast<int>(rounds.size()) < maxRounds) {
+        rounds.push_back(advanceRound());
+    }
+    return rounds;
+}
+
+// PUBLIC CONST METHODS
+uint32_t AggregateSimulator::peerOf(uint32_t member, int round) const
+{
+    const uint64_t random = mix(m_seed ^ mix((static_cast<uint64_t>(round) << 32) | member));
+    const uint32_t peer = static_cast<uint32_t>(((random & 0xffffffff) * (m_members.size() - 1)) >> 32);
+    return peer >= member ? peer + 1 : peer;
+}
+
+bool AggregateSimulator::isLost(uint32_t fromMember, uint32_t toMember, int round, Message::Type type) const
+{
+    if (m_lossThreshold == 0) {
+        return false;
+    }
+    const uint64_t key = (static_cast<uint64_t>(round) << 33) | (static_cast<uint64_t>(type) << 32) | fromMember;
+    return mix(mix((m_seed + 0x9e3779b97f4a7c15ULL) ^ key) ^ toMember) < m_lossThreshold;
+}
+
+RumorStateMachine::State AggregateSimulator::state(uint32_t member) const
+{
+    return static_cast<RumorStateMachine::State>(m_members[member] & k_stateMask);
+}
+
+int AggregateSimulator::age(uint32_t member) const
+{
+    return static_cast<int>(field(m_members[member], k_ageShift));
+}
+
+uint32_t AggregateSimulator::networkSize() const
+{
+    return static_cast<uint32_t>(m_members.size());
+}
+
+int AggregateSimulator::round() const
+{
+    return m_round;
+}
+
+bool AggregateSimulator::done() const
+{
+    return m_numActive == 0;
+}
+
+size_t AggregateSimulator::memoryUsage() const
+{
+    return m_members.capacity() * sizeof(uint32_t) + m_rounds.capacity() * sizeof(uint16_t);
+}
+
+} // project namespace
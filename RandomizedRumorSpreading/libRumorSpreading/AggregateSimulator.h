@@ -0,0 +1,101 @@
+#ifndef RANDOMIZEDRUMORSPREADING_AGGREGATESIMULATOR_H
+#define RANDOMIZEDRUMORSPREADING_AGGREGATESIMULATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Message.h"
+#include "NetworkConfig.h"
+#include "RumorStateMachine.h"
+
+namespace RRS {
+
+/**
+ * Round-synchronous simulation of a single rumor over up to 2^32 - 1 members, without a
+ * 'RumorMember' per member.
+ *
+ * The state of each member is packed in 6 bytes: the 'RumorStateMachine' state in 2 bits and its
+ * age, round counters and the tallies of the current round in bytes. A round applies the state
+ * machine transitions to all the members in one branchless pass that the compiler vectorizes,
+ * then delivers the PUSH message of every member that knew the rumor at the start of the round,
+ * in member order, each answered by a PULL message right away.
+ *
+ * This is exactly what a network of 'RumorMember's does when every member first calls
+ * 'advanceRound', choosing 'peerOf(member, round)', and the PUSH messages are then delivered in
+ * member order, dropping those for which 'isLost' is true. Ages saturate at 255, so
+ * 'maxRoundsTotal' must be below 255.
+ */
+class AggregateSimulator {
+  public:
+    // TYPES
+    struct RoundStats {
+        int      m_round;
+        uint64_t m_numMembers[4]; // Members in each state at the end of the round
+        uint64_t m_numPushMessages;
+        uint64_t m_numPullMessages;
+        uint64_t m_numLost;
+        uint64_t m_numDuplicates; // Messages from a peer already heard from in the round
+    };
+
+  private:
+    // MEMBERS
+    NetworkConfig         m_networkConfig;
+    std::vector<uint32_t> m_members;       // Packed state, see 'AggregateSimulator.cpp'
+    std::vector<uint16_t> m_rounds;        // Packed rounds in B and C
+    uint64_t              m_seed;
+    uint64_t              m_lossThreshold; // Messages whose hash is below are lost
+    int                   m_round;
+    uint64_t              m_numActive;     // Members in state NEW or KNOWN
+
+    // METHODS
+    void advanceStates(RoundStats& stats);
+
+    void deliverMessages(RoundStats& stats);
+
+    // CONST METHODS
+    // Apply a message with the rumor at age 'theirRound' to the packed member 'member'
+    uint32_t received(uint32_t member, int theirRound) const;
+
+  public:
+    // CONSTRUCTORS
+    // Simulate 'networkSize' members, at least 2, that nobody told the rumor yet.
+    AggregateSimulator(uint32_t networkSize, const NetworkConfig& networkConfig, uint64_t seed, double lossRate = 0);
+
+    // METHODS
+    // Add the rumor at 'member', as 'RumorMember::addRumor' does.
+    void start(uint32_t member);
+
+    // Simulate one round
+    RoundStats advanceRound();
+
+    // Simulate rounds until no member is NEW or KNOWN, at most 'maxRounds'. Return the statistics
+    // of every round.
+    std::vector<RoundStats> run(int maxRounds);
+
+    // CONST METHODS
+    // The member 'member' pushes to in round 'round'
+    uint32_t peerOf(uint32_t member, int round) const;
+
+    // Whether the message of type 'type' from 'fromMember' to 'toMember' in round 'round' is lost
+    bool isLost(uint32_t fromMember, uint32_t toMember, int round, Message::Type type) const;
+
+    RumorStateMachine::State state(uint32_t member) const;
+
+    // Age of the rumor at 'member', as of 'RumorStateMachine::age', saturated at 255
+    int age(uint32_t member) const;
+
+    uint32_t networkSize() const;
+
+    // Number of rounds simulated so far
+    int round() const;
+
+    // No member is NEW or KNOWN anymore
+    bool done() const;
+
+    size_t memoryUsage() const;
+};
+
+} // project namespace
+
+#endif //RANDOMIZEDRUMORSPREADING_AGGREGATESIMULATOR_H
@@ -0,0 +1,93 @@
+#include "ConvergenceTracker.h"
+
+namespace RRS {
+
+// CONSTRUCTORS
+ConvergenceTracker::ConvergenceTracker()
+: m_rumors()
+, m_numMembers(0)
+, m_numRumorsOld(0)
+, m_mutex()
+{
+}
+
+// PUBLIC METHODS
+void ConvergenceTracker::track(RumorMember& member)
+{
+    {
+        std::lock_guard<std::mutex> guard(m_mutex); // critical section
+        ++m_numMembers;
+    }
+
+    member.addStateChangeCb([this](int, int rumorId,
+                                   RumorStateMachine::State from,
+                                   RumorStateMachine::State to) {
+        stateChanged(rumorId, from, to);
+    });
+}
+
+void ConvergenceTracker::stateChanged(int rumorId,
+                                      RumorStateMachine::State from,
+                                      RumorStateMachine::State to)
+{
+    typedef RumorStateMachine::State State;
+
+    std::lock_guard<std::mutex> guard(m_mutex); // critical section
+    Counters& counters = m_rumors[rumorId];
+    if (to == State::UNKNOWN) {
+        // Evicted, see 'RumorMember::setMaxRumors': the member no longer counts for the rumor
+        counters.m_numLearned -= counters.m_numLearned > 0 ? 1 : 0;
+        if ((from == State::KNOWN || from == State::OLD) && counters.m_numKnown > 0) {
+            --counters.m_numKnown;
+        }
+        if (from == State::OLD && counters.m_numOld > 0) {
+            if (counters.m_numOld-- == m_numMembers) {
+                --m_numRumorsOld;
+            }
+        }
+        if (counters.m_numLearned == 0) {
+            m_rumors.erase(rumorId);
+        }
+        return;
+    }
+    if (from == State::UNKNOWN) {
+        ++counters.m_numLearned;
+    }
+    if (to == State::KNOWN || (to == State::OLD && from != State::KNOWN)) {
+        ++counters.m_numKnown;
+    }
+    if (to == State::OLD) {
+        if (++counters.m_numOld == m_numMembers) {
+            ++m_numRumorsOld;
+        }
+    }
+}
+
+// PUBLIC CONST METHODS
+size_t ConvergenceTracker::numMembers() const
+{
+    std::lock_guard<std::mutex> guard(m_mutex); // critical section
+    return m_numMembers;
+}
+
+ConvergenceTracker::Counters ConvergenceTracker::counters(int rumorId) const
+{
+    std::lock_guard<std::mutex> guard(m_mutex); // critical section
+    const auto& iter = m_rumors.find(rumorId);
+    return iter != m_rumors.end() ? iter->second : Counters();
+}
+
+bool ConvergenceTracker::isOldEverywhere(int rumorId) const
+{
+    std::lock_guard<std::mutex> guard(m_mutex); // critical section
+    const auto& iter = m_rumors.find(rumorId);
+    return iter != m_rumors.end() && iter->second.m_numOld >= m_numMembers;
+}
+
+bool ConvergenceTracker::allRumorsOld() const
+{
+    std::lock_guard<std::mutex> guard(m_mutex); // critical section
+    return m_numRumorsOld == m_rumors.size();
+}
+
+} // project namespace
@@ -0,0 +1,66 @@
+#ifndef RANDOMIZEDRUMORSPREADING_CONVERGENCETRACKER_H
+#define RANDOMIZEDRUMORSPREADING_CONVERGENCETRACKER_H
+
+#include <mutex>
+#include <unordered_map>
+
+#include "RumorMember.h"
+#include "RumorStateMachine.h"
+
+namespace RRS {
+
+/**
+ * Aggregates the state changes of all the members of a process into per-rumor counters, so that
+ * "has rumor X reached every member" is answered in O(1) instead of querying every member.
+ *
+ * Register each member with 'track()' before it starts spreading rumors. The tracker is
+ * thread-safe and must outlive the members it tracks.
+ */
+class ConvergenceTracker {
+  public:
+    // TYPES
+    struct Counters {
+        size_t m_numLearned = 0;
+        size_t m_numKnown = 0;  // members that reached KNOWN, possibly OLD by now
+        size_t m_numOld = 0;
+    };
+
+  private:
+    // MEMBERS
+    std::unordered_map<int, Counters> m_rumors;  // Rumor ID --> counters
+    size_t                            m_numMembers;
+    size_t                            m_numRumorsOld;  // rumors that are OLD at every member
+    mutable std::mutex                m_mutex;
+
+  public:
+    // CONSTRUCTORS
+    ConvergenceTracker();
+
+    ConvergenceTracker(const ConvergenceTracker& other) = delete;
+
+    ConvergenceTracker& operator=(const ConvergenceTracker& other) = delete;
+
+    // METHODS
+    // Add a state change callback to 'member' and count it as one of the tracked members.
+    void track(RumorMember& member);
+
+    // Record that rumor 'rumorId' changed from state 'from' to state 'to' at some member. A change
+    // to UNKNOWN, i.e. an eviction, takes back what the member counted for.
+    void stateChanged(int rumorId, RumorStateMachine::State from, RumorStateMachine::State to);
+
+    // CONST METHODS
+    size_t numMembers() const;
+
+    // Return the counters of 'rumorId', all zero if no member learned it yet.
+    Counters counters(int rumorId) const;
+
+    // Return true if every tracked member considers 'rumorId' OLD.
+    bool isOldEverywhere(int rumorId) const;
+
+    // Return true if every rumor learned by any tracked member is OLD at every member.
+    bool allRumorsOld() const;
+};
+
+} // project namespace
+
+#endif //RANDOMIZEDRUMORSPREADING_CONVERGENCETRACKER_H
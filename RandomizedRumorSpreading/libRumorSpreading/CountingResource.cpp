@@ -0,0 +1,58 @@
+#include "CountingResource.h"
+
+namespace RRS {
+
+// PRIVATE METHODS
+void* CountingResource::do_allocate(size_t bytes, size_t alignment)
+{
+    void* p = m_upstream->allocate(bytes, alignment);
+    const size_t inUse = m_bytesInUse.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    size_t peak = m_peakBytes.load(std::memory_order_relaxed);
+    while (inUse > peak && !m_peakBytes.compare_exchange_weak(peak, inUse, std::memory_order_relaxed)) {
+    }
+    m_numAllocations.fetch_add(1, std::memory_order_relaxed);
+    return p;
+}
+
+void CountingResource::do_deallocate(void* p, size_t bytes, size_t alignment)
+{
+    m_upstream->deallocate(p, bytes, alignment);
+    m_bytesInUse.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+bool CountingResource::do_is_equal(const MemoryResource& other) const noexcept
+{
+    return this == &other;
+}
+
+// CONSTRUCTORS
+CountingResource::CountingResource(MemoryResource* upstream)
+: m_upstream(upstream)
+, m_bytesInUse(0)
+, m_peakBytes(0)
+, m_numAllocations(0)
+{
+}
+
+// PUBLIC CONST METHODS
+MemoryResource* CountingResource::upstream() const
+{
+    return m_upstream;
+}
+
+size_t CountingResource::bytesInUse() const
+{
+    return m_bytesInUse.load(std::memory_order_relaxed);
+}
+
+size_t CountingResource::peakBytes() const
+{
+    return m_peakBytes.load(std::memory_order_relaxed);
+}
+
+size_t CountingResource::numAllocations() const
+{
+    return m_numAllocations.load(std::memory_order_relaxed);
+}
+
+} // project namespace
@@ -0,0 +1,53 @@
+#ifndef RANDOMIZEDRUMORSPREADING_COUNTINGRESOURCE_H
+#define RANDOMIZEDRUMORSPREADING_COUNTINGRESOURCE_H
+
+#include <atomic>
+#include <cstddef>
+
+#include "MemoryResource.h"
+
+namespace RRS {
+
+/**
+ * Forwards allocations to an upstream resource and counts the bytes in use, e.g. to bound the
+ * footprint of a member or to check that all its memory was returned. Thread-safe if the upstream
+ * resource is.
+ */
+class CountingResource : public MemoryResource {
+  private:
+    // MEMBERS
+    MemoryResource*     m_upstream;
+    std::atomic<size_t> m_bytesInUse;
+    std::atomic<size_t> m_peakBytes;
+    std::atomic<size_t> m_numAllocations;
+
+    // METHODS
+    void* do_allocate(size_t bytes, size_t alignment) override;
+
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+
+    bool do_is_equal(const MemoryResource& other) const noexcept override;
+
+  public:
+    // CONSTRUCTORS
+    explicit CountingResource(MemoryResource* upstream = defaultMemoryResource());
+
+    CountingResource(const CountingResource& other) = delete;
+
+    CountingResource& operator=(const CountingResource& other) = delete;
+
+    // CONST METHODS
+    MemoryResource* upstream() const;
+
+    size_t bytesInUse() const;
+
+    // Largest 'bytesInUse()' so far
+    size_t peakBytes() const;
+
+    // Number of allocations so far
+    size_t numAllocations() const;
+};
+
+} // project namespace
+
+#endif //RANDOMIZEDRUMORSPREADING_COUNTINGRESOURCE_H
@@ -0,0 +1,145 @@
+#include "IntervalMap.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace RRS {
+
+// CONSTRUCTORS
+IntervalMap::IntervalMap()
+: m_intervals()
+, m_size(0)
+{
+}
+
+IntervalMap::IntervalMap(MemoryResource* resource)
+: m_intervals(Intervals::allocator_type(resource))
+, m_size(0)
+{
+}
+
+IntervalMap::IntervalMap(const IntervalMap& other, MemoryResource* resource)
+: m_intervals(other.m_intervals, Intervals::allocator_type(resource))
+, m_size(other.m_size)
+{
+}
+
+// PUBLIC METHODS
+void IntervalMap::assign(int first, int end, int value)
+{
+    if (first >= end) {
+        return;
+    }
+
+    erase(first, end);
+    m_size += static_cast<size_t>(end - first);
+
+    // Merge with the neighbours that hold the same value
+    auto next = m_intervals.lower_bound(first);
+    if (next != m_intervals.end() && next->first == end && next->second.m_value == value) {
+        end = next->second.m_end;
+        next = m_intervals.erase(next);
+    }
+    if (next != m_intervals.begin()) {
+        auto prev = std::prev(next);
+        if (prev->second.m_end == first && prev->second.m_value == value) {
+            prev->second.m_end = end;
+            return;
+        }
+    }
+    m_intervals.emplace_hint(next, first, Interval{end, value});
+}
+
+void IntervalMap::erase(int first, int end)
+{
+    if (first >= end) {
+        return;
+    }
+
+    auto iter = m_intervals.upper_bound(first);
+    if (iter != m_intervals.begin()) {
+        auto prev = std::prev(iter);
+        if (prev->second.m_end > first) {
+            iter = prev;
+        }
+    }
+
+    while (iter != m_intervals.end() && iter->first < end) {
+        const int intervalFirst = iter->first;
+        const Interval interval = iter->second;
+        iter = m_intervals.erase(iter);
+        m_size -= static_cast<size_t>(std::min(end, interval.m_end) - std::max(first, intervalFirst));
+
+        // Keep the parts outside of '[first, end)'
+        if (intervalFirst < first) {
+            m_intervals.emplace_hint(iter, intervalFirst, Interval{first, interval.m_value});
+        }
+        if (interval.m_end > end) {
+            iter = m_intervals.emplace_hint(iter, end, Interval{interval.m_end, interval.m_value});
+            break;
+        }
+    }
+}
+
+void IntervalMap::clear()
+{
+    m_intervals.clear();
+    m_size = 0;
+}
+
+// PUBLIC CONST METHODS
+bool IntervalMap::find(int key, int& value) const
+{
+    auto iter = m_intervals.upper_bound(key);
+    if (iter == m_intervals.begin()) {
+        return false;
+    }
+
+    --iter;
+    if (key >= iter->second.m_end) {
+        return false;
+    }
+
+    value = iter->second.m_value;
+    return true;
+}
+
+bool IntervalMap::contains(int key) const
+{
+    int value;
+    return find(key, value);
+}
+
+void IntervalMap::forEach(int first, int end, const IntervalCb& cb) const
+{
+    auto iter = m_intervals.upper_bound(first);
+    if (iter != m_intervals.begin() && std::prev(iter)->second.m_end > first) {
+        --iter;
+    }
+
+    for (; iter != m_intervals.end() && iter->first < end; ++iter) {
+        cb(std::max(first, iter->first), std::min(end, iter->second.m_end), iter->second.m_value);
+    }
+}
+
+const IntervalMap::Intervals& IntervalMap::intervals() const
+{
+    return m_intervals;
+}
+
+size_t IntervalMap::numIntervals() const
+{
+    return m_intervals.size();
+}
+
+size_t IntervalMap::size() const
+{
+    return m_size;
+}
+
+bool IntervalMap::empty() const
+{
+    return m_intervals.empty();
+}
+
+} // project namespace
@@ -0,0 +1,86 @@
+#ifndef RANDOMIZEDRUMORSPREADING_INTERVALMAP_H
+#define RANDOMIZEDRUMORSPREADING_INTERVALMAP_H
+
+#include <cstddef>
+#include <functional>
+#include <map>
+
+#include "MemoryResource.h"
+
+namespace RRS {
+
+/**
+ * Maps integer keys to integer values, storing runs of consecutive keys that share a value as a
+ * single half-open interval '[first, end)'. Adjacent intervals with the same value are merged, so
+ * dense key ranges cost one entry regardless of their length. Lookups search the ordered
+ * intervals in 'O(log(numIntervals()))'.
+ */
+class IntervalMap {
+  public:
+    // TYPES
+    struct Interval {
+        int m_end;
+        int m_value;
+    };
+
+    // First key --> interval
+    typedef std::map<int, Interval, std::less<int>, ResourceAllocator<std::pair<const int, Interval>>> Intervals;
+
+    // Invoked with (first, end, value) for every stored interval
+    typedef std::function<void(int, int, int)> IntervalCb;
+
+  private:
+    // MEMBERS
+    Intervals m_intervals;
+    size_t    m_size;      // Number of keys
+
+  public:
+    // CONSTRUCTORS
+    IntervalMap();
+
+    // Allocate the intervals from 'resource'
+    explicit IntervalMap(MemoryResource* resource);
+
+    // Copy 'other' into intervals allocated from 'resource'
+    IntervalMap(const IntervalMap& other, MemoryResource* resource);
+
+    IntervalMap(const IntervalMap& other) = default;
+
+    IntervalMap(IntervalMap&& other) = default;
+
+    IntervalMap& operator=(const IntervalMap& other) = default;
+
+    IntervalMap& operator=(IntervalMap&& other) = default;
+
+    // METHODS
+    // Map every key in '[first, end)' to 'value', replacing any previous value.
+    void assign(int first, int end, int value);
+
+    // Remove every key in '[first, end)'.
+    void erase(int first, int end);
+
+    void clear();
+
+    // CONST METHODS
+    // Set 'value' to the value of 'key' and return true if 'key' is present.
+    bool find(int key, int& value) const;
+
+    bool contains(int key) const;
+
+    // Invoke 'cb' for the part of every stored interval that lies within '[first, end)', in
+    // increasing key order.
+    void forEach(int first, int end, const IntervalCb& cb) const;
+
+    const Intervals& intervals() const;
+
+    size_t numIntervals() const;
+
+    // Number of keys
+    size_t size() const;
+
+    bool empty() const;
+};
+
+} // project namespace
+
+#endif //RANDOMIZEDRUMORSPREADING_INTERVALMAP_H
@@ -0,0 +1,70 @@
+#include "MemoryResource.h"
+
+#include <new>
+
+namespace RRS {
+
+#ifdef RRS_STD_PMR
+
+MemoryResource* defaultMemoryResource()
+{
+    return std::pmr::new_delete_resource();
+}
+
+#else
+
+namespace {
+
+class NewDeleteResource : public MemoryResource {
+  private:
+    // METHODS
+    void* do_allocate(size_t bytes, size_t) override
+    {
+        // Without aligned new the alignment is at most that of 'std::max_align_t'
+        return ::operator new(bytes);
+    }
+
+    void do_deallocate(void* p, size_t, size_t) override
+    {
+        ::operator delete(p);
+    }
+
+    bool do_is_equal(const MemoryResource& other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+} // anonymous namespace
+
+// DESTRUCTOR
+MemoryResource::~MemoryResource()
+{
+}
+
+// PUBLIC METHODS
+void* MemoryResource::allocate(size_t bytes, size_t alignment)
+{
+    return do_allocate(bytes, alignment);
+}
+
+void MemoryResource::deallocate(void* p, size_t bytes, size_t alignment)
+{
+    do_deallocate(p, bytes, alignment);
+}
+
+// PUBLIC CONST METHODS
+bool MemoryResource::is_equal(const MemoryResource& other) const noexcept
+{
+    return do_is_equal(other);
+}
+
+MemoryResource* defaultMemoryResource()
+{
+    static NewDeleteResource resource;
+    return &resource;
+}
+
+#endif
+
+} // project namespace
@@ -0,0 +1,128 @@
+#ifndef RANDOMIZEDRUMORSPREADING_MEMORYRESOURCE_H
+#define RANDOMIZEDRUMORSPREADING_MEMORYRESOURCE_H
+
+#include <cstddef>
+
+// 'RRS_STD_PMR' changes the types of the containers, so it must be set for every target
+#ifdef RRS_STD_PMR
+#include <memory_resource>
+#endif
+
+namespace RRS {
+
+#ifdef RRS_STD_PMR
+
+// Built with C++17, the library allocates through 'std::pmr'
+typedef std::pmr::memory_resource MemoryResource;
+
+template <typename T>
+using ResourceAllocator = std::pmr::polymorphic_allocator<T>;
+
+// The global heap
+MemoryResource* defaultMemoryResource();
+
+#else
+
+/**
+ * Source of memory for the containers of the library, the C++14 counterpart of
+ * 'std::pmr::memory_resource'. It keeps the standard names so that derived resources compile
+ * against either.
+ */
+class MemoryResource {
+  private:
+    // METHODS
+    virtual void* do_allocate(size_t bytes, size_t alignment) = 0;
+
+    virtual void do_deallocate(void* p, size_t bytes, size_t alignment) = 0;
+
+    virtual bool do_is_equal(const MemoryResource& other) const noexcept = 0;
+
+  public:
+    // DESTRUCTOR
+    virtual ~MemoryResource();
+
+    // METHODS
+    void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+
+    void deallocate(void* p, size_t bytes, size_t alignment = alignof(std::max_align_t));
+
+    // CONST METHODS
+    bool is_equal(const MemoryResource& other) const noexcept;
+};
+
+// Resource of the 'ResourceAllocator's that are default constructed: the global heap
+MemoryResource* defaultMemoryResource();
+
+/**
+ * Allocator of the standard containers that takes its memory from a 'MemoryResource', the C++14
+ * counterpart of 'std::pmr::polymorphic_allocator'. Like the latter it is not propagated when a
+ * container is copied, assigned or swapped, so containers must be swapped with containers using
+ * the same resource.
+ */
+template <typename T>
+class ResourceAllocator {
+  private:
+    // MEMBERS
+    MemoryResource* m_resource;
+
+  public:
+    // TYPES
+    typedef T value_type;
+
+    // CONSTRUCTORS
+    ResourceAllocator() noexcept
+    : m_resource(defaultMemoryResource())
+    {
+    }
+
+    ResourceAllocator(MemoryResource* resource) noexcept
+    : m_resource(resource)
+    {
+    }
+
+    template <typename U>
+    ResourceAllocator(const ResourceAllocator<U>& other) noexcept
+    : m_resource(other.resource())
+    {
+    }
+
+    // METHODS
+    T* allocate(size_t n)
+    {
+        return static_cast<T*>(m_resource->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* p, size_t n)
+    {
+        m_resource->deallocate(p, n * sizeof(T), alignof(T));
+    }
+
+    // CONST METHODS
+    ResourceAllocator select_on_container_copy_construction() const
+    {
+        return ResourceAllocator();
+    }
+
+    MemoryResource* resource() const
+    {
+        return m_resource;
+    }
+};
+
+template <typename T, typename U>
+bool operator==(const ResourceAllocator<T>& lhs, const ResourceAllocator<U>& rhs)
+{
+    return lhs.resource()->is_equal(*rhs.resource());
+}
+
+template <typename T, typename U>
+bool operator!=(const ResourceAllocator<T>& lhs, const ResourceAllocator<U>& rhs)
+{
+    return !(lhs == rhs);
+}
+
+#endif
+
+} // project namespace
+
+#endif //RANDOMIZEDRUMORSPREADING_MEMORYRESOURCE_H
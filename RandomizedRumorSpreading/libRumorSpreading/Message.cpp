@@ -14,15 +14,20 @@ std::map<Message::Type, std::string> Message::s_enumKeyToString = {
 
 // CONSTRUCTORS
 Message::Message()
+: m_count(1)
+, m_sizeSample(0)
 {
 }
 
 Message::Message(Message::Type type,
                  int rumorId,
-                 int round)
+                 int round,
+                 int count)
 : m_type(type)
 , m_rumorId(rumorId)
 , m_round(round)
+, m_count(count)
+, m_sizeSample(0)
 {
 }
 
@@ -31,7 +36,8 @@ bool Message::operator==(const Message& other) const
 {
     return m_type == other.m_type &&
            m_rumorId == other.m_rumorId &&
-           m_round == other.m_round;
+           m_round == other.m_round &&
+           m_count == other.m_count;
 }
 
 bool Message::operator!=(const Message& other) const
@@ -39,6 +45,12 @@ bool Message::operator!=(const Message& other) const
     return !(*this == other);
 }
 
+// METHODS
+void Message::setSizeSample(uint64_t sample)
+{
+    m_sizeSample = sample;
+}
+
 // CONST METHODS
 Message::Type Message::type() const
 {
@@ -55,13 +67,26 @@ int Message::age() const
     return m_round;
 }
 
+int Message::count() const
+{
+    return m_count;
+}
+
+uint64_t Message::sizeSample() const
+{
+    return m_sizeSample;
+}
+
 // FREE OPERATORS
 std::ostream& operator<<(std::ostream& os, const Message& message)
 {
     os << "[ type: " << Message::s_enumKeyToString[message.m_type]
        << " rumorId: " << message.m_rumorId
-       << " age: " << message.m_round
-       << "]";
+       << " age: " << message.m_round;
+    if (message.m_count != 1) {
+        os << " count: " << message.m_count;
+    }
+    os << "]";
     return os;
 }
 
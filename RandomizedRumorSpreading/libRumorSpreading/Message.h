@@ -1,6 +1,7 @@
 #ifndef RANDOMIZEDRUMORSPREADING_MESSAGE_H
 #define RANDOMIZEDRUMORSPREADING_MESSAGE_H
 
+#include <cstdint>
 #include <vector>
 #include <memory>
 #include <ostream>
@@ -24,6 +25,8 @@ class Message {
     Type m_type;
     int m_rumorId;
     int m_round;
+    int m_count;    // The message covers the rumors '[m_rumorId, m_rumorId + m_count)'
+    uint64_t m_sizeSample; // Piggybacked 'SizeEstimator' sample, 0 if none
 
   public:
     // CONSTRUCTORS
@@ -31,7 +34,8 @@ class Message {
 
     Message(Type type,
             int rumorId,
-            int round);
+            int round,
+            int count = 1);
 
     // OPERATORS
     bool operator==(const Message& other) const;
@@ -40,12 +44,21 @@ class Message {
 
     friend std::ostream& operator<<(std::ostream& os, const Message& message);
 
+    // METHODS
+    void setSizeSample(uint64_t sample);
+
     // CONST METHODS
     Type type() const;
 
     int rumorId() const;
 
     int age() const;
+
+    // Number of consecutive rumor IDs, starting at 'rumorId()', that share this message
+    int count() const;
+
+    // Sample of the sender's network size sketch, 0 if none. Not compared by 'operator=='.
+    uint64_t sizeSample() const;
 };
 
 } // project namespace
@@ -0,0 +1,127 @@
+#include "MessageView.h"
+
+#include "WireFormat.h"
+
+namespace RRS {
+
+// ITERATOR PRIVATE METHODS
+void MessageView::const_iterator::load()
+{
+    if (m_remaining > 0) {
+        // The frame was validated by the view
+        WireFormat::readEntry(m_pos, m_end, m_nextId, m_message);
+    }
+}
+
+// ITERATOR CONSTRUCTORS
+MessageView::const_iterator::const_iterator()
+: m_pos(nullptr)
+, m_end(nullptr)
+, m_remaining(0)
+, m_nextId(0)
+, m_message()
+{
+}
+
+MessageView::const_iterator::const_iterator(const uint8_t* pos, const uint8_t* end, uint32_t count)
+: m_pos(pos)
+, m_end(end)
+, m_remaining(count)
+, m_nextId(0)
+, m_message()
+{
+    load();
+}
+
+// ITERATOR OPERATORS
+const Message& MessageView::const_iterator::operator*() const
+{
+    return m_message;
+}
+
+const Message* MessageView::const_iterator::operator->() const
+{
+    return &m_message;
+}
+
+MessageView::const_iterator& MessageView::const_iterator::operator++()
+{
+    --m_remaining;
+    load();
+    return *this;
+}
+
+bool MessageView::const_iterator::operator==(const const_iterator& other) const
+{
+    return m_remaining == other.m_remaining;
+}
+
+bool MessageView::const_iterator::operator!=(const const_iterator& other) const
+{
+    return !(*this == other);
+}
+
+// CONSTRUCTORS
+MessageView::MessageView(const char* data, size_t size)
+: m_data(reinterpret_cast<const uint8_t*>(data))
+, m_size(size)
+, m_fromMember(-1)
+, m_count(0)
+, m_valid(false)
+{
+    if (!WireFormat::checkHeader(data, size, m_fromMember, m_count)) {
+        m_count = 0;
+        return;
+    }
+
+    const uint8_t* pos = m_data + WireFormat::k_headerSize;
+    const uint8_t* const end = m_data + m_size;
+    int nextId = 0;
+    Message message;
+    for (uint32_t i = 0; i < m_count; ++i) {
+        if (!WireFormat::readEntry(pos, end, nextId, message)) {
+            m_count = 0;
+            return;
+        }
+    }
+    m_valid = pos == end;
+    if (!m_valid) {
+        m_count = 0;
+    }
+}
+
+// PUBLIC CONST METHODS
+bool MessageView::valid() const
+{
+    return m_valid;
+}
+
+int MessageView::fromMember() const
+{
+    return m_fromMember;
+}
+
+size_t MessageView::size() const
+{
+    return m_count;
+}
+
+bool MessageView::empty() const
+{
+    return m_count == 0;
+}
+
+MessageView::const_iterator MessageView::begin() const
+{
+    if (!m_valid) {
+        return end();
+    }
+    return const_iterator(m_data + WireFormat::k_headerSize, m_data + m_size, m_count);
+}
+
+MessageView::const_iterator MessageView::end() const
+{
+    return const_iterator();
+}
+
+} // project namespace
@@ -0,0 +1,85 @@
+#ifndef RANDOMIZEDRUMORSPREADING_MESSAGEVIEW_H
+#define RANDOMIZEDRUMORSPREADING_MESSAGEVIEW_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+
+#include "Message.h"
+
+namespace RRS {
+
+/**
+ * Read-only view of a frame in the 'WireFormat', iterated in place: the messages are decoded one
+ * at a time while iterating and never stored. The frame is validated once by the constructor, so
+ * the iteration cannot fail. The buffer must outlive the view.
+ */
+class MessageView {
+  public:
+    class const_iterator {
+      private:
+        // MEMBERS
+        const uint8_t* m_pos;
+        const uint8_t* m_end;
+        uint32_t       m_remaining;   // Entries left, including the current one
+        int            m_nextId;
+        Message        m_message;
+
+        // METHODS
+        void load();
+
+      public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef Message                   value_type;
+        typedef std::ptrdiff_t            difference_type;
+        typedef const Message*            pointer;
+        typedef const Message&            reference;
+
+        // CONSTRUCTORS
+        // Default constructor. The returned instance is an end iterator.
+        const_iterator();
+
+        const_iterator(const uint8_t* pos, const uint8_t* end, uint32_t count);
+
+        // OPERATORS
+        const Message& operator*() const;
+
+        const Message* operator->() const;
+
+        const_iterator& operator++();
+
+        bool operator==(const const_iterator& other) const;
+
+        bool operator!=(const const_iterator& other) const;
+    };
+
+  private:
+    // MEMBERS
+    const uint8_t* m_data;
+    size_t         m_size;
+    int            m_fromMember;
+    uint32_t       m_count;
+    bool           m_valid;
+
+  public:
+    // CONSTRUCTORS
+    MessageView(const char* data, size_t size);
+
+    // CONST METHODS
+    // False if the frame is malformed, the view is then empty
+    bool valid() const;
+
+    int fromMember() const;
+
+    size_t size() const;
+
+    bool empty() const;
+
+    const_iterator begin() const;
+
+    const_iterator end() const;
+};
+
+} // project namespace
+
+#endif //RANDOMIZEDRUMORSPREADING_MESSAGEVIEW_H
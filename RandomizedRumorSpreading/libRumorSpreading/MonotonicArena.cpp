@@ -0,0 +1,87 @@
+#include "MonotonicArena.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace RRS {
+
+// PRIVATE METHODS
+void* MonotonicArena::do_allocate(size_t bytes, size_t alignment)
+{
+    if (!m_chunks.empty()) {
+        const Chunk& chunk = m_chunks.back();
+        const uintptr_t address = reinterpret_cast<uintptr_t>(chunk.m_data) + m_used;
+        const size_t padding = (alignment - address % alignment) % alignment;
+        if (m_used + padding + bytes <= chunk.m_size) {
+            m_used += padding + bytes;
+            m_bytesAllocated += bytes;
+            return chunk.m_data + (m_used - bytes);
+        }
+    }
+
+    // Chunks are aligned for any type
+    const size_t size = std::max(m_nextChunkSize, bytes);
+    m_chunks.push_back({static_cast<char*>(m_upstream->allocate(size)), size});
+    m_nextChunkSize = 2 * size;
+    m_used = bytes;
+    m_bytesAllocated += bytes;
+    return m_chunks.back().m_data;
+}
+
+void MonotonicArena::do_deallocate(void*, size_t, size_t)
+{
+}
+
+bool MonotonicArena::do_is_equal(const MemoryResource& other) const noexcept
+{
+    return this == &other;
+}
+
+// CONSTRUCTORS
+MonotonicArena::MonotonicArena(MemoryResource* upstream, size_t initialChunkSize)
+: m_upstream(upstream)
+, m_chunks()
+, m_used(0)
+, m_nextChunkSize(std::max<size_t>(initialChunkSize, 64))
+, m_bytesAllocated(0)
+{
+}
+
+// DESTRUCTOR
+MonotonicArena::~MonotonicArena()
+{
+    for (const Chunk& chunk : m_chunks) {
+        m_upstream->deallocate(chunk.m_data, chunk.m_size);
+    }
+}
+
+// PUBLIC METHODS
+void MonotonicArena::release()
+{
+    if (m_chunks.size() > 1) {
+        // The last chunk is the largest
+        for (size_t i = 0; i + 1 < m_chunks.size(); ++i) {
+            m_upstream->deallocate(m_chunks[i].m_data, m_chunks[i].m_size);
+        }
+        m_chunks.erase(m_chunks.begin(), m_chunks.end() - 1);
+    }
+    m_used = 0;
+    m_bytesAllocated = 0;
+}
+
+// PUBLIC CONST METHODS
+size_t MonotonicArena::bytesAllocated() const
+{
+    return m_bytesAllocated;
+}
+
+size_t MonotonicArena::bytesReserved() const
+{
+    size_t reserved = 0;
+    for (const Chunk& chunk : m_chunks) {
+        reserved += chunk.m_size;
+    }
+    return reserved;
+}
+
+} // project namespace
@@ -0,0 +1,64 @@
+#ifndef RANDOMIZEDRUMORSPREADING_MONOTONICARENA_H
+#define RANDOMIZEDRUMORSPREADING_MONOTONICARENA_H
+
+#include <cstddef>
+#include <vector>
+
+#include "MemoryResource.h"
+
+namespace RRS {
+
+/**
+ * Bump allocator for data that dies all at once, e.g. at the end of a round. Memory is carved
+ * from chunks of doubling size taken from the upstream resource, deallocation does nothing and
+ * 'release' frees everything but the largest chunk, which is reused. Once the chunk is large
+ * enough for a round, rounds no longer allocate from the upstream resource. Not thread-safe.
+ */
+class MonotonicArena : public MemoryResource {
+  private:
+    // TYPES
+    struct Chunk {
+        char*  m_data;
+        size_t m_size;
+    };
+
+    // MEMBERS
+    MemoryResource*    m_upstream;
+    std::vector<Chunk> m_chunks;          // The last one is being carved
+    size_t             m_used;            // Bytes carved from the last chunk
+    size_t             m_nextChunkSize;
+    size_t             m_bytesAllocated;  // Since the last 'release'
+
+    // METHODS
+    void* do_allocate(size_t bytes, size_t alignment) override;
+
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+
+    bool do_is_equal(const MemoryResource& other) const noexcept override;
+
+  public:
+    // CONSTRUCTORS
+    explicit MonotonicArena(MemoryResource* upstream = defaultMemoryResource(), size_t initialChunkSize = 1024);
+
+    MonotonicArena(const MonotonicArena& other) = delete;
+
+    MonotonicArena& operator=(const MonotonicArena& other) = delete;
+
+    // DESTRUCTOR
+    ~MonotonicArena() override;
+
+    // METHODS
+    // Invalidate every allocation. Nothing allocated from the arena may be used afterwards.
+    void release();
+
+    // CONST METHODS
+    // Bytes handed out since the last 'release'
+    size_t bytesAllocated() const;
+
+    // Bytes held from the upstream resource
+    size_t bytesReserved() const;
+};
+
+} // project namespace
+
+#endif //RANDOMIZEDRUMORSPREADING_MONOTONICARENA_H
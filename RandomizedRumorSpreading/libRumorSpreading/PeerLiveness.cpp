@@ -0,0 +1,134 @@
+#include "PeerLiveness.h"
+
+#include <algorithm>
+
+namespace RRS {
+
+// PRIVATE METHODS
+void PeerLiveness::setState(int peerId, State state)
+{
+    Peer& peer = m_peers[peerId];
+    if (peer.m_state == state) {
+        return;
+    }
+
+    // Swap-remove from the current list
+    std::vector<int>& from = peer.m_state == State::ALIVE ? m_alive : m_suspected;
+    const int last = from.back();
+    from[peer.m_index] = last;
+    m_peers[last].m_index = peer.m_index;
+    from.pop_back();
+
+    std::vector<int>& to = state == State::ALIVE ? m_alive : m_suspected;
+    peer.m_state = state;
+    peer.m_index = to.size();
+    to.push_back(peerId);
+}
+
+// CONSTRUCTORS
+PeerLiveness::PeerLiveness()
+: m_peers()
+, m_alive()
+, m_suspected()
+, m_suspectAfter(0)
+, m_probeInterval(0)
+, m_pendingPeer(-1)
+, m_round(0)
+, m_nextProbe(0)
+{
+}
+
+PeerLiveness::PeerLiveness(const std::vector<int>& peers, int suspectAfter, int probeInterval)
+: m_peers()
+, m_alive(peers)
+, m_suspected()
+, m_suspectAfter(suspectAfter)
+, m_probeInterval(probeInterval > 0 ? probeInterval : 1)
+, m_pendingPeer(-1)
+, m_round(0)
+, m_nextProbe(0)
+{
+    for (size_t i = 0; i < m_alive.size(); ++i) {
+        m_peers[m_alive[i]] = {State::ALIVE, 0, i, m_probeInterval, 0};
+    }
+}
+
+// PUBLIC METHODS
+void PeerLiveness::newRound()
+{
+    ++m_round;
+    if (m_pendingPeer < 0) {
+        return;
+    }
+
+    Peer& peer = m_peers[m_pendingPeer];
+    ++peer.m_numMissed;
+    if (peer.m_state == State::SUSPECT) {
+        // An unanswered probe
+        peer.m_probeInterval = std::min(2 * peer.m_probeInterval, k_maxProbeBackoff * m_probeInterval);
+        peer.m_probeAtRound = m_round + peer.m_probeInterval;
+    }
+    else if (peer.m_numMissed >= m_suspectAfter) {
+        setState(m_pendingPeer, State::SUSPECT);
+        peer.m_probeInterval = m_probeInterval;
+        peer.m_probeAtRound = m_round + peer.m_probeInterval;
+    }
+    m_pendingPeer = -1;
+}
+
+int PeerLiveness::choosePeer(PeerSchedule& schedule)
+{
+    for (const int peerId : m_suspected) {
+        if (m_peers[peerId].m_probeAtRound <= m_round) {
+            return peerId;
+        }
+    }
+
+    if (m_alive.empty()) {
+        return m_suspected.empty() ? -1 : m_suspected[m_nextProbe++ % m_suspected.size()];
+    }
+
+    // Skip the suspected peers, at most one epoch is needed to find an alive one
+    for (size_t i = 0; i < schedule.size(); ++i) {
+        const int peerId = schedule.next();
+        if (state(peerId) == State::ALIVE) {
+            return peerId;
+        }
+    }
+    return m_alive.front();
+}
+
+void PeerLiveness::pushed(int peerId)
+{
+    if (m_peers.count(peerId) > 0) {
+        m_pendingPeer = peerId;
+    }
+}
+
+void PeerLiveness::heardFrom(int peerId)
+{
+    const auto& iter = m_peers.find(peerId);
+    if (iter == m_peers.end()) {
+        return;
+    }
+
+    if (peerId == m_pendingPeer) {
+        m_pendingPeer = -1;
+    }
+    iter->second.m_numMissed = 0;
+    setState(peerId, State::ALIVE);
+}
+
+// PUBLIC CONST METHODS
+PeerLiveness::State PeerLiveness::state(int peerId) const
+{
+    const auto& iter = m_peers.find(peerId);
+    return iter != m_peers.end() ? iter->second.m_state : State::ALIVE;
+}
+
+size_t PeerLiveness::numSuspected() const
+{
+    return m_suspected.size();
+}
+
+} // project namespace
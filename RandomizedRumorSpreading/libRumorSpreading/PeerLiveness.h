@@ -0,0 +1,83 @@
+#ifndef RANDOMIZEDRUMORSPREADING_PEERLIVENESS_H
+#define RANDOMIZEDRUMORSPREADING_PEERLIVENESS_H
+
+#include <unordered_map>
+#include <vector>
+
+#include "PeerSchedule.h"
+
+namespace RRS {
+
+/**
+ * SWIM-style liveness of the peers of a member, inferred from the rounds themselves. Every PUSH
+ * is answered with at least an empty PULL, so a peer that was pushed to and sent nothing back
+ * before the next round missed that round. After 'suspectAfter' consecutive misses the peer is
+ * suspected and no longer selected, except for probes: the first one 'probeInterval' rounds
+ * later, then with the interval doubled after every unanswered probe, up to
+ * 'k_maxProbeBackoff * probeInterval'. Any message from a suspected peer makes it alive again.
+ */
+class PeerLiveness {
+  public:
+    // ENUMS
+    enum class State {
+        ALIVE,
+        SUSPECT,
+    };
+
+    // CONSTANTS
+    static const int k_maxProbeBackoff = 16;
+
+  private:
+    // TYPES
+    struct Peer {
+        State  m_state;
+        int    m_numMissed;      // Consecutive rounds without an answer
+        size_t m_index;          // Position in 'm_alive' or 'm_suspected'
+        int    m_probeInterval;  // Rounds between probes while suspected
+        int    m_probeAtRound;
+    };
+
+    // MEMBERS
+    std::unordered_map<int, Peer> m_peers;      // Peer ID --> liveness
+    std::vector<int>              m_alive;
+    std::vector<int>              m_suspected;
+    int                           m_suspectAfter;
+    int                           m_probeInterval;
+    int                           m_pendingPeer;  // Pushed to in this round and did not answer yet
+    int                           m_round;
+    size_t                        m_nextProbe;    // Suspected peer to probe when none is alive
+
+    // METHODS
+    // Move 'peerId' to the list of peers in 'state'
+    void setState(int peerId, State state);
+
+  public:
+    // CONSTRUCTORS
+    // Default constructor. The returned instance tracks no peers.
+    PeerLiveness();
+
+    PeerLiveness(const std::vector<int>& peers, int suspectAfter, int probeInterval);
+
+    // METHODS
+    // Account for the peer pushed to in the previous round. Call once at the start of every round.
+    void newRound();
+
+    // Return the peer to push to in this round: a suspected peer whose probe is due, otherwise the
+    // next alive peer of 'schedule'. Return -1 if there are no peers.
+    int choosePeer(PeerSchedule& schedule);
+
+    // Record that a PUSH was sent to 'peerId' in this round.
+    void pushed(int peerId);
+
+    // Record that a message was received from 'peerId'.
+    void heardFrom(int peerId);
+
+    // CONST METHODS
+    State state(int peerId) const;
+
+    size_t numSuspected() const;
+};
+
+} // project namespace
+
+#endif //RANDOMIZEDRUMORSPREADING_PEERLIVENESS_H
@@ -0,0 +1,80 @@
+#include "PeerSchedule.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace RRS {
+
+// CONSTRUCTORS
+// PRIVATE METHODS
+int PeerSchedule::next(std::vector<int>& peers, size_t& position)
+{
+    // Start a new epoch
+    if (position == peers.size()) {
+        std::shuffle(peers.begin(), peers.end(), m_generator);
+        position = 0;
+    }
+    return peers[position++];
+}
+
+// CONSTRUCTORS
+PeerSchedule::PeerSchedule()
+: m_peers()
+, m_position(0)
+, m_remotePeers()
+, m_remotePosition(0)
+, m_remoteProbability(0)
+, m_generator()
+{
+}
+
+PeerSchedule::PeerSchedule(const std::vector<int>& peers, unsigned seed)
+: m_peers(peers)
+, m_position(peers.size())
+, m_remotePeers()
+, m_remotePosition(0)
+, m_remoteProbability(0)
+, m_generator(seed)
+{
+}
+
+PeerSchedule::PeerSchedule(const std::vector<int>& localPeers,
+                           const std::vector<int>& remotePeers,
+                           double remoteProbability,
+                           unsigned seed)
+: m_peers(localPeers)
+, m_position(localPeers.size())
+, m_remotePeers(remotePeers)
+, m_remotePosition(remotePeers.size())
+, m_remoteProbability(remoteProbability)
+, m_generator(seed)
+{
+    assert(remoteProbability > 0 && remoteProbability <= 1);
+
+    // A single list is walked as without locality
+    if (m_peers.empty()) {
+        m_peers.swap(m_remotePeers);
+        m_position = m_peers.size();
+        m_remotePosition = 0;
+    }
+}
+
+// PUBLIC METHODS
+int PeerSchedule::next()
+{
+    if (m_peers.empty()) {
+        return -1;
+    }
+    if (!m_remotePeers.empty() && std::bernoulli_distribution(m_remoteProbability)(m_generator)) {
+        return next(m_remotePeers, m_remotePosition);
+    }
+    return next(m_peers, m_position);
+}
+
+// PUBLIC CONST METHODS
+size_t PeerSchedule::size() const
+{
+    return m_peers.size() + m_remotePeers.size();
+}
+
+} // project namespace
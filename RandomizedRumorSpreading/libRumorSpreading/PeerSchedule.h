@@ -0,0 +1,64 @@
+#ifndef RANDOMIZEDRUMORSPREADING_PEERSCHEDULE_H
+#define RANDOMIZEDRUMORSPREADING_PEERSCHEDULE_H
+
+#include <random>
+#include <vector>
+
+namespace RRS {
+
+/**
+ * Order in which a member pushes to its peers. Every epoch walks a fresh random permutation of
+ * the peers, so each peer is selected exactly once per 'size()' rounds. Compared to independent
+ * uniform choices, no peer is skipped for long or hit repeatedly, which tightens the tail of the
+ * time to full dissemination without sending more messages. 'next()' is O(1) amortized: the
+ * permutation is reshuffled in place once per epoch.
+ *
+ * With a locality, the peers are split into local peers, e.g. in the same zone or rack, and remote
+ * peers, each walked in its own permutation. Every selection is remote with probability
+ * 'remoteProbability' and local otherwise, so cross-zone traffic drops to about that fraction.
+ * Any positive probability keeps the O(ln n) rounds to full dissemination: once the rumor is
+ * known by m members of a zone, about m * remoteProbability of them push out of it every round,
+ * so crossing to the other zones adds O(1 / remoteProbability) rounds, not a factor.
+ */
+class PeerSchedule {
+  private:
+    // MEMBERS
+    std::vector<int> m_peers;          // Permutation of the current epoch, the local peers
+    size_t           m_position;       // Next peer in 'm_peers'
+    std::vector<int> m_remotePeers;    // Permutation of the remote peers, empty without locality
+    size_t           m_remotePosition; // Next peer in 'm_remotePeers'
+    double           m_remoteProbability;
+    std::mt19937     m_generator;
+
+    // METHODS
+    // Return the next peer of the permutation 'peers', reshuffled when 'position' wraps
+    int next(std::vector<int>& peers, size_t& position);
+
+  public:
+    // CONSTRUCTORS
+    // Default constructor. The returned schedule has no peers.
+    PeerSchedule();
+
+    // Construct a schedule over 'peers' whose permutations are drawn from a generator seeded with
+    // 'seed'.
+    PeerSchedule(const std::vector<int>& peers, unsigned seed);
+
+    // Construct a schedule that selects one of 'remotePeers' with probability 'remoteProbability',
+    // in (0, 1], and one of 'localPeers' otherwise. If either list is empty the other is used.
+    PeerSchedule(const std::vector<int>& localPeers,
+                 const std::vector<int>& remotePeers,
+                 double remoteProbability,
+                 unsigned seed);
+
+    // METHODS
+    // Return the next peer, or -1 if there are no peers.
+    int next();
+
+    // CONST METHODS
+    // Number of peers, i.e. the length of an epoch without locality
+    size_t size() const;
+};
+
+} // project namespace
+
+#endif //RANDOMIZEDRUMORSPREADING_PEERSCHEDULE_H
@@ -0,0 +1,121 @@
+#include "PhaseTimers.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace RRS {
+
+// PRIVATE METHODS
+void PhaseTimers::copyFrom(const PhaseTimers& other)
+{
+#ifdef RRS_PHASE_TIMERS
+    for (size_t phase = 0; phase < k_numPhases; ++phase) {
+        const Counters& from = other.m_counters[phase];
+        Counters& to = m_counters[phase];
+        to.m_count.store(from.m_count.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        to.m_totalTicks.store(from.m_totalTicks.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        to.m_maxTicks.store(from.m_maxTicks.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        for (size_t i = 0; i < k_numBuckets; ++i) {
+            to.m_buckets[i].store(from.m_buckets[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+    }
+#else
+    (void)other;
+#endif
+}
+
+// CONSTRUCTORS
+PhaseTimers::PhaseTimers()
+{
+#ifdef RRS_PHASE_TIMERS
+    for (Counters& counters : m_counters) {
+        counters.m_count.store(0);
+        counters.m_totalTicks.store(0);
+        counters.m_maxTicks.store(0);
+        for (auto& bucket : counters.m_buckets) {
+            bucket.store(0);
+        }
+    }
+#endif
+}
+
+PhaseTimers::PhaseTimers(const PhaseTimers& other)
+{
+    copyFrom(other);
+}
+
+PhaseTimers& PhaseTimers::operator=(const PhaseTimers& other)
+{
+    if (this != &other) {
+        copyFrom(other);
+    }
+    return *this;
+}
+
+// STATIC METHODS
+double PhaseTimers::nanosecondsPerTick()
+{
+    static const double s_nsPerTick = []() {
+        const auto start = std::chrono::steady_clock::now();
+        const uint64_t startTicks = now();
+        auto end = start;
+        while (end - start < std::chrono::milliseconds(10)) {
+            end = std::chrono::steady_clock::now();
+        }
+        const uint64_t ticks = now() - startTicks;
+        const double ns = std::chrono::duration<double, std::nano>(end - start).count();
+        return ticks > 0 ? ns / ticks : 1.0;
+    }();
+    return s_nsPerTick;
+}
+
+// PUBLIC CONST METHODS
+double PhaseTimers::Histogram::percentile(double quantile) const
+{
+    if (m_count == 0) {
+        return 0;
+    }
+
+    const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(quantile * m_count)));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < k_numBuckets; ++i) {
+        seen += m_buckets[i];
+        if (seen >= rank) {
+            return std::min(std::ldexp(m_nsPerTick, static_cast<int>(i)), m_maxNs);
+        }
+    }
+    return m_maxNs;
+}
+
+double PhaseTimers::Histogram::meanNs() const
+{
+    return m_count > 0 ? m_totalNs / m_count : 0;
+}
+
+PhaseTimers::Snapshot PhaseTimers::snapshot() const
+{
+    Snapshot snapshot;
+    const double nsPerTick = k_enabled ? nanosecondsPerTick() : 1.0;
+    for (size_t phase = 0; phase < k_numPhases; ++phase) {
+        Histogram& histogram = snapshot[phase];
+        histogram.m_nsPerTick = nsPerTick;
+#ifdef RRS_PHASE_TIMERS
+        const Counters& counters = m_counters[phase];
+        histogram.m_count = counters.m_count.load(std::memory_order_relaxed);
+        histogram.m_totalNs = counters.m_totalTicks.load(std::memory_order_relaxed) * nsPerTick;
+        histogram.m_maxNs = counters.m_maxTicks.load(std::memory_order_relaxed) * nsPerTick;
+        for (size_t i = 0; i < k_numBuckets; ++i) {
+            histogram.m_buckets[i] = counters.m_buckets[i].load(std::memory_order_relaxed);
+        }
+#else
+        histogram.m_count = 0;
+        histogram.m_totalNs = 0;
+        histogram.m_maxNs = 0;
+        histogram.m_buckets.fill(0);
+#endif
+    }
+    return snapshot;
+}
+
+} // project namespace
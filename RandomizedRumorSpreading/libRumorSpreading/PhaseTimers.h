@@ -0,0 +1,180 @@
+#ifndef RANDOMIZEDRUMORSPREADING_PHASETIMERS_H
+#define RANDOMIZEDRUMORSPREADING_PHASETIMERS_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+#ifdef RRS_PHASE_TIMERS
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <chrono>
+#endif
+#endif
+
+namespace RRS {
+
+/**
+ * Latency histograms of the phases of the hot paths of a member. Phases are timed with the CPU
+ * timestamp counter by 'Scope' objects and 'lock', which compile to plain code unless the library
+ * is built with 'RRS_PHASE_TIMERS' (the CMake option of the same name). Recording is lock-free, so
+ * 'snapshot' may be called while the member is in use from other threads.
+ */
+class PhaseTimers {
+  public:
+    // ENUMS
+    enum class Phase {
+        LOCK_WAIT,      // Waiting for the member's mutex
+        STATE_UPDATE,   // Updating rumor tables and state machines
+        MESSAGE_BUILD,  // Building the outgoing messages
+        CALLBACKS,      // Running the state change callbacks
+    };
+
+    // CONSTANTS
+    static const size_t k_numPhases = 4;
+
+    // Bucket 'i > 0' counts the durations in '[2^(i-1), 2^i)' ticks, bucket 0 those below one tick
+    static const size_t k_numBuckets = 48;
+
+#ifdef RRS_PHASE_TIMERS
+    static const bool k_enabled = true;
+#else
+    static const bool k_enabled = false;
+#endif
+
+    // TYPES
+    struct Histogram {
+        uint64_t                           m_count;
+        double                             m_totalNs;
+        double                             m_maxNs;
+        std::array<uint64_t, k_numBuckets> m_buckets;
+        double                             m_nsPerTick; // Width of the buckets
+
+        // Upper bound in nanoseconds of the bucket holding the 'quantile' of the durations
+        double percentile(double quantile) const;
+
+        double meanNs() const;
+    };
+
+    typedef std::array<Histogram, k_numPhases> Snapshot;
+
+    // Times the phase from its construction to its destruction
+    class Scope {
+#ifdef RRS_PHASE_TIMERS
+        PhaseTimers& m_timers;
+        Phase        m_phase;
+        uint64_t     m_start;
+
+      public:
+        Scope(PhaseTimers& timers, Phase phase)
+        : m_timers(timers)
+        , m_phase(phase)
+        , m_start(now())
+        {
+        }
+
+        ~Scope()
+        {
+            m_timers.record(m_phase, now() - m_start);
+        }
+#else
+      public:
+        Scope(PhaseTimers&, Phase)
+        {
+        }
+#endif
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+  private:
+    // TYPES
+    struct Counters {
+        std::atomic<uint64_t>                           m_count;
+        std::atomic<uint64_t>                           m_totalTicks;
+        std::atomic<uint64_t>                           m_maxTicks;
+        std::array<std::atomic<uint64_t>, k_numBuckets> m_buckets;
+    };
+
+#ifdef RRS_PHASE_TIMERS
+    // MEMBERS
+    std::array<Counters, k_numPhases> m_counters;
+#endif
+
+    // METHODS
+    void copyFrom(const PhaseTimers& other);
+
+  public:
+    // CONSTRUCTORS
+    PhaseTimers();
+
+    PhaseTimers(const PhaseTimers& other);
+
+    PhaseTimers& operator=(const PhaseTimers& other);
+
+    // STATIC METHODS
+    // Current value of the timestamp counter
+    static uint64_t now()
+    {
+#ifdef RRS_PHASE_TIMERS
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+#else
+        return 0;
+#endif
+    }
+
+    // Duration of a tick of 'now', measured once against the steady clock
+    static double nanosecondsPerTick();
+
+    // METHODS
+    // Add a duration of 'ticks' to the histogram of 'phase'
+    void record(Phase phase, uint64_t ticks)
+    {
+#ifdef RRS_PHASE_TIMERS
+        Counters& counters = m_counters[static_cast<size_t>(phase)];
+        size_t bucket = 0;
+        for (uint64_t rest = ticks; rest > 0 && bucket + 1 < k_numBuckets; rest >>= 1) {
+            ++bucket;
+        }
+        counters.m_count.fetch_add(1, std::memory_order_relaxed);
+        counters.m_totalTicks.fetch_add(ticks, std::memory_order_relaxed);
+        counters.m_buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+
+        uint64_t max = counters.m_maxTicks.load(std::memory_order_relaxed);
+        while (ticks > max && !counters.m_maxTicks.compare_exchange_weak(max, ticks, std::memory_order_relaxed)) {
+        }
+#else
+        (void)phase;
+        (void)ticks;
+#endif
+    }
+
+    // Lock 'mutex', recording the wait as 'Phase::LOCK_WAIT'
+    std::unique_lock<std::mutex> lock(std::mutex& mutex)
+    {
+#ifdef RRS_PHASE_TIMERS
+        if (mutex.try_lock()) {
+            record(Phase::LOCK_WAIT, 0);
+            return std::unique_lock<std::mutex>(mutex, std::adopt_lock);
+        }
+        Scope scope(*this, Phase::LOCK_WAIT);
+#endif
+        return std::unique_lock<std::mutex>(mutex);
+    }
+
+    // CONST METHODS
+    // Return the histograms recorded so far, all empty unless 'k_enabled'
+    Snapshot snapshot() const;
+};
+
+} // project namespace
+
+#endif //RANDOMIZEDRUMORSPREADING_PHASETIMERS_H
@@ -0,0 +1,118 @@
+#include "RoundScheduler.h"
+
+#include <algorithm>
+
+namespace RRS {
+
+// CONSTRUCTORS
+RoundScheduler::RoundScheduler(RumorMember& member,
+                               Clock::duration fastInterval,
+                               Clock::duration maxInterval)
+: m_member(member)
+, m_fastInterval(fastInterval)
+, m_maxInterval(std::max(fastInterval, maxInterval))
+, m_interval(fastInterval)
+, m_lastRound(Clock::time_point::min())
+, m_nextRound(Clock::time_point::max())
+, m_woken(false)
+, m_stopped(false)
+, m_mutex()
+, m_condition()
+{
+    if (m_member.numRumors(RumorStateMachine::State::NEW) > 0) {
+        m_nextRound = Clock::now();
+    }
+    else if (m_member.numRumors(RumorStateMachine::State::KNOWN) > 0) {
+        m_nextRound = Clock::now() + m_fastInterval;
+    }
+
+    m_member.addStateChangeCb([this](int, int, RumorStateMachine::State from, RumorStateMachine::State) {
+        if (from == RumorStateMachine::State::UNKNOWN) {
+            wake();
+        }
+    });
+}
+
+// PUBLIC METHODS
+std::pair<int, std::vector<Message>> RoundScheduler::advanceRound()
+{
+    {
+        std::lock_guard<std::mutex> guard(m_mutex); // critical section
+        m_woken = false;
+    }
+
+    // Rumors learned from here on set 'm_woken', so they cannot be missed by the counts below
+    std::pair<int, std::vector<Message>> result = m_member.advanceRound();
+    const size_t numNew = m_member.numRumors(RumorStateMachine::State::NEW);
+    const size_t numKnown = m_member.numRumors(RumorStateMachine::State::KNOWN);
+
+    std::lock_guard<std::mutex> guard(m_mutex); // critical section
+    m_lastRound = Clock::now();
+    if (numNew > 0 || m_woken) {
+        m_interval = m_fastInterval;
+        m_nextRound = m_lastRound + m_interval;
+    }
+    else if (numKnown > 0) {
+        m_interval = std::min(2 * m_interval, m_maxInterval);
+        m_nextRound = m_lastRound + m_interval;
+    }
+    else {
+        m_interval = m_fastInterval;
+        m_nextRound = Clock::time_point::max();
+    }
+    return result;
+}
+
+void RoundScheduler::wake()
+{
+    std::lock_guard<std::mutex> guard(m_mutex); // critical section
+    m_woken = true;
+    m_interval = m_fastInterval;
+    m_nextRound = std::min(m_nextRound, m_lastRound + m_fastInterval);
+    m_condition.notify_all();
+}
+
+bool RoundScheduler::waitForRound()
+{
+    std::unique_lock<std::mutex> guard(m_mutex); // critical section
+    while (!m_stopped) {
+        if (m_nextRound == Clock::time_point::max()) {
+            m_condition.wait(guard);
+        }
+        else if (Clock::now() < m_nextRound) {
+            m_condition.wait_until(guard, m_nextRound);
+        }
+        else {
+            return true;
+        }
+    }
+    return false;
+}
+
+void RoundScheduler::stop()
+{
+    std::lock_guard<std::mutex> guard(m_mutex); // critical section
+    m_stopped = true;
+    m_condition.notify_all();
+}
+
+// PUBLIC CONST METHODS
+RoundScheduler::Clock::time_point RoundScheduler::nextRoundAt() const
+{
+    std::lock_guard<std::mutex> guard(m_mutex); // critical section
+    return m_nextRound;
+}
+
+RoundScheduler::Clock::duration RoundScheduler::interval() const
+{
+    std::lock_guard<std::mutex> guard(m_mutex); // critical section
+    return m_interval;
+}
+
+bool RoundScheduler::isIdle() const
+{
+    std::lock_guard<std::mutex> guard(m_mutex); // critical section
+    return m_nextRound == Clock::time_point::max();
+}
+
+} // project namespace
@@ -0,0 +1,75 @@
+#ifndef RANDOMIZEDRUMORSPREADING_ROUNDSCHEDULER_H
+#define RANDOMIZEDRUMORSPREADING_ROUNDSCHEDULER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+#include "RumorMember.h"
+
+namespace RRS {
+
+/**
+ * Decides when a 'RumorMember' should advance its next round, based on its rumor activity:
+ *   - While any rumor is NEW, rounds are 'fastInterval' apart.
+ *   - While only KNOWN (and OLD) rumors remain, the interval doubles after every round, up to
+ *     'maxInterval'.
+ *   - When every rumor is OLD, or there are none, the scheduler is idle and no round is due.
+ * A rumor that is added locally or learned from a peer wakes the scheduler: the next round is due
+ * 'fastInterval' after the previous one, immediately if that time has already passed.
+ *
+ * The scheduler can be driven from an event loop ('nextRoundAt', 'advanceRound') or from a
+ * dedicated thread ('waitForRound', 'advanceRound'). It is thread-safe and must outlive the
+ * member it schedules, since it registers a state change callback on it.
+ */
+class RoundScheduler {
+  public:
+    // TYPES
+    typedef std::chrono::steady_clock Clock;
+
+  private:
+    // MEMBERS
+    RumorMember&            m_member;
+    const Clock::duration   m_fastInterval;
+    const Clock::duration   m_maxInterval;
+    Clock::duration         m_interval;   // Current distance between rounds
+    Clock::time_point       m_lastRound;  // Clock::time_point::min() before the first round
+    Clock::time_point       m_nextRound;  // Clock::time_point::max() while idle
+    bool                    m_woken;      // A rumor was learned since the last round started
+    bool                    m_stopped;
+    mutable std::mutex      m_mutex;
+    std::condition_variable m_condition;
+
+  public:
+    // CONSTRUCTORS
+    RoundScheduler(RumorMember& member, Clock::duration fastInterval, Clock::duration maxInterval);
+
+    RoundScheduler(const RoundScheduler& other) = delete;
+
+    RoundScheduler& operator=(const RoundScheduler& other) = delete;
+
+    // METHODS
+    // Advance the member by one round and schedule the next one.
+    std::pair<int, std::vector<Message>> advanceRound();
+
+    // Make the next round due within 'fastInterval' of the previous one.
+    void wake();
+
+    // Block until the next round is due. Return false once 'stop' was called.
+    bool waitForRound();
+
+    // Release every thread blocked in 'waitForRound'.
+    void stop();
+
+    // CONST METHODS
+    // Time at which the next round is due, Clock::time_point::max() while idle.
+    Clock::time_point nextRoundAt() const;
+
+    Clock::duration interval() const;
+
+    bool isIdle() const;
+};
+
+} // project namespace
+
+#endif //RANDOMIZEDRUMORSPREADING_ROUNDSCHEDULER_H
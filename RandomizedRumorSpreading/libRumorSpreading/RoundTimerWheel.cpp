@@ -0,0 +1,50 @@
+#include "RoundTimerWheel.h"
+
+namespace RRS {
+
+// CONSTRUCTORS
+RoundTimerWheel::RoundTimerWheel()
+: m_buckets(k_numBuckets)
+, m_size(0)
+{
+}
+
+// PUBLIC METHODS
+void RoundTimerWheel::schedule(int round, int id)
+{
+    m_buckets[static_cast<size_t>(round) % k_numBuckets].push_back({round, id});
+    ++m_size;
+}
+
+void RoundTimerWheel::expire(int round, std::vector<int>& due)
+{
+    std::vector<Timer>& bucket = m_buckets[static_cast<size_t>(round) % k_numBuckets];
+    size_t numKept = 0;
+    for (const Timer& timer : bucket) {
+        if (timer.m_round == round) {
+            due.push_back(timer.m_id);
+        }
+        else if (timer.m_round > round) {
+            bucket[numKept++] = timer;
+        }
+    }
+    m_size -= bucket.size() - numKept;
+    bucket.resize(numKept);
+}
+
+// PUBLIC CONST METHODS
+size_t RoundTimerWheel::size() const
+{
+    return m_size;
+}
+
+size_t RoundTimerWheel::memoryUsage() const
+{
+    size_t bytes = m_buckets.capacity() * sizeof(std::vector<Timer>);
+    for (const std::vector<Timer>& bucket : m_buckets) {
+        bytes += bucket.capacity() * sizeof(Timer);
+    }
+    return bytes;
+}
+
+} // project namespace
@@ -0,0 +1,53 @@
+#ifndef RANDOMIZEDRUMORSPREADING_ROUNDTIMERWHEEL_H
+#define RANDOMIZEDRUMORSPREADING_ROUNDTIMERWHEEL_H
+
+#include <cstddef>
+#include <vector>
+
+namespace RRS {
+
+/**
+ * Timers that expire in a given round, hashed into 'k_numBuckets' buckets by round. Scheduling is
+ * O(1) and expiring a round only visits its bucket, which also holds the timers due
+ * 'k_numBuckets' rounds apart; those are kept for a later turn of the wheel. Timers are not
+ * cancelled: the owner ignores the IDs it no longer expects.
+ */
+class RoundTimerWheel {
+  public:
+    // CONSTANTS
+    static const size_t k_numBuckets = 64;
+
+  private:
+    // TYPES
+    struct Timer {
+        int m_round;
+        int m_id;
+    };
+
+    // MEMBERS
+    std::vector<std::vector<Timer>> m_buckets;
+    size_t                          m_size;
+
+  public:
+    // CONSTRUCTORS
+    RoundTimerWheel();
+
+    // METHODS
+    // Expire 'id' in round 'round'.
+    void schedule(int round, int id);
+
+    // Append the IDs of the timers of 'round' to 'due' and remove them. Timers of earlier rounds
+    // in the same bucket were missed and are dropped.
+    void expire(int round, std::vector<int>& due);
+
+    // CONST METHODS
+    // Number of pending timers
+    size_t size() const;
+
+    // Heap bytes held by the buckets
+    size_t memoryUsage() const;
+};
+
+} // project namespace
+
+#endif //RANDOMIZEDRUMORSPREADING_ROUNDTIMERWHEEL_H
@@ -0,0 +1,102 @@
+#include "RumorCohort.h"
+
+#include <algorithm>
+
+namespace RRS {
+
+// CONSTRUCTORS
+RumorCohort::RumorCohort()
+: m_stateMachine()
+, m_size(0)
+, m_createdInRound(-1)
+, m_syncedRound(-1)
+, m_dueRound(-1)
+{
+}
+
+RumorCohort::RumorCohort(const RumorStateMachine& stateMachine, int round)
+: m_stateMachine(stateMachine)
+, m_size(0)
+, m_createdInRound(round)
+, m_syncedRound(round)
+, m_dueRound(-1)
+{
+}
+
+// PUBLIC METHODS
+void RumorCohort::add(size_t numRumors)
+{
+    m_size += numRumors;
+}
+
+void RumorCohort::remove(size_t numRumors)
+{
+    m_size -= numRumors;
+}
+
+RumorStateMachine& RumorCohort::stateMachine()
+{
+    return m_stateMachine;
+}
+
+void RumorCohort::advanceRound(const RumorStateMachine::PeerSet& peersInCurrentRound, int round)
+{
+    m_stateMachine.advanceRound(peersInCurrentRound);
+    m_syncedRound = round + 1;
+}
+
+void RumorCohort::catchUp(int round)
+{
+    m_stateMachine.skipRounds(round - m_syncedRound);
+    m_syncedRound = std::max(m_syncedRound, round);
+}
+
+void RumorCohort::setDueRound(int round)
+{
+    m_dueRound = round;
+}
+
+// PUBLIC CONST METHODS
+const RumorStateMachine& RumorCohort::stateMachine() const
+{
+    return m_stateMachine;
+}
+
+size_t RumorCohort::size() const
+{
+    return m_size;
+}
+
+bool RumorCohort::empty() const
+{
+    return m_size == 0;
+}
+
+int RumorCohort::createdInRound() const
+{
+    return m_createdInRound;
+}
+
+int RumorCohort::syncedRound() const
+{
+    return m_syncedRound;
+}
+
+int RumorCohort::dueRound() const
+{
+    return m_dueRound;
+}
+
+int RumorCohort::age(int round) const
+{
+    return m_stateMachine.ageAfter(round - m_syncedRound);
+}
+
+RumorStateMachine RumorCohort::stateMachineAt(int round) const
+{
+    RumorStateMachine stateMachine(m_stateMachine);
+    stateMachine.skipRounds(round - m_syncedRound);
+    return stateMachine;
+}
+
+} // project namespace
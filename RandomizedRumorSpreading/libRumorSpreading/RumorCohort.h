@@ -0,0 +1,74 @@
+#ifndef RANDOMIZEDRUMORSPREADING_RUMORCOHORT_H
+#define RANDOMIZEDRUMORSPREADING_RUMORCOHORT_H
+
+#include <cstddef>
+
+#include "RumorStateMachine.h"
+
+namespace RRS {
+
+/**
+ * A group of rumors whose state machines are identical. Rumors that are added, or first received
+ * from the same member with the same age, in the same round share a single 'RumorStateMachine'
+ * which is advanced once per round for the whole group. A rumor leaves its cohort as soon as an
+ * event only applies to that rumor. The rumor IDs themselves are kept by the member, which maps
+ * ranges of rumor IDs to cohorts.
+ */
+class RumorCohort {
+  private:
+    // MEMBERS
+    RumorStateMachine m_stateMachine;
+    size_t            m_size;
+    int               m_createdInRound; // Other rumors can only join during this round
+    int               m_syncedRound;    // The state machine reflects every round before this one
+    int               m_dueRound;       // Round in which a KNOWN cohort becomes OLD, -1 if none
+
+  public:
+    // CONSTRUCTORS
+    // Default constructor. The returned cohort will hold an invalid state machine.
+    RumorCohort();
+
+    // Construct an empty cohort sharing 'stateMachine', created during round 'round'.
+    RumorCohort(const RumorStateMachine& stateMachine, int round);
+
+    // METHODS
+    // Count 'numRumors' more rumors as members of this cohort.
+    void add(size_t numRumors);
+
+    // Count 'numRumors' rumors as having left this cohort.
+    void remove(size_t numRumors);
+
+    RumorStateMachine& stateMachine();
+
+    // Advance the state machine by the round 'round', the first one it did not reflect yet.
+    void advanceRound(const RumorStateMachine::PeerSet& peersInCurrentRound, int round);
+
+    // Apply the rounds before 'round' that were skipped while the cohort was KNOWN or OLD.
+    void catchUp(int round);
+
+    void setDueRound(int round);
+
+    // CONST METHODS
+    const RumorStateMachine& stateMachine() const;
+
+    size_t size() const;
+
+    bool empty() const;
+
+    int createdInRound() const;
+
+    // First round not reflected by the state machine
+    int syncedRound() const;
+
+    int dueRound() const;
+
+    // Age of the rumors once the rounds before 'round' are applied
+    int age(int round) const;
+
+    // Copy of the state machine once the rounds before 'round' are applied
+    RumorStateMachine stateMachineAt(int round) const;
+};
+
+} // project namespace
+
+#endif //RANDOMIZEDRUMORSPREADING_RUMORCOHORT_H
@@ -1,7 +1,12 @@
 #include "RumorMember.h"
 
+#include <algorithm>
 #include <random>
 #include <cassert>
+#include <climits>
+#include <cmath>
+
+#include "TraceRecorder.h"
 
 #define LITERAL(s) #s
 
@@ -16,8 +21,29 @@ std::map<RumorMember::StatisticKey, std::string> RumorMember::s_enumKeyToString
     {StatisticKey::NumEmptyPushMessages, LITERAL(NumEmptyPushMessages)},
     {StatisticKey::NumPullMessages,      LITERAL(NumPullMessages)},
     {StatisticKey::NumEmptyPullMessages, LITERAL(NumEmptyPullMessages)},
+    {StatisticKey::NumEvictedRumors,     LITERAL(NumEvictedRumors)},
+    {StatisticKey::NumRejectedRumors,    LITERAL(NumRejectedRumors)},
+    {StatisticKey::NumDroppedRumors,     LITERAL(NumDroppedRumors)},
+    {StatisticKey::NumDuplicateRumors,   LITERAL(NumDuplicateRumors)},
+    {StatisticKey::NumImportedRumors,    LITERAL(NumImportedRumors)},
 };
 
+// CONSTANTS
+const int RumorMember::k_maxExpandedRumors;
+
+// NESTED TYPES
+size_t RumorMember::MemoryUsage::total() const
+{
+    return m_rumors + m_cohorts + m_roundState + m_peers + m_view;
+}
+
+RumorMember::Memory::Memory(MemoryResource* upstream)
+: m_rumors(upstream)
+, m_cohorts(upstream)
+, m_round(upstream)
+{
+}
+
 // PRIVATE METHODS
 void RumorMember::toVector(const std::unordered_set<int>& peers)
 {
@@ -27,14 +53,176 @@ void RumorMember::toVector(const std::unordered_set<int>& peers)
         }
     }
     increaseStatValue(StatisticKey::NumPeers, peers.size() - 1);
+
+    static std::random_device rd;
+    m_schedule = PeerSchedule(m_peers, rd());
 }
 
-int RumorMember::chooseRandomMember()
+int RumorMember::choosePeer()
 {
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
-    std::uniform_int_distribution<int> dis(0, static_cast<int>(m_peers.size() - 1));
-    return m_peers[dis(gen)];
+    if (m_nextMemberCb) {
+        return m_nextMemberCb();
+    }
+    return m_trackLiveness ? m_liveness.choosePeer(m_schedule) : m_schedule.next();
+}
+
+void RumorMember::attachSizeSamples(std::vector<Message>& messages)
+{
+    if (!m_estimateSize) {
+        return;
+    }
+    for (Message& message : messages) {
+        message.setSizeSample(m_sizeEstimator.nextSample());
+    }
+}
+
+void RumorMember::updateNetworkConfig()
+{
+    if (!m_estimateSize) {
+        return;
+    }
+
+    // The round limits are undefined below two members. Until the first epoch is complete the
+    // sketch is still filling up, so the members known locally are a better lower bound.
+    size_t networkSize = std::max<size_t>(2, std::lround(m_sizeEstimator.estimate()));
+    if (m_sizeEstimator.epoch() == 0) {
+        networkSize = std::max(networkSize, m_peers.size() + 1);
+    }
+    if (networkSize == m_networkConfig.networkSize()) {
+        return;
+    }
+
+    const NetworkConfig networkConfig(networkSize);
+    if (networkConfig.maxRoundsTotal() == m_networkConfig.maxRoundsTotal() &&
+        networkConfig.maxRoundsInC() == m_networkConfig.maxRoundsInC()) {
+        m_networkConfig = networkConfig;
+        return;
+    }
+
+    // The skipped rounds of the KNOWN cohorts counted against the previous limits
+    std::vector<int> knownCohorts;
+    for (auto& kv : m_cohorts) {
+        if (kv.second.dueRound() >= 0) {
+            kv.second.catchUp(m_round);
+            knownCohorts.push_back(kv.first);
+        }
+    }
+    m_networkConfig = networkConfig;
+    for (const int cohortId : knownCohorts) {
+        scheduleOld(cohortId);
+    }
+}
+
+void RumorMember::adoptNetworkConfig()
+{
+    for (auto& kv : m_cohorts) {
+        kv.second.stateMachine().setNetworkConfig(&m_networkConfig);
+    }
+}
+
+size_t RumorMember::reserveRumors(size_t count, int keepFirst, int keepEnd)
+{
+    if (m_maxRumors == 0) {
+        return count;
+    }
+    if (m_rumors.size() + count > m_maxRumors) {
+        evictRumors(m_rumors.size() + count - m_maxRumors, m_maxRumors / 16, keepFirst, keepEnd);
+    }
+    return std::min(count, m_maxRumors - std::min(m_maxRumors, m_rumors.size()));
+}
+
+void RumorMember::evictRumors(size_t count, size_t slack, int keepFirst, int keepEnd)
+{
+    // OLD cohorts first, oldest first, then KNOWN cohorts by the round they become OLD
+    std::vector<std::tuple<int, int, int>> candidates; // (rank, round, cohort ID)
+    for (const auto& kv : m_cohorts) {
+        const RumorStateMachine::State state = kv.second.stateMachine().state();
+        if (state == RumorStateMachine::State::OLD) {
+            candidates.emplace_back(0, kv.second.createdInRound(), kv.first);
+        }
+        else if (state == RumorStateMachine::State::KNOWN) {
+            candidates.emplace_back(1, kv.second.dueRound(), kv.first);
+        }
+    }
+    if (candidates.empty()) {
+        return;
+    }
+    std::sort(candidates.begin(), candidates.end());
+    std::unordered_map<int, size_t> position; // Cohort ID --> index in 'candidates'
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        position[std::get<2>(candidates[i])] = i;
+    }
+
+    // The ranges of the candidates, without the kept rumors, in eviction order
+    std::vector<std::tuple<size_t, int, int>> ranges; // (index, first, end)
+    for (const auto& kv : m_rumors.intervals()) {
+        const auto& found = position.find(kv.second.m_value);
+        if (found == position.end()) {
+            continue;
+        }
+        const int first = kv.first;
+        const int end = kv.second.m_end;
+        if (first < keepFirst) {
+            ranges.emplace_back(found->second, first, std::min(end, keepFirst));
+        }
+        if (end > keepEnd) {
+            ranges.emplace_back(found->second, std::max(first, keepEnd), end);
+        }
+    }
+    std::stable_sort(ranges.begin(), ranges.end(), [](const std::tuple<size_t, int, int>& lhs,
+                                                      const std::tuple<size_t, int, int>& rhs) {
+        return std::get<0>(lhs) < std::get<0>(rhs);
+    });
+
+    size_t numEvicted = 0;
+    std::vector<int> touched;
+    for (const auto& range : ranges) {
+        const std::tuple<int, int, int>& candidate = candidates[std::get<0>(range)];
+        const bool isOld = std::get<0>(candidate) == 0;
+        const size_t limit = isOld ? count + slack : count;
+        if (numEvicted >= limit) {
+            if (isOld) {
+                continue;
+            }
+            break;
+        }
+
+        const int cohortId = std::get<2>(candidate);
+        const int first = std::get<1>(range);
+        const size_t length = std::min(limit - numEvicted, static_cast<size_t>(std::get<2>(range) - first));
+        const int end = first + static_cast<int>(length);
+        RumorCohort& cohort = m_cohorts[cohortId];
+        m_rumors.erase(first, end);
+        cohort.remove(length);
+        recordStateChange(first, end, cohort.stateMachine().state(), RumorStateMachine::State::UNKNOWN);
+        numEvicted += length;
+        touched.push_back(cohortId);
+    }
+
+    // Empty cohorts go away. A scheduled cohort is skipped by the timer wheel once it is gone.
+    for (const int cohortId : touched) {
+        const auto& iter = m_cohorts.find(cohortId);
+        if (iter == m_cohorts.end() || !iter->second.empty()) {
+            continue;
+        }
+        m_cohorts.erase(iter);
+        for (auto roundIter = m_roundCohorts.begin(); roundIter != m_roundCohorts.end();) {
+            roundIter = roundIter->second == cohortId ? m_roundCohorts.erase(roundIter) : std::next(roundIter);
+        }
+    }
+
+    if (numEvicted > 0) {
+        m_viewDirty = true;
+        increaseStatValue(StatisticKey::NumEvictedRumors, numEvicted);
+    }
+}
+
+void RumorMember::resetRoundState()
+{
+    // Destroy the containers before their memory is reused
+    RumorStateMachine::PeerSet(m_peersInCurrentRound.get_allocator()).swap(m_peersInCurrentRound);
+    RoundCohorts(m_roundCohorts.get_allocator()).swap(m_roundCohorts);
+    m_memory->m_round.release();
 }
 
 void RumorMember::increaseStatValue(StatisticKey key, double value)
@@ -47,14 +235,276 @@ void RumorMember::increaseStatValue(StatisticKey key, double value)
     }
 }
 
+int RumorMember::roundCohort(const CohortKey& key, const RumorStateMachine& stateMachine)
+{
+    const auto& iter = m_roundCohorts.find(key);
+    if (iter != m_roundCohorts.end()) {
+        return iter->second;
+    }
+
+    const int cohortId = m_nextCohortId++;
+    m_cohorts.insert(std::make_pair(cohortId, RumorCohort(stateMachine, m_round)));
+    m_roundCohorts[key] = cohortId;
+    if (stateMachine.state() == RumorStateMachine::State::NEW) {
+        m_newCohorts.insert(cohortId);
+    }
+    return cohortId;
+}
+
+void RumorMember::scheduleOld(int cohortId)
+{
+    RumorCohort& cohort = m_cohorts[cohortId];
+    const int numRounds = cohort.stateMachine().roundsUntilOld();
+    if (numRounds < 0) {
+        return;
+    }
+
+    // The state machine becomes OLD in the 'numRounds'-th round it has not reflected yet
+    const int dueRound = cohort.syncedRound() + numRounds - 1;
+    cohort.setDueRound(dueRound);
+    m_knownCohorts.schedule(dueRound, cohortId);
+}
+
+void RumorMember::joinCohort(int first, int end, int cohortId)
+{
+    m_cohorts[cohortId].add(static_cast<size_t>(end - first));
+    m_rumors.assign(first, end, cohortId);
+}
+
+void RumorMember::moveToCohort(int first, int end, int cohortId)
+{
+    int sourceId = -1;
+    m_rumors.find(first, sourceId);
+    m_cohorts[sourceId].remove(static_cast<size_t>(end - first));
+    joinCohort(first, end, cohortId);
+}
+
+void RumorMember::insertRumors(int first, int end, std::vector<bool>& added)
+{
+    // Add the gaps between the rumors that are already known, as many as fit
+    std::vector<std::pair<int, int>> known;
+    size_t numUnknown = static_cast<size_t>(end - first);
+    m_rumors.forEach(first, end, [&](int knownFirst, int knownEnd, int) {
+        known.emplace_back(knownFirst, knownEnd);
+        numUnknown -= static_cast<size_t>(knownEnd - knownFirst);
+    });
+    size_t numFree = reserveRumors(numUnknown, first, end);
+    if (numFree < numUnknown) {
+        increaseStatValue(StatisticKey::NumRejectedRumors, numUnknown - numFree);
+    }
+
+    // All the rumors added locally in a round start from the same fresh state machine
+    const CohortKey key(-1, m_id, -1);
+    auto addRange = [&](int from, int to) {
+        to = from + static_cast<int>(std::min(numFree, static_cast<size_t>(std::max(0, to - from))));
+        if (from >= to) {
+            return;
+        }
+        numFree -= static_cast<size_t>(to - from);
+        joinCohort(from, to, roundCohort(key, RumorStateMachine(&m_networkConfig)));
+        m_viewAdded.push_back({from, to, false});
+        recordStateChange(from, to, RumorStateMachine::State::UNKNOWN, RumorStateMachine::State::NEW);
+        std::fill(added.begin() + (from - first), added.begin() + (to - first), true);
+    };
+
+    int next = first;
+    for (const auto& range : known) {
+        addRange(next, range.first);
+        next = range.second;
+    }
+    addRange(next, end);
+}
+
+void RumorMember::rumorsReceived(int first, int end, int fromMember, int theirRound)
+{
+    // Split the range into the known parts, one per cohort, and the unknown parts in between.
+    // Collect them first since handling them updates 'm_rumors'. Unknown rumors that do not fit
+    // are dropped.
+    std::vector<std::tuple<int, int, int>> known;
+    size_t numUnknown = static_cast<size_t>(end - first);
+    m_rumors.forEach(first, end, [&](int knownFirst, int knownEnd, int cohortId) {
+        known.emplace_back(knownFirst, knownEnd, cohortId);
+        numUnknown -= static_cast<size_t>(knownEnd - knownFirst);
+    });
+    size_t numFree = reserveRumors(numUnknown, first, end);
+    if (numFree < numUnknown) {
+        increaseStatValue(StatisticKey::NumDroppedRumors, numUnknown - numFree);
+    }
+
+    const CohortKey key(-1, fromMember, theirRound);
+    auto learnRange = [&](int from, int to) {
+        to = from + static_cast<int>(std::min(numFree, static_cast<size_t>(std::max(0, to - from))));
+        if (from >= to) {
+            return;
+        }
+        numFree -= static_cast<size_t>(to - from);
+        const int cohortId = roundCohort(key, RumorStateMachine(&m_networkConfig, fromMember, theirRound));
+        joinCohort(from, to, cohortId);
+        // Rumors received past the maximum age are learned as OLD
+        m_viewAdded.push_back({from, to, m_cohorts[cohortId].stateMachine().isOld()});
+        recordStateChange(from, to,
+                          RumorStateMachine::State::UNKNOWN,
+                          m_cohorts[cohortId].stateMachine().state());
+    };
+
+    int next = first;
+    for (const auto& range : known) {
+        learnRange(next, std::get<0>(range));
+        cohortReceived(std::get<0>(range), std::get<1>(range), std::get<2>(range), fromMember, theirRound);
+        next = std::get<1>(range);
+    }
+    learnRange(next, end);
+}
+
+void RumorMember::cohortReceived(int first, int end, int cohortId, int fromMember, int theirRound)
+{
+    RumorCohort& cohort = m_cohorts[cohortId];
+    RumorStateMachine& stateMach = cohort.stateMachine();
+
+    // Only NEW rumors track other members, there is nothing to diverge on otherwise
+    if (stateMach.state() != RumorStateMachine::State::NEW) {
+        return;
+    }
+
+    // The rumors of a cohort were heard from the same members, a duplicate changes nothing
+    if (stateMach.heardFrom(fromMember)) {
+        increaseStatValue(StatisticKey::NumDuplicateRumors, end - first);
+        return;
+    }
+
+    // A whole cohort that no other rumor can join in this round is updated in place. The cohorts
+    // split off it earlier in the round did not see this report, so its rumors no longer join them.
+    if (cohort.size() == static_cast<size_t>(end - first) && cohort.createdInRound() != m_round) {
+        stateMach.rumorReceived(fromMember, theirRound);
+        m_roundCohorts.erase(m_roundCohorts.lower_bound(CohortKey(cohortId, INT_MIN, INT_MIN)),
+                             m_roundCohorts.upper_bound(CohortKey(cohortId, INT_MAX, INT_MAX)));
+        return;
+    }
+
+    // Otherwise split off to the cohort of the rumors that received the same message
+    const CohortKey key(cohortId, fromMember, theirRound);
+    if (m_roundCohorts.count(key) <= 0) {
+        RumorStateMachine diverged(stateMach);
+        diverged.rumorReceived(fromMember, theirRound);
+        roundCohort(key, diverged);
+    }
+    moveToCohort(first, end, m_roundCohorts[key]);
+}
+
+void RumorMember::appendMessages(Message::Type type, std::vector<Message>& messages) const
+{
+    for (const auto& kv : m_rumors.intervals()) {
+        const int first = kv.first;
+        const int end = kv.second.m_end;
+        const int age = m_cohorts.at(kv.second.m_value).age(m_round);
+        if (age < 0) {
+            continue;
+        }
+
+        if (!m_rangeMessages && end - first <= k_maxExpandedRumors) {
+            for (int rumorId = first; rumorId < end; ++rumorId) {
+                messages.emplace_back(Message(type, rumorId, age));
+            }
+            continue;
+        }
+
+        // Extend the previous message if it ends where this interval starts with the same age
+        if (!messages.empty()) {
+            const Message& last = messages.back();
+            if (last.type() == type && last.age() == age && last.rumorId() + last.count() == first) {
+                messages.back() = Message(type, last.rumorId(), age, last.count() + end - first);
+                continue;
+            }
+        }
+        messages.emplace_back(Message(type, first, age, end - first));
+    }
+}
+
+void RumorMember::recordStateChange(int first,
+                                    int end,
+                                    RumorStateMachine::State from,
+                                    RumorStateMachine::State to)
+{
+    if (!m_stateChangeCbs.empty()) {
+        for (int rumorId = first; rumorId < end; ++rumorId) {
+            m_stateChanges.push_back({rumorId, from, to});
+        }
+    }
+}
+
+void RumorMember::publishView()
+{
+    if (!m_viewDirty && m_viewAdded.empty()) {
+        return;
+    }
+
+    const unsigned long version = m_viewVersion.load(std::memory_order_relaxed) + 1;
+    std::shared_ptr<const RumorView> view;
+    if (!m_viewDirty) {
+        view = std::make_shared<RumorView>(*m_view, std::move(m_viewAdded), version);
+    }
+    else {
+        std::vector<RumorView::Range> ranges;
+        for (const auto& kv : m_rumors.intervals()) {
+            const bool isOld = m_cohorts.at(kv.second.m_value).stateMachine().isOld();
+            if (!ranges.empty() && ranges.back().m_end == kv.first && ranges.back().m_isOld == isOld) {
+                ranges.back().m_end = kv.second.m_end;
+            }
+            else {
+                ranges.push_back({kv.first, kv.second.m_end, isOld});
+            }
+        }
+        view = std::make_shared<RumorView>(std::move(ranges), version);
+    }
+    m_viewDirty = false;
+    m_viewAdded.clear();
+
+    // Readers compare versions before loading the view, so store the view first
+    std::atomic_store(&m_view, view);
+    m_viewVersion.store(version, std::memory_order_release);
+}
+
+void RumorMember::notifyStateChanges(const std::vector<StateChange>& changes) const
+{
+    for (const StateChange& change : changes) {
+        for (const StateChangeCb& cb : m_stateChangeCbs) {
+            cb(m_id, change.m_rumorId, change.m_from, change.m_to);
+        }
+    }
+}
+
 // CONSTRUCTORS
 RumorMember::RumorMember(const std::unordered_set<int>& peers, int id)
 : m_id(id)
 , m_networkConfig(peers.size())
+, m_memory(new Memory(defaultMemoryResource()))
 , m_peers()
-, m_rumors()
+, m_schedule()
+, m_peersInCurrentRound(RumorStateMachine::PeerSet::allocator_type(&m_memory->m_round))
+, m_rumors(&m_memory->m_rumors)
+, m_cohorts(Cohorts::allocator_type(&m_memory->m_cohorts))
+, m_roundCohorts(RoundCohorts::allocator_type(&m_memory->m_round))
+, m_newCohorts(CohortSet::allocator_type(&m_memory->m_cohorts))
+, m_knownCohorts()
+, m_nextCohortId(0)
+, m_round(0)
+, m_rangeMessages(false)
+, m_maxRumors(0)
+, m_trackLiveness(false)
+, m_liveness()
+, m_estimateSize(false)
+, m_sizeEstimator()
 , m_mutex()
+, m_phaseTimers()
 , m_nextMemberCb()
+, m_stateChangeCbs()
+, m_stateChanges()
+, m_statistics()
+, m_viewDirty(false)
+, m_viewAdded()
+, m_view(std::make_shared<RumorView>())
+, m_viewVersion(0)
+, m_recorder(nullptr)
 {
     toVector(peers);
 }
@@ -62,10 +512,34 @@ RumorMember::RumorMember(const std::unordered_set<int>& peers, int id)
 RumorMember::RumorMember(const std::unordered_set<int>& peers, const NextMemberCb& cb, int id)
 : m_id(id)
   , m_networkConfig(peers.size())
+  , m_memory(new Memory(defaultMemoryResource()))
   , m_peers()
-  , m_rumors()
+  , m_schedule()
+  , m_peersInCurrentRound(RumorStateMachine::PeerSet::allocator_type(&m_memory->m_round))
+  , m_rumors(&m_memory->m_rumors)
+  , m_cohorts(Cohorts::allocator_type(&m_memory->m_cohorts))
+  , m_roundCohorts(RoundCohorts::allocator_type(&m_memory->m_round))
+  , m_newCohorts(CohortSet::allocator_type(&m_memory->m_cohorts))
+  , m_knownCohorts()
+  , m_nextCohortId(0)
+  , m_round(0)
+  , m_rangeMessages(false)
+  , m_maxRumors(0)
+  , m_trackLiveness(false)
+  , m_liveness()
+  , m_estimateSize(false)
+  , m_sizeEstimator()
   , m_mutex()
+  , m_phaseTimers()
   , m_nextMemberCb(cb)
+  , m_stateChangeCbs()
+  , m_stateChanges()
+  , m_statistics()
+  , m_viewDirty(false)
+  , m_viewAdded()
+  , m_view(std::make_shared<RumorView>())
+  , m_viewVersion(0)
+, m_recorder(nullptr)
 {
     toVector(peers);
 }
@@ -73,32 +547,80 @@ RumorMember::RumorMember(const std::unordered_set<int>& peers, const NextMemberC
 
 RumorMember::RumorMember(const std::unordered_set<int>& peers,
                          const NetworkConfig& networkConfig,
-                         int id)
+                         int id,
+                         MemoryResource* resource)
 : m_id(id)
 , m_networkConfig(networkConfig)
+, m_memory(new Memory(resource))
 , m_peers()
-, m_rumors()
+, m_schedule()
+, m_peersInCurrentRound(RumorStateMachine::PeerSet::allocator_type(&m_memory->m_round))
+, m_rumors(&m_memory->m_rumors)
+, m_cohorts(Cohorts::allocator_type(&m_memory->m_cohorts))
+, m_roundCohorts(RoundCohorts::allocator_type(&m_memory->m_round))
+, m_newCohorts(CohortSet::allocator_type(&m_memory->m_cohorts))
+, m_knownCohorts()
+, m_nextCohortId(0)
+, m_round(0)
+, m_rangeMessages(false)
+, m_maxRumors(0)
+, m_trackLiveness(false)
+, m_liveness()
+, m_estimateSize(false)
+, m_sizeEstimator()
 , m_mutex()
+, m_phaseTimers()
 , m_nextMemberCb()
+, m_stateChangeCbs()
+, m_stateChanges()
 , m_statistics()
+, m_viewDirty(false)
+, m_viewAdded()
+, m_view(std::make_shared<RumorView>())
+, m_viewVersion(0)
+, m_recorder(nullptr)
 {
-    assert(networkConfig.networkSize() == peers.size());
+    assert(networkConfig.networkSize() >= peers.size());
     toVector(peers);
 }
 
 RumorMember::RumorMember(const std::unordered_set<int>& peers,
                          const NetworkConfig& networkConfig,
                          const NextMemberCb& cb,
-                         int id)
+                         int id,
+                         MemoryResource* resource)
 : m_id(id)
 , m_networkConfig(networkConfig)
+, m_memory(new Memory(resource))
 , m_peers()
-, m_rumors()
+, m_schedule()
+, m_peersInCurrentRound(RumorStateMachine::PeerSet::allocator_type(&m_memory->m_round))
+, m_rumors(&m_memory->m_rumors)
+, m_cohorts(Cohorts::allocator_type(&m_memory->m_cohorts))
+, m_roundCohorts(RoundCohorts::allocator_type(&m_memory->m_round))
+, m_newCohorts(CohortSet::allocator_type(&m_memory->m_cohorts))
+, m_knownCohorts()
+, m_nextCohortId(0)
+, m_round(0)
+, m_rangeMessages(false)
+, m_maxRumors(0)
+, m_trackLiveness(false)
+, m_liveness()
+, m_estimateSize(false)
+, m_sizeEstimator()
 , m_mutex()
+, m_phaseTimers()
 , m_nextMemberCb(cb)
+, m_stateChangeCbs()
+, m_stateChanges()
 , m_statistics()
+, m_viewDirty(false)
+, m_viewAdded()
+, m_view(std::make_shared<RumorView>())
+, m_viewVersion(0)
+, m_recorder(nullptr)
 {
-    assert(networkConfig.networkSize() == peers.size());
+    assert(networkConfig.networkSize() >= peers.size());
     toVector(peers);
 }
 
@@ -106,51 +628,143 @@ RumorMember::RumorMember(const std::unordered_set<int>& peers,
 RumorMember::RumorMember(const RumorMember& other)
 : m_id(other.m_id)
 , m_networkConfig(other.m_networkConfig)
+, m_memory(new Memory(other.m_memory ? other.m_memory->m_rumors.upstream() : defaultMemoryResource()))
 , m_peers(other.m_peers)
-, m_rumors(other.m_rumors)
+, m_schedule(other.m_schedule)
+, m_peersInCurrentRound(other.m_peersInCurrentRound, &m_memory->m_round)
+, m_rumors(other.m_rumors, &m_memory->m_rumors)
+, m_cohorts(other.m_cohorts, &m_memory->m_cohorts)
+, m_roundCohorts(other.m_roundCohorts, &m_memory->m_round)
+, m_newCohorts(other.m_newCohorts, &m_memory->m_cohorts)
+, m_knownCohorts(other.m_knownCohorts)
+, m_nextCohortId(other.m_nextCohortId)
+, m_round(other.m_round)
+, m_rangeMessages(other.m_rangeMessages)
+, m_maxRumors(other.m_maxRumors)
+, m_trackLiveness(other.m_trackLiveness)
+, m_liveness(other.m_liveness)
+, m_estimateSize(other.m_estimateSize)
+, m_sizeEstimator(other.m_sizeEstimator)
 , m_mutex()
+, m_phaseTimers(other.m_phaseTimers)
 , m_nextMemberCb(other.m_nextMemberCb)
+, m_stateChangeCbs(other.m_stateChangeCbs)
+, m_stateChanges()
 , m_statistics(other.m_statistics)
+, m_viewDirty(false)
+, m_viewAdded()
+, m_view(std::atomic_load(&other.m_view))
+, m_viewVersion(other.m_viewVersion.load())
+, m_recorder(nullptr)
 {
+    adoptNetworkConfig();
 }
 
 // MOVE CONSTRUCTOR
 RumorMember::RumorMember(RumorMember&& other) noexcept
 : m_id(other.m_id)
 , m_networkConfig(other.m_networkConfig)
+, m_memory(std::move(other.m_memory))
 , m_peers(std::move(other.m_peers))
+, m_schedule(std::move(other.m_schedule))
+, m_peersInCurrentRound(std::move(other.m_peersInCurrentRound))
 , m_rumors(std::move(other.m_rumors))
+, m_cohorts(std::move(other.m_cohorts))
+, m_roundCohorts(std::move(other.m_roundCohorts))
+, m_newCohorts(std::move(other.m_newCohorts))
+, m_knownCohorts(std::move(other.m_knownCohorts))
+, m_nextCohortId(other.m_nextCohortId)
+, m_round(other.m_round)
+, m_rangeMessages(other.m_rangeMessages)
+, m_maxRumors(other.m_maxRumors)
+, m_trackLiveness(other.m_trackLiveness)
+, m_liveness(std::move(other.m_liveness))
+, m_estimateSize(other.m_estimateSize)
+, m_sizeEstimator(std::move(other.m_sizeEstimator))
 , m_mutex()
+, m_phaseTimers(other.m_phaseTimers)
 , m_nextMemberCb(std::move(other.m_nextMemberCb))
+, m_stateChangeCbs(std::move(other.m_stateChangeCbs))
+, m_stateChanges()
 , m_statistics(std::move(other.m_statistics))
+, m_viewDirty(false)
+, m_viewAdded()
+, m_view(std::atomic_load(&other.m_view))
+, m_viewVersion(other.m_viewVersion.load())
+, m_recorder(other.m_recorder)
 {
+    other.m_recorder = nullptr;
+    adoptNetworkConfig();
 }
 
 // PUBLIC METHODS
 bool RumorMember::addRumor(int rumorId)
 {
-    std::lock_guard<std::mutex> guard(m_mutex); // critical section
-    return m_rumors.insert(std::make_pair(rumorId, &m_networkConfig)).second;
+    std::vector<bool> added(1, false);
+
+    std::unique_lock<std::mutex> guard(m_mutex); // critical section
+    if (m_recorder) {
+        m_recorder->rumorsAdded(rumorId, 1);
+    }
+    insertRumors(rumorId, rumorId + 1, added);
+
+    publishView();
+
+    std::vector<StateChange> changes;
+    changes.swap(m_stateChanges);
+    guard.unlock();
+
+    notifyStateChanges(changes);
+    return added[0];
+}
+
+std::vector<bool> RumorMember::addRumors(int firstRumorId, size_t count)
+{
+    std::vector<bool> added(count, false);
+
+    std::unique_lock<std::mutex> guard(m_mutex); // critical section
+    if (m_recorder) {
+        m_recorder->rumorsAdded(firstRumorId, count);
+    }
+    insertRumors(firstRumorId, firstRumorId + static_cast<int>(count), added);
+
+    publishView();
+
+    std::vector<StateChange> changes;
+    changes.swap(m_stateChanges);
+    guard.unlock();
+
+    notifyStateChanges(changes);
+    return added;
 }
 
 std::pair<int, std::vector<Message>>
 RumorMember::receivedMessage(const Message& message, int fromPeer)
 {
-    std::lock_guard<std::mutex> guard(m_mutex); // critical section
+    std::unique_lock<std::mutex> guard = m_phaseTimers.lock(m_mutex); // critical section
+    if (m_recorder) {
+        m_recorder->messageReceived(message, fromPeer);
+    }
 
-    bool isNewPeer = m_peersInCurrentRound.insert(fromPeer).second;
-    increaseStatValue(StatisticKey::NumMessagesReceived, 1);
+    bool isNewPeer;
+    {
+        PhaseTimers::Scope scope(m_phaseTimers, PhaseTimers::Phase::STATE_UPDATE);
+        isNewPeer = m_peersInCurrentRound.insert(fromPeer).second;
+        increaseStatValue(StatisticKey::NumMessagesReceived, 1);
+        if (m_trackLiveness) {
+            m_liveness.heardFrom(fromPeer);
+        }
+        if (m_estimateSize) {
+            m_sizeEstimator.sampleReceived(message.sizeSample());
+        }
+    }
 
     // If this is the first time 'fromPeer' sent a PUSH message in this round
     // then respond with a PULL message for each rumor
     std::vector<Message> pullMessages;
     if (isNewPeer && message.type() == Message::Type::PUSH) {
-        for (auto& kv : m_rumors) {
-            RumorStateMachine& stateMach = kv.second;
-            if (stateMach.age() >= 0) {
-                pullMessages.emplace_back(Message(Message::Type::PULL, kv.first, kv.second.age()));
-            }
-        }
+        PhaseTimers::Scope scope(m_phaseTimers, PhaseTimers::Phase::MESSAGE_BUILD);
+        appendMessages(Message::Type::PULL, pullMessages);
 
         // No PULL messages to sent i.e. no rumors received yet
         if (pullMessages.empty()) {
@@ -160,26 +774,33 @@ RumorMember::receivedMessage(const Message& message, int fromPeer)
         else {
             increaseStatValue(StatisticKey::NumPullMessages, pullMessages.size());
         }
+        attachSizeSamples(pullMessages);
     }
 
-    // An empty response from a peer that was sent a PULL
+    // An empty response from a peer that was sent a PULL. Ranges past the largest ID are ignored.
     const int receivedRumorId = message.rumorId();
     const int theirRound = message.age();
-    if (receivedRumorId >= 0) {
-        if (m_rumors.count(receivedRumorId) > 0) {
-            m_rumors[receivedRumorId].rumorReceived(fromPeer, message.age());
-        }
-        else {
-            m_rumors[receivedRumorId] = RumorStateMachine(&m_networkConfig, fromPeer, theirRound);
-        }
+    if (receivedRumorId >= 0 && message.count() > 0 && message.count() <= INT_MAX - receivedRumorId) {
+        PhaseTimers::Scope scope(m_phaseTimers, PhaseTimers::Phase::STATE_UPDATE);
+        rumorsReceived(receivedRumorId, receivedRumorId + message.count(), fromPeer, theirRound);
     }
 
+    publishView();
+
+    std::vector<StateChange> changes;
+    changes.swap(m_stateChanges);
+    guard.unlock();
+
+    if (!changes.empty()) {
+        PhaseTimers::Scope scope(m_phaseTimers, PhaseTimers::Phase::CALLBACKS);
+        notifyStateChanges(changes);
+    }
     return std::make_pair(fromPeer, pullMessages);
 }
 
 std::pair<int, std::vector<Message>> RumorMember::advanceRound()
 {
-    std::lock_guard<std::mutex> guard(m_mutex); // critical section
+    std::unique_lock<std::mutex> guard = m_phaseTimers.lock(m_mutex); // critical section
 
     if(m_rumors.empty()) {
         return {-1, std::vector<Message>()};
@@ -187,43 +808,360 @@ std::pair<int, std::vector<Message>> RumorMember::advanceRound()
 
     increaseStatValue(StatisticKey::Rounds, 1);
 
-    int toMember = m_nextMemberCb ? m_nextMemberCb() : chooseRandomMember();
+    int toMember;
+    {
+        PhaseTimers::Scope scope(m_phaseTimers, PhaseTimers::Phase::STATE_UPDATE);
+        if (m_trackLiveness) {
+            m_liveness.newRound();
+        }
+        if (m_estimateSize) {
+            m_sizeEstimator.newRound();
+            updateNetworkConfig();
+        }
+        toMember = choosePeer();
+        if (m_recorder) {
+            m_recorder->roundAdvanced(toMember);
+        }
+        if (m_trackLiveness) {
+            m_liveness.pushed(toMember);
+        }
 
-    // Construct the push messages
-    std::vector<Message> pushMessages;
-    for (auto& kv : m_rumors) {
-        RumorStateMachine& stateMach = kv.second;
-        stateMach.advanceRound(m_peersInCurrentRound);
-        pushMessages.emplace_back(Message(Message::Type::PUSH, kv.first, kv.second.age()));
-    }
-    increaseStatValue(StatisticKey::NumPushMessages, pushMessages.size());
+        // Advance each NEW cohort once
+        std::unordered_map<int, RumorStateMachine::State> statesBefore; // Changed cohort ID --> state
+        for (auto iter = m_newCohorts.begin(); iter != m_newCohorts.end();) {
+            const int cohortId = *iter;
+            RumorCohort& cohort = m_cohorts[cohortId];
+            if (cohort.empty()) {
+                m_cohorts.erase(cohortId);
+                iter = m_newCohorts.erase(iter);
+                continue;
+            }
+
+            cohort.advanceRound(m_peersInCurrentRound, m_round);
+            if (cohort.stateMachine().state() != RumorStateMachine::State::NEW) {
+                statesBefore[cohortId] = RumorStateMachine::State::NEW;
+                m_viewDirty = true;
+                scheduleOld(cohortId);
+                iter = m_newCohorts.erase(iter);
+                continue;
+            }
+            ++iter;
+        }
+
+        // KNOWN cohorts are only visited in the round they become OLD
+        std::vector<int> dueCohorts;
+        m_knownCohorts.expire(m_round, dueCohorts);
+        for (const int cohortId : dueCohorts) {
+            const auto& iter = m_cohorts.find(cohortId);
+            if (iter == m_cohorts.end() || iter->second.dueRound() != m_round) {
+                continue; // Rescheduled
+            }
+
+            RumorCohort& cohort = iter->second;
+            cohort.catchUp(m_round);
+            cohort.advanceRound(m_peersInCurrentRound, m_round);
+            cohort.setDueRound(-1);
+            statesBefore[cohortId] = RumorStateMachine::State::KNOWN;
+            m_viewDirty = true;
+        }
 
-    // No PUSH messages but still want to sent a response to peer.
-    if (pushMessages.empty()) {
-        pushMessages.emplace_back(Message(Message::Type::PUSH, -1, 0));
-        increaseStatValue(StatisticKey::NumEmptyPushMessages, 1);
+        // Report the rumors of the cohorts that changed state
+        if (!statesBefore.empty() && !m_stateChangeCbs.empty()) {
+            for (const auto& kv : m_rumors.intervals()) {
+                const auto& changed = statesBefore.find(kv.second.m_value);
+                if (changed != statesBefore.end()) {
+                    recordStateChange(kv.first,
+                                      kv.second.m_end,
+                                      changed->second,
+                                      m_cohorts[kv.second.m_value].stateMachine().state());
+                }
+            }
+        }
     }
 
     // Clear round state
-    m_peersInCurrentRound.clear();
+    resetRoundState();
+    ++m_round;
+
+    std::vector<Message> pushMessages;
+    {
+        PhaseTimers::Scope scope(m_phaseTimers, PhaseTimers::Phase::MESSAGE_BUILD);
+        appendMessages(Message::Type::PUSH, pushMessages);
+        increaseStatValue(StatisticKey::NumPushMessages, pushMessages.size());
+
+        // No PUSH messages but still want to sent a response to peer.
+        if (pushMessages.empty()) {
+            pushMessages.emplace_back(Message(Message::Type::PUSH, -1, 0));
+            increaseStatValue(StatisticKey::NumEmptyPushMessages, 1);
+        }
+        attachSizeSamples(pushMessages);
+    }
+
+    publishView();
+
+    std::vector<StateChange> changes;
+    changes.swap(m_stateChanges);
+    guard.unlock();
 
+    if (!changes.empty()) {
+        PhaseTimers::Scope scope(m_phaseTimers, PhaseTimers::Phase::CALLBACKS);
+        notifyStateChanges(changes);
+    }
     return std::make_pair(toMember, pushMessages);
 }
 
+void RumorMember::addStateChangeCb(const StateChangeCb& cb)
+{
+    std::lock_guard<std::mutex> guard(m_mutex); // critical section
+    m_stateChangeCbs.push_back(cb);
+}
+
+void RumorMember::setRangeMessages(bool enabled)
+{
+    std::lock_guard<std::mutex> guard(m_mutex); // critical section
+    if (m_recorder) {
+        m_recorder->rangeMessagesSet(enabled);
+    }
+    m_rangeMessages = enabled;
+}
+
+void RumorMember::setMaxRumors(size_t maxRumors)
+{
+    std::lock_guard<std::mutex> guard(m_mutex); // critical section
+    if (m_recorder) {
+        m_recorder->maxRumorsSet(maxRumors);
+    }
+    m_maxRumors = maxRumors;
+}
+
+void RumorMember::trackLiveness(int suspectAfterMisses, int probeInterval)
+{
+    std::lock_guard<std::mutex> guard(m_mutex); // critical section
+    if (m_recorder) {
+        m_recorder->livenessTracked(suspectAfterMisses, probeInterval);
+    }
+    m_trackLiveness = true;
+    m_liveness = PeerLiveness(m_peers, suspectAfterMisses, probeInterval);
+}
+
+void RumorMember::setLocality(const std::unordered_map<int, int>& zones, double remoteProbability)
+{
+    std::lock_guard<std::mutex> guard(m_mutex); // critical section
+    const auto& ownZone = zones.find(m_id);
+    std::vector<int> localPeers;
+    std::vector<int> remotePeers;
+    for (const int peerId : m_peers) {
+        const auto& zone = zones.find(peerId);
+        if (ownZone != zones.end() && zone != zones.end() && zone->second == ownZone->second) {
+            localPeers.push_back(peerId);
+        }
+        else {
+            remotePeers.push_back(peerId);
+        }
+    }
+
+    static std::random_device rd;
+    m_schedule = PeerSchedule(localPeers, remotePeers, remoteProbability, rd());
+}
+
+size_t RumorMember::importRumors(const std::vector<StateTransfer::Range>& ranges)
+{
+    std::unique_lock<std::mutex> guard(m_mutex); // critical section
+    if (m_recorder) {
+        m_recorder->rumorsImported(ranges);
+    }
+
+    // The rumors resuming the same state share a cohort
+    std::map<std::tuple<RumorStateMachine::State, int, int>, int> cohortIds; // --> cohort ID
+    auto importedCohort = [&](const StateTransfer::Range& range) {
+        const auto key = std::make_tuple(range.m_state, range.m_age, range.m_roundsInState);
+        const auto& iter = cohortIds.find(key);
+        // Evictions may have removed a cohort created earlier in this call
+        if (iter != cohortIds.end() && m_cohorts.count(iter->second) > 0) {
+            return iter->second;
+        }
+
+        const bool isNew = range.m_state == RumorStateMachine::State::NEW;
+        const RumorStateMachine stateMachine(&m_networkConfig, range.m_state, range.m_age,
+                                             isNew ? range.m_roundsInState : 0,
+                                             isNew ? 0 : range.m_roundsInState);
+        const int cohortId = m_nextCohortId++;
+        m_cohorts.insert(std::make_pair(cohortId, RumorCohort(stateMachine, m_round)));
+        if (isNew) {
+            m_newCohorts.insert(cohortId);
+        }
+        else {
+            scheduleOld(cohortId);
+        }
+        cohortIds[key] = cohortId;
+        return cohortId;
+    };
+
+    size_t numImported = 0;
+    for (const StateTransfer::Range& range : ranges) {
+        if (range.m_count <= 0 || range.m_count > INT_MAX - std::max(0, range.m_first) ||
+            (range.m_state != RumorStateMachine::State::NEW && range.m_state != RumorStateMachine::State::KNOWN)) {
+            continue;
+        }
+
+        // Only the gaps between the rumors that are already known, as many as fit
+        const int first = range.m_first;
+        const int end = first + range.m_count;
+        std::vector<std::pair<int, int>> known;
+        size_t numUnknown = static_cast<size_t>(range.m_count);
+        m_rumors.forEach(first, end, [&](int knownFirst, int knownEnd, int) {
+            known.emplace_back(knownFirst, knownEnd);
+            numUnknown -= static_cast<size_t>(knownEnd - knownFirst);
+        });
+        size_t numFree = reserveRumors(numUnknown, first, end);
+        if (numFree < numUnknown) {
+            increaseStatValue(StatisticKey::NumDroppedRumors, numUnknown - numFree);
+        }
+
+        auto importRange = [&](int from, int to) {
+            to = from + static_cast<int>(std::min(numFree, static_cast<size_t>(std::max(0, to - from))));
+            if (from >= to) {
+                return;
+            }
+            numFree -= static_cast<size_t>(to - from);
+            numImported += static_cast<size_t>(to - from);
+            joinCohort(from, to, importedCohort(range));
+            m_viewAdded.push_back({from, to, false});
+            recordStateChange(from, to, RumorStateMachine::State::UNKNOWN, range.m_state);
+        };
+
+        int next = first;
+        for (const auto& knownRange : known) {
+            importRange(next, knownRange.first);
+            next = knownRange.second;
+        }
+        importRange(next, end);
+    }
+
+    if (numImported > 0) {
+        increaseStatValue(StatisticKey::NumImportedRumors, numImported);
+    }
+    publishView();
+
+    std::vector<StateChange> changes;
+    changes.swap(m_stateChanges);
+    guard.unlock();
+
+    notifyStateChanges(changes);
+    return numImported;
+}
+
+void RumorMember::estimateNetworkSize(int epochRounds)
+{
+    std::lock_guard<std::mutex> guard(m_mutex); // critical section
+    if (m_recorder) {
+        m_recorder->sizeEstimated(epochRounds);
+    }
+    m_estimateSize = true;
+    m_sizeEstimator = SizeEstimator(m_id, epochRounds);
+}
+
+void RumorMember::record(TraceRecorder* recorder)
+{
+    std::lock_guard<std::mutex> guard(m_mutex); // critical section
+    m_recorder = recorder;
+    if (m_recorder) {
+        m_recorder->start(m_id, m_peers, m_networkConfig);
+    }
+}
+
 // PUBLIC CONST METHODS
 int RumorMember::id() const
 {
     return m_id;
 }
 
-const NetworkConfig& RumorMember::networkConfig() const
+NetworkConfig RumorMember::networkConfig() const
 {
+    std::lock_guard<std::mutex> guard(m_mutex); // critical section
     return m_networkConfig;
 }
 
-const std::unordered_map<int, RumorStateMachine>& RumorMember::rumorsMap() const
+double RumorMember::estimatedNetworkSize() const
+{
+    std::lock_guard<std::mutex> guard(m_mutex); // critical section
+    return m_estimateSize ? m_sizeEstimator.estimate() : 0;
+}
+
+std::unordered_map<int, RumorStateMachine> RumorMember::rumorsMap() const
+{
+    std::lock_guard<std::mutex> guard(m_mutex); // critical section
+
+    std::unordered_map<int, RumorStateMachine> rumors;
+    rumors.reserve(m_rumors.size());
+    for (const auto& kv : m_rumors.intervals()) {
+        const RumorStateMachine stateMach = m_cohorts.at(kv.second.m_value).stateMachineAt(m_round);
+        for (int rumorId = kv.first; rumorId < kv.second.m_end; ++rumorId) {
+            rumors[rumorId] = stateMach;
+        }
+    }
+    return rumors;
+}
+
+std::vector<StateTransfer::Range> RumorMember::activeRumors() const
+{
+    std::lock_guard<std::mutex> guard(m_mutex); // critical section
+
+    std::unordered_map<int, StateTransfer::Range> states; // Cohort ID --> state in this round
+    std::vector<StateTransfer::Range> ranges;
+    for (const auto& kv : m_rumors.intervals()) {
+        const int cohortId = kv.second.m_value;
+        auto iter = states.find(cohortId);
+        if (iter == states.end()) {
+            const RumorStateMachine stateMach = m_cohorts.at(cohortId).stateMachineAt(m_round);
+            const bool isNew = stateMach.state() == RumorStateMachine::State::NEW;
+            const StateTransfer::Range state = {0, 0, stateMach.state(), stateMach.age(),
+                                                isNew ? stateMach.roundsInB() : stateMach.roundsInC()};
+            iter = states.insert(std::make_pair(cohortId, state)).first;
+        }
+        const StateTransfer::Range& state = iter->second;
+        if (state.m_state != RumorStateMachine::State::NEW && state.m_state != RumorStateMachine::State::KNOWN) {
+            continue;
+        }
+
+        // Extend the previous range if it ends where this interval starts in the same state
+        const int first = kv.first;
+        const int count = kv.second.m_end - first;
+        if (!ranges.empty()) {
+            StateTransfer::Range& last = ranges.back();
+            if (last.m_first + last.m_count == first && last.m_state == state.m_state &&
+                last.m_age == state.m_age && last.m_roundsInState == state.m_roundsInState) {
+                last.m_count += count;
+                continue;
+            }
+        }
+        ranges.push_back({first, count, state.m_state, state.m_age, state.m_roundsInState});
+    }
+    return ranges;
+}
+
+size_t RumorMember::numCohorts() const
+{
+    std::lock_guard<std::mutex> guard(m_mutex); // critical section
+    return m_cohorts.size();
+}
+
+size_t RumorMember::numRumors(RumorStateMachine::State state) const
+{
+    std::lock_guard<std::mutex> guard(m_mutex); // critical section
+    size_t count = 0;
+    for (const auto& kv : m_cohorts) {
+        if (kv.second.stateMachine().state() == state) {
+            count += kv.second.size();
+        }
+    }
+    return count;
+}
+
+size_t RumorMember::maxRumors() const
 {
-    return m_rumors;
+    std::lock_guard<std::mutex> guard(m_mutex); // critical section
+    return m_maxRumors;
 }
 
 const std::map<RumorMember::StatisticKey, double>& RumorMember::statistics() const
@@ -231,22 +1169,51 @@ const std::map<RumorMember::StatisticKey, double>& RumorMember::statistics() con
     return m_statistics;
 }
 
-bool RumorMember::rumorExists(int rumorId) const
+RumorMember::MemoryUsage RumorMember::memoryUsage() const
 {
     std::lock_guard<std::mutex> guard(m_mutex); // critical section
-    return m_rumors.count(rumorId) > 0;
+    MemoryUsage usage = {};
+    usage.m_rumors = m_memory->m_rumors.bytesInUse();
+    usage.m_cohorts = m_memory->m_cohorts.bytesInUse() + m_knownCohorts.memoryUsage();
+    for (const auto& kv : m_cohorts) {
+        usage.m_cohorts += kv.second.stateMachine().memoryUsage();
+    }
+    usage.m_roundState = m_memory->m_round.bytesReserved();
+    usage.m_peers = (m_peers.capacity() + m_schedule.size()) * sizeof(int);
+
+    usage.m_view = std::atomic_load(&m_view)->memoryUsage();
+    return usage;
+}
+
+bool RumorMember::rumorExists(int rumorId) const
+{
+    return std::atomic_load(&m_view)->rumorExists(rumorId);
 }
 
 bool RumorMember::isOld(int rumorId) const
 {
-    std::lock_guard<std::mutex> guard(m_mutex); // critical section
+    return std::atomic_load(&m_view)->isOld(rumorId);
+}
 
-    const auto& iter = m_rumors.find(rumorId);
-    if (iter != m_rumors.end()) {
-        return iter->second.isOld();
-    }
+std::shared_ptr<const RumorView> RumorMember::view() const
+{
+    return std::atomic_load(&m_view);
+}
 
-    return false;
+unsigned long RumorMember::viewVersion() const
+{
+    return m_viewVersion.load(std::memory_order_acquire);
+}
+
+size_t RumorMember::numSuspectedPeers() const
+{
+    std::lock_guard<std::mutex> guard(m_mutex); // critical section
+    return m_liveness.numSuspected();
+}
+
+PhaseTimers::Snapshot RumorMember::phaseTimes() const
+{
+    return m_phaseTimers.snapshot();
 }
 
 std::ostream& RumorMember::printStatistics(std::ostream& outStream) const
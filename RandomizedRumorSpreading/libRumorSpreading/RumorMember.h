@@ -1,24 +1,43 @@
 #ifndef RANDOMIZEDRUMORSPREADING_RUMORMEMBER_H
 #define RANDOMIZEDRUMORSPREADING_RUMORMEMBER_H
 
+#include <atomic>
 #include <map>
+#include <memory>
+#include <tuple>
 #include <unordered_set>
 #include <mutex>
 #include <functional>
 
 #include "RumorSpreadingInterface.h"
+#include "CountingResource.h"
+#include "IntervalMap.h"
 #include "MemberID.h"
+#include "MonotonicArena.h"
 #include "NetworkConfig.h"
+#include "PeerLiveness.h"
+#include "PeerSchedule.h"
+#include "PhaseTimers.h"
+#include "RoundTimerWheel.h"
+#include "RumorCohort.h"
 #include "RumorStateMachine.h"
+#include "RumorView.h"
+#include "SizeEstimator.h"
+#include "StateTransfer.h"
 
 namespace RRS {
 
+class TraceRecorder;
+
 // This is a thread-safe implementation of the 'RumorSpreadingInterface'.
 class RumorMember : public RumorSpreadingInterface {
   public:
     // TYPES
     typedef std::function<int()> NextMemberCb;
 
+    // Invoked with (member ID, rumor ID, previous state, new state) when a rumor changes state
+    typedef std::function<void(int, int, RumorStateMachine::State, RumorStateMachine::State)> StateChangeCb;
+
     // ENUMS
     enum class StatisticKey {
         NumPeers,
@@ -28,31 +47,160 @@ class RumorMember : public RumorSpreadingInterface {
         NumEmptyPushMessages,
         NumPullMessages,
         NumEmptyPullMessages,
+        NumEvictedRumors,
+        NumRejectedRumors,
+        NumDroppedRumors,
+        NumDuplicateRumors,
+        NumImportedRumors,
     };
 
     static std::map<StatisticKey, std::string> s_enumKeyToString;
 
+    // CONSTANTS
+    // Without range messages, longer runs of consecutive rumors that share an age are still sent
+    // as one message, see 'setRangeMessages'
+    static const int k_maxExpandedRumors = 64;
+
+    // Heap bytes held by a member, by category. Containers allocated from the member's resources
+    // are counted exactly, the others are estimated from their sizes.
+    struct MemoryUsage {
+        size_t m_rumors;      // Rumor ID ranges
+        size_t m_cohorts;     // Cohorts, their state machines and timers
+        size_t m_roundState;  // Per-round arena, reserved bytes
+        size_t m_peers;       // Peer list and schedule
+        size_t m_view;        // Latest published view
+
+        size_t total() const;
+    };
+
   private:
+    // TYPES
+    // (source cohort ID, from member ID, their round)
+    typedef std::tuple<int, int, int> CohortKey;
+
+    typedef std::unordered_map<int, RumorCohort, std::hash<int>, std::equal_to<int>,
+                               ResourceAllocator<std::pair<const int, RumorCohort>>> Cohorts;
+    typedef std::unordered_set<int, std::hash<int>, std::equal_to<int>, ResourceAllocator<int>> CohortSet;
+    typedef std::map<CohortKey, int, std::less<CohortKey>,
+                     ResourceAllocator<std::pair<const CohortKey, int>>> RoundCohorts;
+
+    // Resources of the containers, on the heap so that they move with the member
+    struct Memory {
+        CountingResource m_rumors;
+        CountingResource m_cohorts;
+        MonotonicArena   m_round;      // Released at the end of every round
+
+        explicit Memory(MemoryResource* upstream);
+    };
+
+    struct StateChange {
+        int                      m_rumorId;
+        RumorStateMachine::State m_from;
+        RumorStateMachine::State m_to;
+    };
+
     // MEMBERS
     const int                                  m_id;
     NetworkConfig                              m_networkConfig;
+    std::unique_ptr<Memory>                    m_memory;
     std::vector<int>                           m_peers;
-    std::unordered_set<int>                    m_peersInCurrentRound;
-    std::unordered_map<int, RumorStateMachine> m_rumors;
+    PeerSchedule                               m_schedule;
+    RumorStateMachine::PeerSet                 m_peersInCurrentRound;
+    IntervalMap                                m_rumors;       // Rumor ID ranges --> cohort ID
+    Cohorts                                    m_cohorts;      // Cohort ID --> cohort
+    RoundCohorts                               m_roundCohorts; // Cohorts created in this round
+    CohortSet                                  m_newCohorts;   // Cohorts advanced every round
+    RoundTimerWheel                            m_knownCohorts; // Cohorts due to become OLD
+    int                                        m_nextCohortId;
+    int                                        m_round;
+    bool                                       m_rangeMessages;
+    size_t                                     m_maxRumors;    // 0 for no limit
+    bool                                       m_trackLiveness;
+    PeerLiveness                               m_liveness;
+    bool                                       m_estimateSize;
+    SizeEstimator                              m_sizeEstimator;
     mutable std::mutex                         m_mutex;
+    PhaseTimers                                m_phaseTimers;
     NextMemberCb                               m_nextMemberCb;
+    std::vector<StateChangeCb>                 m_stateChangeCbs;
+    std::vector<StateChange>                   m_stateChanges; // Not yet reported
     std::map<StatisticKey, double>             m_statistics;
+    bool                                       m_viewDirty;    // Changed since 'm_view', other
+                                                               // than by 'm_viewAdded'
+    std::vector<RumorView::Range>              m_viewAdded;    // Learned since 'm_view'
+    std::shared_ptr<const RumorView>           m_view;         // Use 'std::atomic_load'
+    std::atomic<unsigned long>                 m_viewVersion;
+    TraceRecorder*                             m_recorder;     // Not owned, may be null
 
     // METHODS
-    // Copy the member ids into a vector
+    // Copy the member ids into a vector and draw the peer schedule
     void toVector(const std::unordered_set<int>& peers);
 
-    // Return a randomly selected member id
-    int chooseRandomMember();
+    // Return the member to push to in this round
+    int choosePeer();
+
+    // Piggyback a sample of the network size sketch on each of 'messages'
+    void attachSizeSamples(std::vector<Message>& messages);
+
+    // Derive the network configuration from the estimated network size
+    void updateNetworkConfig();
+
+    // Point the state machines of the cohorts, copied or moved from another member, at the
+    // network configuration of this member
+    void adoptNetworkConfig();
+
+    // Make room for 'count' more rumors, evicting rumors outside '[keepFirst, keepEnd)' if the
+    // table is full. Return how many of them fit.
+    size_t reserveRumors(size_t count, int keepFirst, int keepEnd);
+
+    // Forget at least 'count' OLD or KNOWN rumors outside '[keepFirst, keepEnd)', if there are as
+    // many, and up to 'count + slack' when they are OLD
+    void evictRumors(size_t count, size_t slack, int keepFirst, int keepEnd);
+
+    // Drop the state of the current round and release its arena
+    void resetRoundState();
 
     // Add the specified 'value' to the previous statistic value
     void increaseStatValue(StatisticKey key, double value);
 
+    // Return the ID of the cohort identified by 'key' in the current round. If there is no such
+    // cohort yet, create one that starts from 'stateMachine'.
+    int roundCohort(const CohortKey& key, const RumorStateMachine& stateMachine);
+
+    // Schedule the round in which the KNOWN cohort 'cohortId' becomes OLD. Cohorts that are not
+    // NEW are not advanced every round, see 'RumorCohort::catchUp'.
+    void scheduleOld(int cohortId);
+
+    // Add the rumors '[first, end)', none of which is known yet, to the cohort 'cohortId'
+    void joinCohort(int first, int end, int cohortId);
+
+    // Move the known rumors '[first, end)', which share a cohort, to the cohort 'cohortId'
+    void moveToCohort(int first, int end, int cohortId);
+
+    // Add the rumors of '[first, end)' that are not known yet to the cohort of the rumors added in
+    // this round and set 'added[i]' for each added rumor 'first + i'.
+    void insertRumors(int first, int end, std::vector<bool>& added);
+
+    // Record that 'fromMember' sent the rumors '[first, end)' with age 'theirRound'
+    void rumorsReceived(int first, int end, int fromMember, int theirRound);
+
+    // Record that 'fromMember' sent the rumors '[first, end)' of the cohort 'cohortId'
+    void cohortReceived(int first, int end, int cohortId, int fromMember, int theirRound);
+
+    // Append a message of 'type' for every known rumor to 'messages'
+    void appendMessages(Message::Type type, std::vector<Message>& messages) const;
+
+    // Queue a state change of the rumors '[first, end)' to be reported once the mutex is released
+    void recordStateChange(int first, int end, RumorStateMachine::State from, RumorStateMachine::State to);
+
+    // Publish a new 'RumorView' if the rumors or their states changed. If rumors were only
+    // learned, the new view extends the previous one instead of copying every range. Must be
+    // called with the mutex.
+    void publishView();
+
+    // Report the queued 'changes' to the state change callbacks. Must be called without the mutex.
+    void notifyStateChanges(const std::vector<StateChange>& changes) const;
+
   public:
     // CONSTRUCTORS
     /// Create an instance which automatically figures out the network parameters.
@@ -61,39 +209,192 @@ class RumorMember : public RumorSpreadingInterface {
                 const NextMemberCb& cb,
                 int id = MemberID::next());
 
-    /// Used for manually passed network parameters.
+    /// Used for manually passed network parameters. 'networkConfig' may describe a network larger
+    /// than 'peers', e.g. when members only know part of it. The rumors and cohorts are allocated
+    /// from 'resource', which must outlive the member and its copies.
     RumorMember(const std::unordered_set<int>& peers,
                 const NetworkConfig& networkConfig,
-                int id = MemberID::next());
+                int id = MemberID::next(),
+                MemoryResource* resource = defaultMemoryResource());
     RumorMember(const std::unordered_set<int>& peers,
                 const NetworkConfig& networkConfig,
                 const NextMemberCb& cb,
-                int id = MemberID::next());
+                int id = MemberID::next(),
+                MemoryResource* resource = defaultMemoryResource());
 
     RumorMember(const RumorMember& other);
 
     RumorMember(RumorMember&& other) noexcept;
 
     // METHODS
+    // Return false if the rumor is already known or does not fit, see 'setMaxRumors'
     bool addRumor(int rumorId) override;
 
+    /**
+    *  @brief  Start spreading the rumors '[firstRumorId, firstRumorId + count)'.
+    *  @return Return a bitmap where bit 'i' is set if rumor 'firstRumorId + i' was added.
+    *
+    * Equivalent to calling 'addRumor' for every id in the range, but the rumors that are not known
+    * yet are inserted as whole ranges and the member is locked only once for the whole burst.
+    */
+    std::vector<bool> addRumors(int firstRumorId, size_t count);
+
+    // A peer heard from before in the round gets no PULL messages, and the NEW rumors it already
+    // sent in the round are ignored and counted as 'NumDuplicateRumors'. Duplicated datagrams,
+    // retransmits and the answers to PUSH messages that crossed are therefore harmless.
     std::pair<int, std::vector<Message>> receivedMessage(const Message& message, int fromPeer) override;
 
     std::pair<int, std::vector<Message>> advanceRound() override;
 
+    /**
+    *  @brief  Observe rumor state transitions.
+    *
+    * 'cb' is invoked when a rumor is learned (from UNKNOWN), becomes KNOWN or becomes OLD. It is
+    * called after the member's mutex is released, on the thread that caused the transition, so it
+    * may query the member. Callbacks are invoked in the order they were added. Add them before the
+    * member is used from several threads.
+    */
+    void addStateChangeCb(const StateChangeCb& cb);
+
+    /**
+    *  @brief  Send one message per run of consecutive rumor IDs that share an age.
+    *
+    * Rumors identified by dense sequence numbers, e.g. 'origin * stride + sequence', are then
+    * exchanged as a few 'Message's covering '[rumorId, rumorId + count)' instead of one message
+    * per rumor. Messages covering several rumors are always accepted, whether this is set or not.
+    * Even when it is not set, runs of more than 'k_maxExpandedRumors' rumors are sent as one
+    * message, so that a single received range cannot multiply the messages sent back.
+    */
+    void setRangeMessages(bool enabled);
+
+    /**
+    *  @brief  Hold at most 'maxRumors' rumors, 0 for no limit.
+    *
+    * When a new rumor does not fit, OLD rumors are forgotten first, oldest cohort first, then
+    * KNOWN rumors, those closest to becoming OLD first. NEW rumors are never evicted: once they
+    * fill the table, 'addRumor' and 'addRumors' refuse the rumors that do not fit and received
+    * rumors that do not fit are dropped, to be learned again from a later message. Evicted
+    * rumors are reported as changing to UNKNOWN and no longer exist, so a forgotten rumor that is
+    * received again spreads again. See the 'NumEvictedRumors', 'NumRejectedRumors' and
+    * 'NumDroppedRumors' statistics. OLD rumors are evicted with some slack so that a flood
+    * does not evict on every call. Lowering the limit takes effect on the next new rumor.
+    */
+    void setMaxRumors(size_t maxRumors);
+
+    /**
+    *  @brief  Stop selecting peers that do not answer PUSH messages.
+    *
+    * A peer that sends nothing back to 'suspectAfterMisses' consecutive PUSH messages is suspected
+    * and only selected for probes, 'probeInterval' rounds apart and backing off while unanswered,
+    * until a message from it arrives. See 'PeerLiveness'. Has no effect on the selection made by a 'NextMemberCb'. Call it before
+    * the member is used from several threads.
+    */
+    void trackLiveness(int suspectAfterMisses = 1, int probeInterval = 16);
+
+    /**
+    *  @brief  Prefer peers in the same zone, contacting another zone with 'remoteProbability'.
+    *
+    * 'zones' maps member IDs to a locality label, e.g. an availability zone or a rack. Peers with
+    * the label of this member are local, all the others, including unlabelled ones, are remote.
+    * Each round pushes to a remote peer with probability 'remoteProbability', in (0, 1], and to a
+    * local one otherwise, see 'PeerSchedule'. Lower probabilities cut cross-zone traffic at the
+    * cost of a few more rounds. Has no effect on the selection made by a 'NextMemberCb'. Call it
+    * before the member is used from several threads.
+    */
+    void setLocality(const std::unordered_map<int, int>& zones, double remoteProbability = 0.1);
+
+    /**
+    *  @brief  Resume the active rumors of another member, see 'activeRumors'.
+    *  @return Return the number of rumors learned.
+    *
+    * Lets a joining or recovering member catch up in one exchange instead of learning the rumors
+    * over several rounds: each rumor that is not known yet starts from a state machine in the
+    * state and at the age it had at the other member, so it becomes OLD when it does there.
+    * Known rumors keep their state. Call it once per 'StateTransfer' chunk as they arrive.
+    * Rumors that do not fit, see 'setMaxRumors', are dropped. See the 'NumImportedRumors'
+    * statistic.
+    */
+    size_t importRumors(const std::vector<StateTransfer::Range>& ranges);
+
+    /**
+    *  @brief  Derive the round limits from a gossiped estimate of the network size.
+    *
+    * Every outgoing message carries one register of a 'SizeEstimator' sketch, which restarts
+    * every 'epochRounds' rounds so that members that left stop counting. At the start of each
+    * round 'networkConfig()' is replaced by 'NetworkConfig(estimate)', so the limits of rumors
+    * already in flight follow too. During the first epoch the members in 'peers' are used as a
+    * lower bound. The sketch only advances while the member runs rounds, i.e. while it knows a
+    * rumor. Call it before the member is used from several threads.
+    */
+    void estimateNetworkSize(int epochRounds = 256);
+
+    /**
+    *  @brief  Record every later input of this member to 'recorder', null to stop recording.
+    *
+    * Writes the header of the trace: the member ID, the peers and the network configuration.
+    * Then added rumors, received messages, the peer chosen in each round and the setters are
+    * recorded in the order the member processed them, so a 'TraceReplayer' reproduces the same
+    * outputs. Call it on a fresh member, before the other setters. 'recorder' must outlive the
+    * recording and is not copied with the member.
+    */
+    void record(TraceRecorder* recorder);
+
     // CONST METHODS
     int id() const;
 
-    const NetworkConfig& networkConfig() const;
+    NetworkConfig networkConfig() const;
+
+    // Estimated number of members, 0 unless the network size is estimated
+    double estimatedNetworkSize() const;
+
+    // Return a copy of the state machine of every rumor
+    std::unordered_map<int, RumorStateMachine> rumorsMap() const;
+
+    // The NEW and KNOWN rumors in the current round, with their states and ages, as ranges of
+    // consecutive rumor IDs in increasing order. Encode them with 'StateTransfer' to bootstrap a
+    // member calling 'importRumors'.
+    std::vector<StateTransfer::Range> activeRumors() const;
+
+    // Number of distinct state machines advanced per round
+    size_t numCohorts() const;
 
-    const std::unordered_map<int, RumorStateMachine>& rumorsMap() const;
+    // Number of rumors currently in 'state'
+    size_t numRumors(RumorStateMachine::State state) const;
 
+    // Maximum number of rumors held, 0 for no limit
+    size_t maxRumors() const;
+
+    // Answered from the latest 'view()' without taking the member's mutex. This is not lock-free:
+    // 'std::atomic_load' of the view takes a short lock and updates its reference count, both
+    // shared by all the callers and by the member publishing a view. Use a 'RumorReader' per thread
+    // when querying at high rates from several threads, it only loads the view when it changed.
     bool rumorExists(int rumorId) const;
 
+    // Answered from the latest 'view()', see 'rumorExists'
     bool isOld(int rumorId) const;
 
+    // Latest published view of the rumors, updated before every call that changes them returns
+    std::shared_ptr<const RumorView> view() const;
+
+    // Version of the latest published view
+    unsigned long viewVersion() const;
+
+    // Number of peers currently suspected to be down, 0 unless liveness is tracked
+    size_t numSuspectedPeers() const;
+
     const std::map<StatisticKey, double>& statistics() const;
 
+    // Heap bytes held by the member
+    MemoryUsage memoryUsage() const;
+
+    /**
+    *  @brief  Latency histograms of the phases of 'receivedMessage' and 'advanceRound'.
+    *
+    * Includes the time spent waiting for the member's mutex. Every histogram is empty unless the
+    * library is built with 'RRS_PHASE_TIMERS'. See 'PhaseTimers'.
+    */
+    PhaseTimers::Snapshot phaseTimes() const;
+
     std::ostream& printStatistics(std::ostream& outStream) const;
 
     bool operator==(const RumorMember& other) const;
@@ -0,0 +1,41 @@
+#include "RumorReader.h"
+
+#include "RumorMember.h"
+
+namespace RRS {
+
+// PRIVATE METHODS
+void RumorReader::refresh()
+{
+    if (m_member->viewVersion() != m_view->version()) {
+        m_view = m_member->view();
+    }
+}
+
+// CONSTRUCTORS
+RumorReader::RumorReader(const RumorMember& member)
+: m_member(&member)
+, m_view(member.view())
+{
+}
+
+// PUBLIC METHODS
+bool RumorReader::rumorExists(int rumorId)
+{
+    refresh();
+    return m_view->rumorExists(rumorId);
+}
+
+bool RumorReader::isOld(int rumorId)
+{
+    refresh();
+    return m_view->isOld(rumorId);
+}
+
+const RumorView& RumorReader::view()
+{
+    refresh();
+    return *m_view;
+}
+
+} // project namespace
@@ -0,0 +1,44 @@
+#ifndef RANDOMIZEDRUMORSPREADING_RUMORREADER_H
+#define RANDOMIZEDRUMORSPREADING_RUMORREADER_H
+
+#include <memory>
+
+#include "RumorView.h"
+
+namespace RRS {
+
+class RumorMember;
+
+/**
+ * Per-thread reader of the rumors of a 'RumorMember'. Queries are answered from the last
+ * 'RumorView' the member published, without taking the member's mutex. A query only touches
+ * memory shared with other threads to compare the member's view version, which changes when the
+ * member publishes a new view, so reads scale with the number of reader threads. A reader must
+ * not be shared between threads or outlive its member.
+ */
+class RumorReader {
+  private:
+    // MEMBERS
+    const RumorMember*               m_member;
+    std::shared_ptr<const RumorView> m_view;
+
+    // METHODS
+    // Pick up the member's latest view if there is a newer one
+    void refresh();
+
+  public:
+    // CONSTRUCTORS
+    explicit RumorReader(const RumorMember& member);
+
+    // METHODS
+    bool rumorExists(int rumorId);
+
+    bool isOld(int rumorId);
+
+    // Return the latest view of the member
+    const RumorView& view();
+};
+
+} // project namespace
+
+#endif //RANDOMIZEDRUMORSPREADING_RUMORREADER_H
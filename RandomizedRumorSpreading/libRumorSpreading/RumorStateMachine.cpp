@@ -1,5 +1,8 @@
 #include "RumorStateMachine.h"
 
+#include <algorithm>
+#include <stdexcept>
+
 #define LITERAL(s) #s
 
 namespace RRS {
@@ -15,7 +18,7 @@ std::map<RumorStateMachine::State, std::string> RumorStateMachine::s_enumKeyToSt
 
 
 // PRIVATE METHODS
-void RumorStateMachine::advanceFromNew(const std::unordered_set<int> &membersInRound)
+void RumorStateMachine::advanceFromNew(const PeerSet& membersInRound)
 {
     m_roundsInB++;
     if (m_age >= m_networkConfigPtr->maxRoundsTotal()) {
@@ -108,18 +111,33 @@ RumorStateMachine::RumorStateMachine(const NetworkConfig* networkConfigPtr,
     m_memberRounds[fromMember] = theirRound;
 }
 
-void RumorStateMachine::rumorReceived(int memberId, int theirRound)
+RumorStateMachine::RumorStateMachine(const NetworkConfig* networkConfigPtr,
+                                     State state,
+                                     int age,
+                                     int roundsInB,
+                                     int roundsInC)
+: m_state(state)
+  , m_networkConfigPtr(networkConfigPtr)
+  , m_age(age)
+  , m_roundsInB(roundsInB)
+  , m_roundsInC(roundsInC)
+  , m_memberRounds()
+{
+    if (state != State::NEW && state != State::KNOWN) {
+        throw std::logic_error("Cannot resume state: " + s_enumKeyToString[state]);
+    }
+}
+
+bool RumorStateMachine::rumorReceived(int memberId, int theirRound)
 {
     // Only care about other members when the rumor is NEW
-    if (m_state == State::NEW) {
-        if (m_memberRounds.count(memberId) > 0) {
-            throw std::logic_error("Received a message from the same member within a single round");
-        }
-        m_memberRounds[memberId] = theirRound;
+    if (m_state != State::NEW) {
+        return true;
     }
+    return m_memberRounds.emplace(memberId, theirRound).second;
 }
 
-void RumorStateMachine::advanceRound(const std::unordered_set<int>& peersInCurrentRound)
+void RumorStateMachine::advanceRound(const PeerSet& peersInCurrentRound)
 {
     m_age++;
     switch (m_state) {
@@ -138,6 +156,35 @@ void RumorStateMachine::advanceRound(const std::unordered_set<int>& peersInCurre
     }
 }
 
+void RumorStateMachine::setNetworkConfig(const NetworkConfig* networkConfigPtr)
+{
+    m_networkConfigPtr = networkConfigPtr;
+}
+
+void RumorStateMachine::skipRounds(int numRounds)
+{
+    if (numRounds <= 0) {
+        return;
+    }
+    if (m_state != State::KNOWN && m_state != State::OLD) {
+        throw std::logic_error("Cannot skip rounds in state: " + s_enumKeyToString[m_state]);
+    }
+
+    if (m_state == State::KNOWN) {
+        const int untilOld = roundsUntilOld();
+        const int numKnownRounds = std::min(numRounds, untilOld);
+        m_age += numKnownRounds;
+        m_roundsInC += numKnownRounds;
+        numRounds -= numKnownRounds;
+        if (numKnownRounds == untilOld) {
+            advanceToOld();
+        }
+    }
+
+    // OLD rumors age two rounds per round
+    m_age += 2 * numRounds;
+}
+
 const RumorStateMachine::State RumorStateMachine::state() const
 {
     return m_state;
@@ -153,6 +200,53 @@ const bool RumorStateMachine::isOld() const
     return m_state == State::OLD;
 }
 
+int RumorStateMachine::roundsInB() const
+{
+    return m_roundsInB;
+}
+
+int RumorStateMachine::roundsInC() const
+{
+    return m_roundsInC;
+}
+
+bool RumorStateMachine::heardFrom(int memberId) const
+{
+    return m_state == State::NEW && m_memberRounds.count(memberId) > 0;
+}
+
+int RumorStateMachine::roundsUntilOld() const
+{
+    if (m_state != State::KNOWN) {
+        return -1;
+    }
+    return std::max(1, std::min(m_networkConfigPtr->maxRoundsTotal() - m_age,
+                                m_networkConfigPtr->maxRoundsInC() - m_roundsInC));
+}
+
+int RumorStateMachine::ageAfter(int numRounds) const
+{
+    if (numRounds <= 0) {
+        return m_age;
+    }
+
+    int age = m_age;
+    if (m_state == State::KNOWN) {
+        const int numKnownRounds = std::min(numRounds, roundsUntilOld());
+        age += numKnownRounds;
+        numRounds -= numKnownRounds;
+    }
+    return age + 2 * numRounds;
+}
+
+size_t RumorStateMachine::memoryUsage() const
+{
+    // One node per peer, a hash bucket per slot
+    typedef std::unordered_map<int, int>::value_type Entry;
+    return m_memberRounds.bucket_count() * sizeof(void*) +
+           m_memberRounds.size() * (sizeof(Entry) + sizeof(void*));
+}
+
 std::ostream& operator<<(std::ostream& os, const RumorStateMachine& machine)
 {
     os << "{ state: " << RumorStateMachine::s_enumKeyToString[machine.m_state]
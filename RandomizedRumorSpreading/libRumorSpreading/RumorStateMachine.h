@@ -7,6 +7,7 @@
 #include <unordered_set>
 #include <functional>
 #include <ostream>
+#include "MemoryResource.h"
 #include "NetworkConfig.h"
 
 namespace RRS {
@@ -24,6 +25,10 @@ class RumorStateMachine {
 
     static std::map<State, std::string> s_enumKeyToString;
 
+    // TYPES
+    // Peers that sent a message in a round
+    typedef std::unordered_set<int, std::hash<int>, std::equal_to<int>, ResourceAllocator<int>> PeerSet;
+
   private:
     // MEMBERS
     State                        m_state;
@@ -34,7 +39,7 @@ class RumorStateMachine {
     std::unordered_map<int, int> m_memberRounds; // Member ID --> age
 
     // METHODS
-    void advanceFromNew(const std::unordered_set<int> &membersInRound);
+    void advanceFromNew(const PeerSet& membersInRound);
 
     void advanceFromKnown();
 
@@ -52,6 +57,11 @@ class RumorStateMachine {
     // 'theirRound' parameters.
     RumorStateMachine(const NetworkConfig* networkConfigPtr, int fromMember, int theirRound);
 
+    // Construct an instance resuming the specified NEW or KNOWN 'state' of another member's state
+    // machine, at 'age' after 'roundsInB' and 'roundsInC' rounds, see 'StateTransfer'. No member
+    // was heard from in the current round yet.
+    RumorStateMachine(const NetworkConfig* networkConfigPtr, State state, int age, int roundsInB, int roundsInC);
+
     // Copy constructor.
     RumorStateMachine(const RumorStateMachine& other) = default;
 
@@ -66,9 +76,21 @@ class RumorStateMachine {
     RumorStateMachine& operator=(RumorStateMachine&& other) = default;
 
     // METHODS
-    void rumorReceived(int memberId, int theirRound);
+    // Record that 'memberId' sent the rumor at age 'theirRound' in this round. Only a NEW rumor
+    // tracks the members. A member that already sent it in this round is a duplicate, e.g. a
+    // retransmit or the answer to a PUSH crossing its own PUSH: the first age is kept and false
+    // is returned.
+    bool rumorReceived(int memberId, int theirRound);
+
+    void advanceRound(const PeerSet& peersInCurrentRound);
 
-    void advanceRound(const std::unordered_set<int>& peersInCurrentRound);
+    // Take the round limits from 'networkConfigPtr' from now on, e.g. once the configuration it
+    // pointed to was copied or moved along with its owner.
+    void setNetworkConfig(const NetworkConfig* networkConfigPtr);
+
+    // Apply 'numRounds' rounds to a KNOWN or OLD rumor at once. Equivalent to as many calls to
+    // 'advanceRound', which a NEW rumor needs since it depends on the peers of each round.
+    void skipRounds(int numRounds);
 
     // CONST METHODS
     const State state() const;
@@ -77,6 +99,25 @@ class RumorStateMachine {
 
     const bool isOld() const;
 
+    // Rounds counted while NEW, in the state B-m of the algorithm
+    int roundsInB() const;
+
+    // Rounds counted while KNOWN, in the state C
+    int roundsInC() const;
+
+    // Whether the NEW rumor was received from 'memberId' in this round
+    bool heardFrom(int memberId) const;
+
+    // Number of calls to 'advanceRound' after which a KNOWN rumor becomes OLD, -1 in any other
+    // state
+    int roundsUntilOld() const;
+
+    // Age after 'skipRounds(numRounds)'
+    int ageAfter(int numRounds) const;
+
+    // Estimated heap bytes held by the ages of the peers
+    size_t memoryUsage() const;
+
     friend std::ostream& operator<<(std::ostream& os, const RumorStateMachine& machine);
 };
 
@@ -0,0 +1,128 @@
+#include "RumorView.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace RRS {
+
+namespace {
+
+bool startsBefore(const RumorView::Range& lhs, const RumorView::Range& rhs)
+{
+    return lhs.m_first < rhs.m_first;
+}
+
+// Merge each range of the sorted 'ranges' into the previous one if they touch in the same state
+void coalesce(std::vector<RumorView::Range>& ranges)
+{
+    size_t size = 0;
+    for (const RumorView::Range& range : ranges) {
+        if (size > 0 && ranges[size - 1].m_end == range.m_first && ranges[size - 1].m_isOld == range.m_isOld) {
+            ranges[size - 1].m_end = range.m_end;
+        }
+        else {
+            ranges[size++] = range;
+        }
+    }
+    ranges.resize(size);
+}
+
+// Merge the sorted and disjoint 'lhs' and 'rhs'
+std::vector<RumorView::Range> merge(const std::vector<RumorView::Range>& lhs, const std::vector<RumorView::Range>& rhs)
+{
+    std::vector<RumorView::Range> ranges;
+    ranges.reserve(lhs.size() + rhs.size());
+    std::merge(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::back_inserter(ranges), startsBefore);
+    coalesce(ranges);
+    return ranges;
+}
+
+} // anonymous namespace
+
+// PRIVATE CONST METHODS
+const RumorView::Range* RumorView::find(int rumorId) const
+{
+    for (const std::shared_ptr<const Run>& run : m_runs) {
+        // First range ending after 'rumorId'
+        const auto& iter = std::upper_bound(run->begin(),
+                                            run->end(),
+                                            rumorId,
+                                            [](int id, const Range& range) { return id < range.m_end; });
+        if (iter != run->end() && iter->m_first <= rumorId) {
+            return &*iter;
+        }
+    }
+    return nullptr;
+}
+
+// CONSTRUCTORS
+RumorView::RumorView()
+: m_runs()
+, m_version(0)
+{
+}
+
+RumorView::RumorView(std::vector<Range>&& ranges, unsigned long version)
+: m_runs()
+, m_version(version)
+{
+    if (!ranges.empty()) {
+        m_runs.push_back(std::make_shared<Run>(std::move(ranges)));
+    }
+}
+
+RumorView::RumorView(const RumorView& previous, std::vector<Range>&& added, unsigned long version)
+: m_runs(previous.m_runs)
+, m_version(version)
+{
+    if (added.empty()) {
+        return;
+    }
+    std::sort(added.begin(), added.end(), startsBefore);
+    coalesce(added);
+    std::shared_ptr<const Run> run = std::make_shared<Run>(std::move(added));
+
+    // Like the carries of a binary counter, a run only merges with runs at most twice as long
+    while (!m_runs.empty() && m_runs.back()->size() <= 2 * run->size()) {
+        run = std::make_shared<Run>(merge(*m_runs.back(), *run));
+        m_runs.pop_back();
+    }
+    m_runs.push_back(std::move(run));
+}
+
+// PUBLIC CONST METHODS
+bool RumorView::rumorExists(int rumorId) const
+{
+    return find(rumorId) != nullptr;
+}
+
+bool RumorView::isOld(int rumorId) const
+{
+    const Range* range = find(rumorId);
+    return range != nullptr && range->m_isOld;
+}
+
+std::vector<RumorView::Range> RumorView::ranges() const
+{
+    std::vector<Range> ranges;
+    for (const std::shared_ptr<const Run>& run : m_runs) {
+        ranges = merge(ranges, *run);
+    }
+    return ranges;
+}
+
+size_t RumorView::memoryUsage() const
+{
+    size_t size = sizeof(RumorView) + m_runs.capacity() * sizeof(std::shared_ptr<const Run>);
+    for (const std::shared_ptr<const Run>& run : m_runs) {
+        size += sizeof(Run) + run->capacity() * sizeof(Range);
+    }
+    return size;
+}
+
+unsigned long RumorView::version() const
+{
+    return m_version;
+}
+
+} // project namespace
@@ -0,0 +1,70 @@
+#ifndef RANDOMIZEDRUMORSPREADING_RUMORVIEW_H
+#define RANDOMIZEDRUMORSPREADING_RUMORVIEW_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace RRS {
+
+/**
+ * Immutable copy of which rumors a member knows and which of them are OLD, published by the
+ * member after every call that changed either. Consecutive rumor IDs that are all known, or all
+ * OLD, share one range, so a lookup is a binary search over a few ranges.
+ *
+ * The ranges are kept in a few sorted runs shared with the previous views. A view that only adds
+ * rumors copies the run pointers and adds a run, merging the runs of similar lengths, so that each
+ * range is copied O(log n) times however many views are published. Runs are more than twice as
+ * long as the next one, so a lookup searches O(log n) of them, usually a single one: the member
+ * builds a view from all its rumors, in one run, when their states change.
+ */
+class RumorView {
+  public:
+    // TYPES
+    struct Range {
+        int  m_first;
+        int  m_end;
+        bool m_isOld;   // Every rumor of '[m_first, m_end)' is OLD
+    };
+
+  private:
+    // TYPES
+    typedef std::vector<Range> Run;   // Sorted and disjoint
+
+    // MEMBERS
+    std::vector<std::shared_ptr<const Run>> m_runs;     // Disjoint, longest first
+    unsigned long                           m_version;  // Number of views published before this one
+
+    // CONST METHODS
+    // Range containing 'rumorId', nullptr if there is none
+    const Range* find(int rumorId) const;
+
+  public:
+    // CONSTRUCTORS
+    // Default constructor. The returned view contains no rumors.
+    RumorView();
+
+    // Construct a view of 'ranges', which must be sorted and disjoint.
+    RumorView(std::vector<Range>&& ranges, unsigned long version);
+
+    // Construct a view of the rumors of 'previous' and of 'added', which must be disjoint and not
+    // in 'previous'
+    RumorView(const RumorView& previous, std::vector<Range>&& added, unsigned long version);
+
+    // CONST METHODS
+    bool rumorExists(int rumorId) const;
+
+    bool isOld(int rumorId) const;
+
+    // Return all the ranges in order, consecutive ones with the same state merged
+    std::vector<Range> ranges() const;
+
+    // Heap bytes held by the view, including the runs it shares
+    size_t memoryUsage() const;
+
+    unsigned long version() const;
+};
+
+} // project namespace
+
+#endif //RANDOMIZEDRUMORSPREADING_RUMORVIEW_H
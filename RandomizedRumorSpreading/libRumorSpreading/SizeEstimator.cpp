@@ -0,0 +1,185 @@
+#include "SizeEstimator.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace RRS {
+
+namespace {
+
+// Bias correction of HyperLogLog for 64 registers
+const double k_alpha = 0.709;
+
+// Layout of a sample: 6 bits per register of the block, then the block index, a bit that is
+// always set so that no sample is 0, and the low 8 bits of the epoch
+const int k_rankBits = 6;
+const uint64_t k_rankMask = (1u << k_rankBits) - 1;
+const int k_blockShift = 48;
+const int k_validShift = 51;
+const int k_epochShift = 56;
+
+uint64_t mix(uint64_t value)
+{
+    // splitmix64 finalizer
+    value += 0x9e3779b97f4a7c15ULL;
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+    return value ^ (value >> 31);
+}
+
+} // anonymous namespace
+
+// PRIVATE METHODS
+void SizeEstimator::startEpoch(int epoch)
+{
+    m_lastEstimate = currentEstimate();
+    m_registers.fill(0);
+    m_changed.clear();
+    m_epoch = epoch;
+    m_round = 0;
+
+    // This member's entry: the low bits pick the register, the rank is the position of the
+    // lowest set bit among the others
+    const uint64_t hash = mix((static_cast<uint64_t>(static_cast<uint32_t>(m_memberId)) << 32) |
+                              static_cast<uint32_t>(epoch));
+    const int index = static_cast<int>(hash % k_numRegisters);
+    int rank = 1;
+    for (uint64_t rest = hash / k_numRegisters; (rest & 1) == 0 && rank < 58; rest >>= 1) {
+        ++rank;
+    }
+    merge(index, rank);
+}
+
+void SizeEstimator::merge(int index, int rank)
+{
+    if (m_registers[index] >= rank) {
+        return;
+    }
+
+    m_registers[index] = static_cast<uint8_t>(rank);
+    const int block = index / k_blockSize;
+    if (std::find(m_changed.begin(), m_changed.end(), block) == m_changed.end()) {
+        m_changed.push_back(block);
+    }
+}
+
+uint64_t SizeEstimator::sample(int block) const
+{
+    uint64_t sample = (static_cast<uint64_t>(m_epoch & 0xff) << k_epochShift) |
+                      (uint64_t(1) << k_validShift) |
+                      (static_cast<uint64_t>(block) << k_blockShift);
+    for (int i = 0; i < k_blockSize; ++i) {
+        sample |= static_cast<uint64_t>(m_registers[block * k_blockSize + i]) << (i * k_rankBits);
+    }
+    return sample;
+}
+
+// CONSTRUCTORS
+SizeEstimator::SizeEstimator()
+: m_memberId(0)
+, m_epochRounds(0)
+, m_epoch(0)
+, m_round(0)
+, m_registers()
+, m_changed()
+, m_nextBlock(0)
+, m_lastEstimate(0)
+{
+    m_registers.fill(0);
+}
+
+SizeEstimator::SizeEstimator(int memberId, int epochRounds)
+: m_memberId(memberId)
+, m_epochRounds(epochRounds > 0 ? epochRounds : 1)
+, m_epoch(0)
+, m_round(0)
+, m_registers()
+, m_changed()
+, m_nextBlock(0)
+, m_lastEstimate(0)
+{
+    m_registers.fill(0);
+    startEpoch(0);
+    m_lastEstimate = 0;
+}
+
+// PUBLIC METHODS
+void SizeEstimator::newRound()
+{
+    if (m_epochRounds > 0 && ++m_round >= m_epochRounds) {
+        startEpoch(m_epoch + 1);
+    }
+}
+
+uint64_t SizeEstimator::nextSample()
+{
+    if (m_epochRounds <= 0) {
+        return 0;
+    }
+
+    // Blocks that changed spread first, like a rumor, the others are repeated in turn
+    if (!m_changed.empty()) {
+        const int block = m_changed.front();
+        m_changed.erase(m_changed.begin());
+        return sample(block);
+    }
+
+    const int block = m_nextBlock;
+    m_nextBlock = (m_nextBlock + 1) % k_numBlocks;
+    return sample(block);
+}
+
+void SizeEstimator::sampleReceived(uint64_t sample)
+{
+    if (m_epochRounds <= 0 || ((sample >> k_validShift) & 1) == 0) {
+        return;
+    }
+
+    // Epoch numbers wrap around, the sender is ahead if it is less than half the range away
+    const uint8_t sampleEpoch = static_cast<uint8_t>(sample >> k_epochShift);
+    const int8_t epochsAhead = static_cast<int8_t>(static_cast<uint8_t>(sampleEpoch - m_epoch));
+    if (epochsAhead < 0) {
+        return;
+    }
+    if (epochsAhead > 0) {
+        startEpoch(m_epoch + epochsAhead);
+    }
+
+    const int block = static_cast<int>((sample >> k_blockShift) & (k_numBlocks - 1));
+    for (int i = 0; i < k_blockSize; ++i) {
+        merge(block * k_blockSize + i, static_cast<int>((sample >> (i * k_rankBits)) & k_rankMask));
+    }
+}
+
+// PUBLIC CONST METHODS
+double SizeEstimator::estimate() const
+{
+    return std::max(m_lastEstimate, currentEstimate());
+}
+
+double SizeEstimator::currentEstimate() const
+{
+    double sum = 0;
+    int numZeros = 0;
+    for (const uint8_t rank : m_registers) {
+        sum += std::ldexp(1.0, -static_cast<int>(rank));
+        if (rank == 0) {
+            ++numZeros;
+        }
+    }
+
+    const double numRegisters = k_numRegisters;
+    double estimate = k_alpha * numRegisters * numRegisters / sum;
+    if (estimate <= 2.5 * numRegisters && numZeros > 0) {
+        // Linear counting is more accurate for small networks
+        estimate = numRegisters * std::log(numRegisters / numZeros);
+    }
+    return std::max(1.0, estimate);
+}
+
+int SizeEstimator::epoch() const
+{
+    return m_epoch;
+}
+
+} // project namespace
@@ -0,0 +1,78 @@
+#ifndef RANDOMIZEDRUMORSPREADING_SIZEESTIMATOR_H
+#define RANDOMIZEDRUMORSPREADING_SIZEESTIMATOR_H
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace RRS {
+
+/**
+ * Distributed estimate of the number of members, gossiped on the messages the members exchange
+ * anyway. Every member adds its own ID to a HyperLogLog sketch of 'k_numRegisters' registers and
+ * registers are merged by taking the maximum, so samples may be duplicated, reordered or lost. A
+ * sample carries one block of 'k_blockSize' registers, the blocks that changed first. The relative
+ * error is about 1.04 / sqrt(k_numRegisters).
+ *
+ * The sketch only grows, so it is restarted every 'epochRounds' rounds with freshly salted
+ * hashes: members that left stop counting after an epoch. Epochs are numbered and a sample from
+ * a later epoch moves the receiver to that epoch, which keeps the members in step.
+ */
+class SizeEstimator {
+  public:
+    // CONSTANTS
+    static const int k_numRegisters = 64;
+    static const int k_blockSize = 8;
+    static const int k_numBlocks = k_numRegisters / k_blockSize;
+
+  private:
+    // MEMBERS
+    int                                   m_memberId;
+    int                                   m_epochRounds;
+    int                                   m_epoch;
+    int                                   m_round;          // Rounds into the current epoch
+    std::array<uint8_t, k_numRegisters>   m_registers;      // Register --> maximal rank seen
+    std::vector<int>                      m_changed;        // Blocks to send before the others
+    int                                   m_nextBlock;      // Next block to send in turn
+    double                                m_lastEstimate;   // Estimate of the previous epoch
+
+    // METHODS
+    // Finish the current epoch and start 'epoch' with only this member in the sketch
+    void startEpoch(int epoch);
+
+    // Raise register 'index' to 'rank'
+    void merge(int index, int rank);
+
+    // Encode the block 'block' of the current epoch
+    uint64_t sample(int block) const;
+
+  public:
+    // CONSTRUCTORS
+    // Default constructor. The returned instance sends no samples.
+    SizeEstimator();
+
+    SizeEstimator(int memberId, int epochRounds);
+
+    // METHODS
+    // Advance the epoch clock by one round. Call once at the start of every round.
+    void newRound();
+
+    // Return the sample to piggyback on the next outgoing message, 0 if there is none.
+    uint64_t nextSample();
+
+    // Merge a 'sample' received from a peer. Samples equal to 0 are ignored.
+    void sampleReceived(uint64_t sample);
+
+    // CONST METHODS
+    // Estimated number of members, at least 1. A network that shrank shows within two epochs.
+    double estimate() const;
+
+    // Estimate of the sketch of the current epoch alone
+    double currentEstimate() const;
+
+    int epoch() const;
+};
+
+} // project namespace
+
+#endif //RANDOMIZEDRUMORSPREADING_SIZEESTIMATOR_H
@@ -0,0 +1,159 @@
+#include "StateTransfer.h"
+
+#include <cassert>
+
+#include "Varint.h"
+
+namespace RRS {
+
+namespace {
+
+const uint64_t k_checksumPrime = 0x100000001b3ULL;
+
+// Every entry takes at least 5 bytes
+const size_t k_minEntrySize = 5;
+
+void storeLE(uint8_t* out, uint64_t value, int numBytes)
+{
+    for (int i = 0; i < numBytes; ++i) {
+        out[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+uint64_t loadLE(const uint8_t* in, int numBytes)
+{
+    uint64_t value = 0;
+    for (int i = 0; i < numBytes; ++i) {
+        value |= static_cast<uint64_t>(in[i]) << (8 * i);
+    }
+    return value;
+}
+
+// Continue the checksum state 'h' over 'size' bytes, eight at a time
+uint64_t mixWords(uint64_t h, const uint8_t* data, size_t size)
+{
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        h = (h ^ loadLE(data + i, 8)) * k_checksumPrime;
+    }
+    if (i < size) {
+        h = (h ^ loadLE(data + i, static_cast<int>(size - i))) * k_checksumPrime;
+    }
+    return h;
+}
+
+uint32_t chunkChecksum(const uint8_t* chunk, size_t size)
+{
+    uint64_t h = mixWords(size * k_checksumPrime, chunk, 16);
+    h = mixWords(h, chunk + StateTransfer::k_headerSize, size - StateTransfer::k_headerSize);
+    return static_cast<uint32_t>(h ^ (h >> 32));
+}
+
+int nextRumorId(int rumorId, int count)
+{
+    return static_cast<int>(static_cast<uint32_t>(rumorId) + static_cast<uint32_t>(count));
+}
+
+bool isResumable(RumorStateMachine::State state)
+{
+    return state == RumorStateMachine::State::NEW || state == RumorStateMachine::State::KNOWN;
+}
+
+} // anonymous namespace
+
+// CONSTANTS
+const uint16_t StateTransfer::k_magic;
+const uint8_t StateTransfer::k_version;
+const uint8_t StateTransfer::k_lastChunk;
+const size_t StateTransfer::k_headerSize;
+const size_t StateTransfer::k_maxEntrySize;
+const size_t StateTransfer::k_defaultChunkSize;
+
+// STATIC METHODS
+size_t StateTransfer::encode(int fromMember, const std::vector<Range>& ranges, const ChunkCb& cb, size_t maxChunkSize)
+{
+    assert(maxChunkSize >= k_headerSize + k_maxEntrySize);
+
+    std::vector<uint8_t> chunk(maxChunkSize);
+    uint32_t sequence = 0;
+    size_t next = 0;
+    do {
+        uint8_t* pos = chunk.data() + k_headerSize;
+        const uint8_t* const end = chunk.data() + maxChunkSize;
+        uint32_t count = 0;
+        int expectedId = 0;
+        for (; next < ranges.size() && end - pos >= static_cast<std::ptrdiff_t>(k_maxEntrySize); ++next) {
+            const Range& range = ranges[next];
+            assert(isResumable(range.m_state) && range.m_count > 0);
+            *pos++ = static_cast<uint8_t>(range.m_state);
+            pos = Varint::write(pos, Varint::zigzag(static_cast<int32_t>(static_cast<uint32_t>(range.m_first) -
+                                                                         static_cast<uint32_t>(expectedId))));
+            pos = Varint::write(pos, static_cast<uint32_t>(range.m_count));
+            pos = Varint::write(pos, static_cast<uint32_t>(range.m_age));
+            pos = Varint::write(pos, static_cast<uint32_t>(range.m_roundsInState));
+            expectedId = nextRumorId(range.m_first, range.m_count);
+            ++count;
+        }
+
+        const size_t size = static_cast<size_t>(pos - chunk.data());
+        storeLE(chunk.data(), k_magic, 2);
+        chunk[2] = k_version;
+        chunk[3] = next == ranges.size() ? k_lastChunk : 0;
+        storeLE(chunk.data() + 4, static_cast<uint32_t>(fromMember), 4);
+        storeLE(chunk.data() + 8, sequence, 4);
+        storeLE(chunk.data() + 12, count, 4);
+        storeLE(chunk.data() + 16, chunkChecksum(chunk.data(), size), 4);
+        cb(reinterpret_cast<const char*>(chunk.data()), size);
+        ++sequence;
+    } while (next < ranges.size());
+    return sequence;
+}
+
+bool StateTransfer::decode(const char* data, size_t size, Chunk& chunk)
+{
+    const uint8_t* pos = reinterpret_cast<const uint8_t*>(data);
+    if (size < k_headerSize || loadLE(pos, 2) != k_magic || pos[2] != k_version ||
+        (pos[3] & ~k_lastChunk) != 0) {
+        return false;
+    }
+    const uint32_t count = static_cast<uint32_t>(loadLE(pos + 12, 4));
+    if ((size - k_headerSize) / k_minEntrySize < count || loadLE(pos + 16, 4) != chunkChecksum(pos, size)) {
+        return false;
+    }
+
+    chunk.m_fromMember = static_cast<int>(static_cast<uint32_t>(loadLE(pos + 4, 4)));
+    chunk.m_sequence = static_cast<uint32_t>(loadLE(pos + 8, 4));
+    chunk.m_last = (pos[3] & k_lastChunk) != 0;
+    chunk.m_ranges.resize(count);
+
+    const uint8_t* const end = pos + size;
+    pos += k_headerSize;
+    int expectedId = 0;
+    for (Range& range : chunk.m_ranges) {
+        if (pos >= end) {
+            return false;
+        }
+        range.m_state = static_cast<RumorStateMachine::State>(*pos++);
+        uint32_t id;
+        uint32_t numRumors;
+        uint32_t age;
+        uint32_t roundsInState;
+        if (!isResumable(range.m_state) || !Varint::read(pos, end, id) || !Varint::read(pos, end, numRumors) ||
+            !Varint::read(pos, end, age) || !Varint::read(pos, end, roundsInState) ||
+            numRumors == 0 || numRumors > INT32_MAX || age > INT32_MAX || roundsInState > INT32_MAX) {
+            return false;
+        }
+        range.m_first = static_cast<int>(static_cast<uint32_t>(expectedId) + static_cast<uint32_t>(Varint::unzigzag(id)));
+        // The range must not go past the largest rumor ID
+        if (static_cast<int64_t>(range.m_first) + numRumors > INT32_MAX) {
+            return false;
+        }
+        range.m_count = static_cast<int>(numRumors);
+        range.m_age = static_cast<int>(age);
+        range.m_roundsInState = static_cast<int>(roundsInState);
+        expectedId = nextRumorId(range.m_first, range.m_count);
+    }
+    return pos == end;
+}
+
+} // project namespace
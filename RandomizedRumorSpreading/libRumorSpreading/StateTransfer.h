@@ -0,0 +1,82 @@
+#ifndef RANDOMIZEDRUMORSPREADING_STATETRANSFER_H
+#define RANDOMIZEDRUMORSPREADING_STATETRANSFER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "RumorStateMachine.h"
+
+namespace RRS {
+
+/**
+ * Bulk transfer of the active rumors of a member to a joining or recovering one, see
+ * 'RumorMember::activeRumors' and 'RumorMember::importRumors'.
+ *
+ * The table is streamed as chunks of at most a given size, e.g. a datagram, each of which is
+ * self-contained so that the joiner imports it as soon as it arrives. All the integers are little
+ * endian.
+ *
+ * Header, 'k_headerSize' bytes:
+ *   uint16 magic 'k_magic', uint8 version 'k_version', uint8 flags ('k_lastChunk'),
+ *   int32 sender ID, uint32 sequence number of the chunk, uint32 number of ranges,
+ *   uint32 checksum
+ *
+ * Then one entry per range of rumors sharing a state:
+ *   uint8 state, NEW or KNOWN
+ *   varint zigzag(first rumor ID - expected ID), the expected ID being the end of the previous
+ *          range, 0 for the first one
+ *   varint count
+ *   varint age
+ *   varint rounds in the state, B-m for NEW and C for KNOWN
+ *
+ * The checksum covers the first 16 bytes of the header and all the entries.
+ */
+class StateTransfer {
+  public:
+    // TYPES
+    struct Range {
+        int                      m_first;
+        int                      m_count;
+        RumorStateMachine::State m_state;         // NEW or KNOWN
+        int                      m_age;
+        int                      m_roundsInState; // Rounds in B-m if NEW, in C if KNOWN
+    };
+
+    struct Chunk {
+        int                m_fromMember;
+        uint32_t           m_sequence;
+        bool               m_last;       // No chunk follows
+        std::vector<Range> m_ranges;
+    };
+
+    // Invoked with each encoded chunk, which is only valid during the call
+    typedef std::function<void(const char*, size_t)> ChunkCb;
+
+    // CONSTANTS
+    static const uint16_t k_magic = 0x5453;
+    static const uint8_t k_version = 1;
+    static const uint8_t k_lastChunk = 0x01;
+    static const size_t k_headerSize = 20;
+    static const size_t k_maxEntrySize = 1 + 4 * 5;
+    static const size_t k_defaultChunkSize = 1400;
+
+    // STATIC METHODS
+    // Encode 'ranges' into chunks of at most 'maxChunkSize' bytes, which must hold a header and an
+    // entry, and pass them to 'cb' in order. At least one chunk is produced, the last one flagged.
+    // Return the number of chunks.
+    static size_t encode(int fromMember,
+                         const std::vector<Range>& ranges,
+                         const ChunkCb& cb,
+                         size_t maxChunkSize = k_defaultChunkSize);
+
+    // Decode the chunk of 'size' bytes at 'data' into 'chunk', reusing the capacity of its ranges.
+    // Return false if the chunk is malformed, e.g. a range goes past the largest rumor ID, 'chunk'
+    // is then unspecified.
+    static bool decode(const char* data, size_t size, Chunk& chunk);
+};
+
+} // project namespace
+
+#endif //RANDOMIZEDRUMORSPREADING_STATETRANSFER_H
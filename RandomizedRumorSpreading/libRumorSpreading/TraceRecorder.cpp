@@ -0,0 +1,179 @@
+#include "TraceRecorder.h"
+
+#include <algorithm>
+#include <climits>
+
+#include "Varint.h"
+#include "WireFormat.h"
+
+namespace RRS {
+
+namespace {
+
+const size_t k_flushSize = 64 * 1024;
+
+} // anonymous namespace
+
+// CONSTANTS
+const uint8_t TraceRecorder::k_magic[4] = {'R', 'R', 'S', 'T'};
+const uint8_t TraceRecorder::k_version;
+
+// PRIVATE METHODS
+void TraceRecorder::putInt(int value)
+{
+    uint8_t bytes[Varint::k_maxSize];
+    uint8_t* end = Varint::write(bytes, Varint::zigzag(value));
+    m_buffer.insert(m_buffer.end(), bytes, end);
+}
+
+void TraceRecorder::putRecord(Record record)
+{
+    m_buffer.push_back(static_cast<uint8_t>(record));
+    ++m_numRecords;
+}
+
+void TraceRecorder::maybeFlush()
+{
+    if (m_buffer.size() >= k_flushSize) {
+        m_out.write(reinterpret_cast<const char*>(m_buffer.data()), static_cast<std::streamsize>(m_buffer.size()));
+        m_buffer.clear();
+    }
+}
+
+// CONSTRUCTORS
+TraceRecorder::TraceRecorder(std::ostream& out)
+: m_out(out)
+, m_buffer()
+, m_numRecords(0)
+{
+    m_buffer.reserve(k_flushSize + 64);
+}
+
+// DESTRUCTOR
+TraceRecorder::~TraceRecorder()
+{
+    flush();
+}
+
+// PUBLIC METHODS
+void TraceRecorder::start(int memberId, const std::vector<int>& peers, const NetworkConfig& networkConfig)
+{
+    m_buffer.insert(m_buffer.end(), k_magic, k_magic + sizeof(k_magic));
+    m_buffer.push_back(k_version);
+    putInt(memberId);
+    putInt(static_cast<int>(peers.size()));
+    for (const int peer : peers) {
+        putInt(peer);
+    }
+    putInt(static_cast<int>(networkConfig.networkSize()));
+    putInt(networkConfig.maxRoundsInB());
+    putInt(networkConfig.maxRoundsInC());
+    putInt(networkConfig.maxRoundsTotal());
+    maybeFlush();
+}
+
+void TraceRecorder::rumorsAdded(int firstRumorId, size_t count)
+{
+    putRecord(Record::ADD_RUMORS);
+    putInt(firstRumorId);
+    putInt(static_cast<int>(count));
+    maybeFlush();
+}
+
+void TraceRecorder::messageReceived(const Message& message, int fromPeer)
+{
+    putRecord(Record::RECEIVED);
+    putInt(fromPeer);
+
+    // Same encoding as a 'WireFormat' entry whose expected ID is 0, so that the replayer can
+    // decode it with 'WireFormat::readEntry'
+    uint8_t bytes[WireFormat::k_maxEntrySize];
+    uint8_t* pos = bytes;
+    uint8_t tag = static_cast<uint8_t>(message.type()) & WireFormat::k_typeMask;
+    if (message.count() != 1) {
+        tag |= WireFormat::k_hasCount;
+    }
+    if (message.sizeSample() != 0) {
+        tag |= WireFormat::k_hasSample;
+    }
+    *pos++ = tag;
+    pos = Varint::write(pos, Varint::zigzag(message.rumorId()));
+    pos = Varint::write(pos, static_cast<uint32_t>(message.age()));
+    if (tag & WireFormat::k_hasCount) {
+        pos = Varint::write(pos, static_cast<uint32_t>(message.count()));
+    }
+    if (tag & WireFormat::k_hasSample) {
+        for (int i = 0; i < 8; ++i) {
+            *pos++ = static_cast<uint8_t>(message.sizeSample() >> (8 * i));
+        }
+    }
+    m_buffer.insert(m_buffer.end(), bytes, pos);
+    maybeFlush();
+}
+
+void TraceRecorder::roundAdvanced(int toMember)
+{
+    putRecord(Record::ROUND);
+    putInt(toMember);
+    maybeFlush();
+}
+
+void TraceRecorder::rangeMessagesSet(bool enabled)
+{
+    putRecord(Record::RANGE_MESSAGES);
+    putInt(enabled ? 1 : 0);
+    maybeFlush();
+}
+
+void TraceRecorder::livenessTracked(int suspectAfterMisses, int probeInterval)
+{
+    putRecord(Record::TRACK_LIVENESS);
+    putInt(suspectAfterMisses);
+    putInt(probeInterval);
+    maybeFlush();
+}
+
+void TraceRecorder::sizeEstimated(int epochRounds)
+{
+    putRecord(Record::ESTIMATE_SIZE);
+    putInt(epochRounds);
+    maybeFlush();
+}
+
+void TraceRecorder::maxRumorsSet(size_t maxRumors)
+{
+    putRecord(Record::MAX_RUMORS);
+    putInt(static_cast<int>(std::min<size_t>(maxRumors, INT_MAX)));
+    maybeFlush();
+}
+
+void TraceRecorder::rumorsImported(const std::vector<StateTransfer::Range>& ranges)
+{
+    putRecord(Record::IMPORT_RUMORS);
+    putInt(static_cast<int>(ranges.size()));
+    for (const StateTransfer::Range& range : ranges) {
+        putInt(range.m_first);
+        putInt(range.m_count);
+        putInt(static_cast<int>(range.m_state));
+        putInt(range.m_age);
+        putInt(range.m_roundsInState);
+    }
+    maybeFlush();
+}
+
+void TraceRecorder::flush()
+{
+    if (!m_buffer.empty()) {
+        m_out.write(reinterpret_cast<const char*>(m_buffer.data()), static_cast<std::streamsize>(m_buffer.size()));
+        m_buffer.clear();
+    }
+    m_out.flush();
+}
+
+// PUBLIC CONST METHODS
+size_t TraceRecorder::numRecords() const
+{
+    return m_numRecords;
+}
+
+} // project namespace
@@ -0,0 +1,102 @@
+#ifndef RANDOMIZEDRUMORSPREADING_TRACERECORDER_H
+#define RANDOMIZEDRUMORSPREADING_TRACERECORDER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+#include "Message.h"
+#include "NetworkConfig.h"
+#include "StateTransfer.h"
+
+namespace RRS {
+
+/**
+ * Compact binary record of the inputs of one 'RumorMember', see 'RumorMember::record'. Replayed
+ * by a 'TraceReplayer', the inputs drive a fresh member through the same states and outputs.
+ *
+ * Header: the magic "RRST", uint8 version 'k_version', the member ID, the peer IDs and the network
+ * configuration. Then one record per input: a 'Record' byte followed by its fields. Integers are
+ * zigzag varints, received messages are encoded like a 'WireFormat' entry and
+ * the peer chosen in each round is recorded, so that random peer selection replays identically.
+ *
+ * Records are buffered and written to the stream in blocks. Not thread-safe, the member calls it
+ * with its mutex held.
+ */
+class TraceRecorder {
+  public:
+    // ENUMS
+    enum class Record : uint8_t {
+        ADD_RUMORS,      // first rumor ID, count
+        RECEIVED,        // sender, message
+        ROUND,           // chosen peer
+        RANGE_MESSAGES,  // enabled
+        TRACK_LIVENESS,  // suspect after misses, probe interval
+        ESTIMATE_SIZE,   // epoch rounds
+        MAX_RUMORS,      // maximum number of rumors
+        IMPORT_RUMORS,   // number of ranges, then first rumor ID, count, state, age, rounds in
+                         // state for each
+    };
+
+    // CONSTANTS
+    static const uint8_t k_magic[4];
+    static const uint8_t k_version = 1;
+
+  private:
+    // MEMBERS
+    std::ostream&        m_out;
+    std::vector<uint8_t> m_buffer;
+    size_t               m_numRecords;
+
+    // METHODS
+    void putInt(int value);
+
+    void putRecord(Record record);
+
+    // Write the buffer to the stream once it is large
+    void maybeFlush();
+
+  public:
+    // CONSTRUCTORS
+    explicit TraceRecorder(std::ostream& out);
+
+    TraceRecorder(const TraceRecorder& other) = delete;
+
+    TraceRecorder& operator=(const TraceRecorder& other) = delete;
+
+    // DESTRUCTOR
+    // Flush the buffered records
+    ~TraceRecorder();
+
+    // METHODS
+    // Write the header. Must be called once, before any record.
+    void start(int memberId, const std::vector<int>& peers, const NetworkConfig& networkConfig);
+
+    void rumorsAdded(int firstRumorId, size_t count);
+
+    void messageReceived(const Message& message, int fromPeer);
+
+    // A round was advanced and 'toMember' was chosen to receive its PUSH messages
+    void roundAdvanced(int toMember);
+
+    void rangeMessagesSet(bool enabled);
+
+    void livenessTracked(int suspectAfterMisses, int probeInterval);
+
+    void sizeEstimated(int epochRounds);
+
+    void maxRumorsSet(size_t maxRumors);
+
+    void rumorsImported(const std::vector<StateTransfer::Range>& ranges);
+
+    // Write the buffered records to the stream and flush it
+    void flush();
+
+    // CONST METHODS
+    size_t numRecords() const;
+};
+
+} // project namespace
+
+#endif //RANDOMIZEDRUMORSPREADING_TRACERECORDER_H
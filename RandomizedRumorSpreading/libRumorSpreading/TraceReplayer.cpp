@@ -0,0 +1,276 @@
+#include "TraceReplayer.h"
+
+#include <cstring>
+#include <iterator>
+
+#include "Varint.h"
+#include "WireFormat.h"
+
+namespace RRS {
+
+// PRIVATE METHODS
+bool TraceReplayer::readInt(int& value)
+{
+    uint32_t bits;
+    if (!Varint::read(m_pos, end(), bits)) {
+        return false;
+    }
+    value = Varint::unzigzag(bits);
+    return true;
+}
+
+bool TraceReplayer::readHeader()
+{
+    m_pos = m_trace.data();
+    if (m_trace.size() < sizeof(TraceRecorder::k_magic) + 1 ||
+        std::memcmp(m_pos, TraceRecorder::k_magic, sizeof(TraceRecorder::k_magic)) != 0 ||
+        m_pos[sizeof(TraceRecorder::k_magic)] != TraceRecorder::k_version) {
+        return false;
+    }
+    m_pos += sizeof(TraceRecorder::k_magic) + 1;
+
+    int numPeers;
+    if (!readInt(m_memberId) || !readInt(numPeers) || numPeers < 0) {
+        return false;
+    }
+    m_peers.insert(m_memberId);
+    for (int i = 0; i < numPeers; ++i) {
+        int peer;
+        if (!readInt(peer)) {
+            return false;
+        }
+        m_peers.insert(peer);
+    }
+
+    int networkSize;
+    int maxRoundsInB;
+    int maxRoundsInC;
+    int maxRoundsTotal;
+    if (!readInt(networkSize) || !readInt(maxRoundsInB) || !readInt(maxRoundsInC) ||
+        !readInt(maxRoundsTotal) || networkSize < static_cast<int>(m_peers.size())) {
+        return false;
+    }
+    m_networkConfig.reset(new NetworkConfig(static_cast<size_t>(networkSize), maxRoundsInB, maxRoundsInC, maxRoundsTotal));
+    m_start = static_cast<size_t>(m_pos - m_trace.data());
+    return true;
+}
+
+// PRIVATE CONST METHODS
+const uint8_t* TraceReplayer::end() const
+{
+    return m_trace.data() + m_trace.size();
+}
+
+// CONSTRUCTORS
+TraceReplayer::TraceReplayer(std::istream& in)
+: m_trace(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>())
+, m_start(0)
+, m_pos(nullptr)
+, m_valid(false)
+, m_failed(false)
+, m_memberId(-1)
+, m_peers()
+, m_networkConfig()
+, m_member()
+, m_nextPeer(-1)
+, m_lastRecord(TraceRecorder::Record::ADD_RUMORS)
+, m_lastOutput(-1, std::vector<Message>())
+, m_numRecords(0)
+, m_numRounds(0)
+, m_numMessages(0)
+, m_numOutputMessages(0)
+{
+    m_valid = readHeader();
+    m_failed = !m_valid;
+    if (m_valid) {
+        reset();
+    }
+}
+
+// PUBLIC METHODS
+bool TraceReplayer::step()
+{
+    if (!m_valid || m_failed || m_pos == end()) {
+        return false;
+    }
+
+    const uint8_t record = *m_pos++;
+    m_lastRecord = static_cast<TraceRecorder::Record>(record);
+    m_lastOutput.first = -1;
+    m_lastOutput.second.clear();
+
+    int first;
+    int second;
+    switch (m_lastRecord) {
+        case TraceRecorder::Record::ADD_RUMORS:
+            if (!readInt(first) || !readInt(second) || second < 0) {
+                m_failed = true;
+                return false;
+            }
+            if (second == 1) {
+                m_member->addRumor(first);
+            }
+            else {
+                m_member->addRumors(first, static_cast<size_t>(second));
+            }
+            break;
+
+        case TraceRecorder::Record::RECEIVED: {
+            Message message;
+            int nextId = 0;
+            if (!readInt(first) || !WireFormat::readEntry(m_pos, end(), nextId, message)) {
+                m_failed = true;
+                return false;
+            }
+            ++m_numMessages;
+            m_lastOutput = m_member->receivedMessage(message, first);
+            m_numOutputMessages += m_lastOutput.second.size();
+            break;
+        }
+
+        case TraceRecorder::Record::ROUND:
+            if (!readInt(m_nextPeer)) {
+                m_failed = true;
+                return false;
+            }
+            ++m_numRounds;
+            m_lastOutput = m_member->advanceRound();
+            if (m_lastOutput.first != m_nextPeer) {
+                m_failed = true;
+                return false;
+            }
+            m_numOutputMessages += m_lastOutput.second.size();
+            break;
+
+        case TraceRecorder::Record::RANGE_MESSAGES:
+            if (!readInt(first)) {
+                m_failed = true;
+                return false;
+            }
+            m_member->setRangeMessages(first != 0);
+            break;
+
+        case TraceRecorder::Record::TRACK_LIVENESS:
+            if (!readInt(first) || !readInt(second)) {
+                m_failed = true;
+                return false;
+            }
+            m_member->trackLiveness(first, second);
+            break;
+
+        case TraceRecorder::Record::ESTIMATE_SIZE:
+            if (!readInt(first)) {
+                m_failed = true;
+                return false;
+            }
+            m_member->estimateNetworkSize(first);
+            break;
+
+        case TraceRecorder::Record::MAX_RUMORS:
+            if (!readInt(first) || first < 0) {
+                m_failed = true;
+                return false;
+            }
+            m_member->setMaxRumors(static_cast<size_t>(first));
+            break;
+
+        case TraceRecorder::Record::IMPORT_RUMORS: {
+            // Every range takes at least 5 bytes
+            if (!readInt(first) || first < 0 || static_cast<size_t>(first) > static_cast<size_t>(end() - m_pos) / 5) {
+                m_failed = true;
+                return false;
+            }
+            std::vector<StateTransfer::Range> ranges(static_cast<size_t>(first));
+            for (StateTransfer::Range& range : ranges) {
+                if (!readInt(range.m_first) || !readInt(range.m_count) || !readInt(second) ||
+                    !readInt(range.m_age) || !readInt(range.m_roundsInState)) {
+                    m_failed = true;
+                    return false;
+                }
+                range.m_state = static_cast<RumorStateMachine::State>(second);
+            }
+            m_member->importRumors(ranges);
+            break;
+        }
+
+        default:
+            m_failed = true;
+            return false;
+    }
+
+    ++m_numRecords;
+    return true;
+}
+
+size_t TraceReplayer::run()
+{
+    const size_t numRecords = m_numRecords;
+    while (step()) {
+    }
+    return m_numRecords - numRecords;
+}
+
+void TraceReplayer::reset()
+{
+    if (!m_valid) {
+        return;
+    }
+    m_pos = m_trace.data() + m_start;
+    m_failed = false;
+    m_member.reset(new RumorMember(m_peers, *m_networkConfig, [this]() { return m_nextPeer; }, m_memberId));
+    m_nextPeer = -1;
+    m_lastOutput.first = -1;
+    m_lastOutput.second.clear();
+    m_numRecords = 0;
+    m_numRounds = 0;
+    m_numMessages = 0;
+    m_numOutputMessages = 0;
+}
+
+// PUBLIC CONST METHODS
+bool TraceReplayer::valid() const
+{
+    return m_valid;
+}
+
+bool TraceReplayer::failed() const
+{
+    return m_failed;
+}
+
+const RumorMember& TraceReplayer::member() const
+{
+    return *m_member;
+}
+
+TraceRecorder::Record TraceReplayer::lastRecord() const
+{
+    return m_lastRecord;
+}
+
+const std::pair<int, std::vector<Message>>& TraceReplayer::lastOutput() const
+{
+    return m_lastOutput;
+}
+
+size_t TraceReplayer::numRecords() const
+{
+    return m_numRecords;
+}
+
+size_t TraceReplayer::numRounds() const
+{
+    return m_numRounds;
+}
+
+size_t TraceReplayer::numMessages() const
+{
+    return m_numMessages;
+}
+
+size_t TraceReplayer::numOutputMessages() const
+{
+    return m_numOutputMessages;
+}
+
+} // project namespace
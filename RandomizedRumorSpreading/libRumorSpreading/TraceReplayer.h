@@ -0,0 +1,101 @@
+#ifndef RANDOMIZEDRUMORSPREADING_TRACEREPLAYER_H
+#define RANDOMIZEDRUMORSPREADING_TRACEREPLAYER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "Message.h"
+#include "RumorMember.h"
+#include "TraceRecorder.h"
+
+namespace RRS {
+
+/**
+ * Drives a fresh 'RumorMember' with the inputs of a trace written by a 'TraceRecorder'.
+ *
+ * The member is built from the header of the trace and chooses, in every round, the peer chosen
+ * by the recorded member. Given the same inputs the member is deterministic, so each record yields
+ * the output the recorded member produced.
+ *
+ * The whole trace is read into memory first, so that replaying it only measures the member.
+ */
+class TraceReplayer {
+  private:
+    // MEMBERS
+    std::vector<uint8_t>                 m_trace;
+    size_t                               m_start;       // Offset of the first record
+    const uint8_t*                       m_pos;
+    bool                                 m_valid;
+    bool                                 m_failed;
+    int                                  m_memberId;
+    std::unordered_set<int>              m_peers;
+    std::unique_ptr<NetworkConfig>       m_networkConfig;
+    std::unique_ptr<RumorMember>         m_member;
+    int                                  m_nextPeer;
+    TraceRecorder::Record                m_lastRecord;
+    std::pair<int, std::vector<Message>> m_lastOutput;
+    size_t                               m_numRecords;
+    size_t                               m_numRounds;
+    size_t                               m_numMessages;
+    size_t                               m_numOutputMessages;
+
+    // METHODS
+    bool readInt(int& value);
+
+    bool readHeader();
+
+    // CONST METHODS
+    const uint8_t* end() const;
+
+  public:
+    // CONSTRUCTORS
+    // Read the whole trace from 'in'. Check 'valid()' before replaying it.
+    explicit TraceReplayer(std::istream& in);
+
+    TraceReplayer(const TraceReplayer& other) = delete;
+
+    TraceReplayer& operator=(const TraceReplayer& other) = delete;
+
+    // METHODS
+    // Replay the next record. Return false at the end of the trace or if the record is malformed
+    // or diverges from the recording, in which case 'failed()' is set.
+    bool step();
+
+    // Replay the remaining records, return the number replayed
+    size_t run();
+
+    // Start over with a fresh member and zeroed counters
+    void reset();
+
+    // CONST METHODS
+    // The header was read
+    bool valid() const;
+
+    // The trace was truncated, malformed or diverged
+    bool failed() const;
+
+    const RumorMember& member() const;
+
+    // Type of the last replayed record
+    TraceRecorder::Record lastRecord() const;
+
+    // Output of the last replayed 'RECEIVED' or 'ROUND' record, empty for the others
+    const std::pair<int, std::vector<Message>>& lastOutput() const;
+
+    size_t numRecords() const;
+
+    size_t numRounds() const;
+
+    size_t numMessages() const;
+
+    // Messages returned by the member
+    size_t numOutputMessages() const;
+};
+
+} // project namespace
+
+#endif //RANDOMIZEDRUMORSPREADING_TRACEREPLAYER_H
@@ -0,0 +1,70 @@
+#ifndef RANDOMIZEDRUMORSPREADING_VARINT_H
+#define RANDOMIZEDRUMORSPREADING_VARINT_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace RRS {
+
+// LEB128 encoding of 32-bit integers, 7 bits per byte, shared by the binary formats
+class Varint {
+  public:
+    // CONSTANTS
+    static const size_t k_maxSize = 5;
+
+    // STATIC METHODS
+    // Map small negative and positive values to small unsigned ones
+    static uint32_t zigzag(int32_t value)
+    {
+        const uint32_t bits = static_cast<uint32_t>(value);
+        return (bits << 1) ^ static_cast<uint32_t>(-static_cast<int32_t>(bits >> 31));
+    }
+
+    static int32_t unzigzag(uint32_t value)
+    {
+        return static_cast<int32_t>((value >> 1) ^ static_cast<uint32_t>(-static_cast<int32_t>(value & 1)));
+    }
+
+    static size_t size(uint32_t value)
+    {
+        size_t size = 1;
+        while (value >= 0x80) {
+            value >>= 7;
+            ++size;
+        }
+        return size;
+    }
+
+    // Write 'value' at 'out', which must hold 'k_maxSize' bytes. Return the end of the encoding.
+    static uint8_t* write(uint8_t* out, uint32_t value)
+    {
+        while (value >= 0x80) {
+            *out++ = static_cast<uint8_t>(value | 0x80);
+            value >>= 7;
+        }
+        *out++ = static_cast<uint8_t>(value);
+        return out;
+    }
+
+    // Read a value at 'pos', before 'end', and advance 'pos'. Return false if it is truncated or
+    // does not fit 32 bits.
+    static bool read(const uint8_t*& pos, const uint8_t* end, uint32_t& value)
+    {
+        value = 0;
+        for (int shift = 0; shift < 35 && pos < end; shift += 7) {
+            const uint8_t byte = *pos++;
+            if (shift == 28 && byte > 0x0f) {
+                return false;
+            }
+            value |= static_cast<uint32_t>(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+} // project namespace
+
+#endif //RANDOMIZEDRUMORSPREADING_VARINT_H
@@ -0,0 +1,260 @@
+#include "WireFormat.h"
+
+#include "Varint.h"
+
+namespace RRS {
+
+namespace {
+
+const uint64_t k_checksumPrime = 0x100000001b3ULL;
+
+// Tag bits and continuation bits of two consecutive short entries (tag, 1-byte ID delta, 1-byte
+// age) in a little endian word. A short entry has neither a count nor a sample.
+const uint64_t k_shortPairMask = 0x00008080fc8080fcULL;
+
+void storeLE(uint8_t* out, uint64_t value, int numBytes)
+{
+    for (int i = 0; i < numBytes; ++i) {
+        out[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+uint64_t loadLE(const uint8_t* in, int numBytes)
+{
+    uint64_t value = 0;
+    for (int i = 0; i < numBytes; ++i) {
+        value |= static_cast<uint64_t>(in[i]) << (8 * i);
+    }
+    return value;
+}
+
+// Continue the checksum state 'h' over 'size' bytes, eight at a time
+uint64_t mixWords(uint64_t h, const uint8_t* data, size_t size)
+{
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        h = (h ^ loadLE(data + i, 8)) * k_checksumPrime;
+    }
+    if (i < size) {
+        h = (h ^ loadLE(data + i, static_cast<int>(size - i))) * k_checksumPrime;
+    }
+    return h;
+}
+
+uint32_t frameChecksum(const uint8_t* frame, size_t size)
+{
+    uint64_t h = mixWords(size * k_checksumPrime, frame, 12);
+    h = mixWords(h, frame + WireFormat::k_headerSize, size - WireFormat::k_headerSize);
+    return static_cast<uint32_t>(h ^ (h >> 32));
+}
+
+uint32_t zigzag(int value, int expected)
+{
+    return Varint::zigzag(static_cast<int32_t>(static_cast<uint32_t>(value) - static_cast<uint32_t>(expected)));
+}
+
+int unzigzag(uint32_t value, int expected)
+{
+    return static_cast<int>(static_cast<uint32_t>(expected) + static_cast<uint32_t>(Varint::unzigzag(value)));
+}
+
+int nextRumorId(int rumorId, int count)
+{
+    return static_cast<int>(static_cast<uint32_t>(rumorId) + static_cast<uint32_t>(count));
+}
+
+bool isMessageType(uint8_t type)
+{
+    return type == static_cast<uint8_t>(Message::Type::PUSH) || type == static_cast<uint8_t>(Message::Type::PULL);
+}
+
+// The rumors '[rumorId, rumorId + count)' do not go past the largest ID
+bool fitsRange(int rumorId, uint32_t count)
+{
+    return static_cast<int64_t>(rumorId) + count <= INT32_MAX;
+}
+
+} // anonymous namespace
+
+// CONSTANTS
+const uint16_t WireFormat::k_magic;
+const uint8_t WireFormat::k_version;
+const size_t WireFormat::k_headerSize;
+const size_t WireFormat::k_maxEntrySize;
+const uint8_t WireFormat::k_typeMask;
+const uint8_t WireFormat::k_hasCount;
+const uint8_t WireFormat::k_hasSample;
+
+// STATIC METHODS
+size_t WireFormat::maxFrameSize(size_t numMessages)
+{
+    return k_headerSize + numMessages * k_maxEntrySize;
+}
+
+size_t WireFormat::frameSize(const Message* messages, size_t count)
+{
+    size_t size = k_headerSize;
+    int expectedId = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const Message& message = messages[i];
+        size += 1 + Varint::size(zigzag(message.rumorId(), expectedId)) +
+                Varint::size(static_cast<uint32_t>(message.age()));
+        if (message.count() != 1) {
+            size += Varint::size(static_cast<uint32_t>(message.count()));
+        }
+        if (message.sizeSample() != 0) {
+            size += 8;
+        }
+        expectedId = nextRumorId(message.rumorId(), message.count());
+    }
+    return size;
+}
+
+size_t WireFormat::encode(int fromMember, const Message* messages, size_t count, char* out)
+{
+    uint8_t* const frame = reinterpret_cast<uint8_t*>(out);
+    uint8_t* pos = frame + k_headerSize;
+    int expectedId = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const Message& message = messages[i];
+        uint8_t tag = static_cast<uint8_t>(message.type()) & k_typeMask;
+        if (message.count() != 1) {
+            tag |= k_hasCount;
+        }
+        if (message.sizeSample() != 0) {
+            tag |= k_hasSample;
+        }
+
+        *pos++ = tag;
+        pos = Varint::write(pos, zigzag(message.rumorId(), expectedId));
+        pos = Varint::write(pos, static_cast<uint32_t>(message.age()));
+        if (tag & k_hasCount) {
+            pos = Varint::write(pos, static_cast<uint32_t>(message.count()));
+        }
+        if (tag & k_hasSample) {
+            storeLE(pos, message.sizeSample(), 8);
+            pos += 8;
+        }
+        expectedId = nextRumorId(message.rumorId(), message.count());
+    }
+
+    const size_t size = static_cast<size_t>(pos - frame);
+    storeLE(frame, k_magic, 2);
+    frame[2] = k_version;
+    frame[3] = 0;
+    storeLE(frame + 4, static_cast<uint32_t>(fromMember), 4);
+    storeLE(frame + 8, static_cast<uint32_t>(count), 4);
+    storeLE(frame + 12, frameChecksum(frame, size), 4);
+    return size;
+}
+
+bool WireFormat::checkHeader(const char* data, size_t size, int& fromMember, uint32_t& count)
+{
+    const uint8_t* frame = reinterpret_cast<const uint8_t*>(data);
+    if (size < k_headerSize || loadLE(frame, 2) != k_magic || frame[2] != k_version) {
+        return false;
+    }
+
+    count = static_cast<uint32_t>(loadLE(frame + 8, 4));
+    // Every entry takes at least 3 bytes
+    if ((size - k_headerSize) / 3 < count || loadLE(frame + 12, 4) != frameChecksum(frame, size)) {
+        return false;
+    }
+
+    fromMember = static_cast<int>(static_cast<uint32_t>(loadLE(frame + 4, 4)));
+    return true;
+}
+
+bool WireFormat::readEntry(const uint8_t*& pos, const uint8_t* end, int& nextId, Message& message)
+{
+    if (pos >= end) {
+        return false;
+    }
+
+    // Short entry: single rumor, no sample, one byte varints
+    if (end - pos >= 3 && isMessageType(pos[0]) && ((pos[1] | pos[2]) & 0x80) == 0) {
+        const int rumorId = unzigzag(pos[1], nextId);
+        if (!fitsRange(rumorId, 1)) {
+            return false;
+        }
+        message = Message(static_cast<Message::Type>(pos[0]), rumorId, pos[2]);
+        nextId = nextRumorId(rumorId, 1);
+        pos += 3;
+        return true;
+    }
+
+    const uint8_t tag = *pos++;
+    const uint8_t type = tag & k_typeMask;
+    if ((tag & ~(k_typeMask | k_hasCount | k_hasSample)) != 0 || !isMessageType(type)) {
+        return false;
+    }
+
+    uint32_t id;
+    uint32_t age;
+    uint32_t count = 1;
+    if (!Varint::read(pos, end, id) || !Varint::read(pos, end, age) || age > INT32_MAX) {
+        return false;
+    }
+    if ((tag & k_hasCount) && (!Varint::read(pos, end, count) || count == 0 || count > INT32_MAX)) {
+        return false;
+    }
+
+    uint64_t sample = 0;
+    if (tag & k_hasSample) {
+        if (end - pos < 8) {
+            return false;
+        }
+        sample = loadLE(pos, 8);
+        pos += 8;
+    }
+
+    const int rumorId = unzigzag(id, nextId);
+    if (!fitsRange(rumorId, count)) {
+        return false;
+    }
+    message = Message(static_cast<Message::Type>(type), rumorId, static_cast<int>(age), static_cast<int>(count));
+    message.setSizeSample(sample);
+    nextId = nextRumorId(rumorId, static_cast<int>(count));
+    return true;
+}
+
+bool WireFormat::decode(const char* data, size_t size, int& fromMember, std::vector<Message>& messages)
+{
+    uint32_t count;
+    if (!checkHeader(data, size, fromMember, count)) {
+        return false;
+    }
+
+    messages.resize(count);
+    const uint8_t* pos = reinterpret_cast<const uint8_t*>(data) + k_headerSize;
+    const uint8_t* const end = reinterpret_cast<const uint8_t*>(data) + size;
+    Message* out = messages.data();
+    Message* const outEnd = out + count;
+    int nextId = 0;
+    while (out != outEnd) {
+        // Fast path: one load checks that the next two entries are short, the common case of a
+        // batch of single rumors with small ages
+        if (end - pos >= 8 && outEnd - out >= 2) {
+            const uint64_t word = loadLE(pos, 8);
+            if ((word & k_shortPairMask) == 0 && isMessageType(word & k_typeMask) &&
+                isMessageType((word >> 24) & k_typeMask)) {
+                for (int i = 0; i < 2; ++i, pos += 3) {
+                    const int rumorId = unzigzag(pos[1], nextId);
+                    if (!fitsRange(rumorId, 1)) {
+                        return false;
+                    }
+                    *out++ = Message(static_cast<Message::Type>(pos[0]), rumorId, pos[2]);
+                    nextId = nextRumorId(rumorId, 1);
+                }
+                continue;
+            }
+        }
+
+        if (!readEntry(pos, end, nextId, *out++)) {
+            return false;
+        }
+    }
+    return pos == end;
+}
+
+} // project namespace
@@ -0,0 +1,70 @@
+#ifndef RANDOMIZEDRUMORSPREADING_WIREFORMAT_H
+#define RANDOMIZEDRUMORSPREADING_WIREFORMAT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Message.h"
+
+namespace RRS {
+
+/**
+ * Versioned encoding of a batch of messages sent by one member, independent of the host
+ * architecture. All the integers are little endian.
+ *
+ * Header, 'k_headerSize' bytes:
+ *   uint16 magic 'k_magic', uint8 version 'k_version', uint8 flags (0),
+ *   int32 sender ID, uint32 number of entries, uint32 checksum
+ *
+ * Then one entry per message:
+ *   uint8 tag: bits 0-1 the type, bit 2 set if a count follows, bit 3 set if a size sample follows
+ *   varint zigzag(rumor ID - expected ID), the expected ID being the end of the previous
+ *          message's range, 0 for the first one
+ *   varint age
+ *   varint count, if not 1
+ *   uint64 size sample, if not 0
+ *
+ * A push of consecutive rumors with small ages takes 3 bytes. The checksum covers the first 12
+ * bytes of the header and all the entries.
+ */
+class WireFormat {
+  public:
+    // CONSTANTS
+    static const uint16_t k_magic = 0x5252;
+    static const uint8_t k_version = 1;
+    static const size_t k_headerSize = 16;
+    static const size_t k_maxEntrySize = 1 + 5 + 5 + 5 + 8;
+
+    // Tag bits
+    static const uint8_t k_typeMask = 0x03;
+    static const uint8_t k_hasCount = 0x04;
+    static const uint8_t k_hasSample = 0x08;
+
+    // STATIC METHODS
+    // Upper bound of the size of a frame of 'numMessages' messages.
+    static size_t maxFrameSize(size_t numMessages);
+
+    // Exact number of bytes 'encode' writes for these messages.
+    static size_t frameSize(const Message* messages, size_t count);
+
+    // Encode 'count' messages starting at 'messages' into 'out', which must hold
+    // 'frameSize(messages, count)' bytes. Return the number of bytes written.
+    static size_t encode(int fromMember, const Message* messages, size_t count, char* out);
+
+    // Decode the frame of 'size' bytes at 'data' into 'messages', reusing its capacity. Return
+    // false if the frame is malformed, 'messages' is then unspecified.
+    static bool decode(const char* data, size_t size, int& fromMember, std::vector<Message>& messages);
+
+    // Check the header and the checksum of a frame. On success set the sender and the number of
+    // entries.
+    static bool checkHeader(const char* data, size_t size, int& fromMember, uint32_t& count);
+
+    // Decode the entry at 'pos', which must be before 'end', advance 'pos' and 'nextId'. Return
+    // false if the entry is malformed.
+    static bool readEntry(const uint8_t*& pos, const uint8_t* end, int& nextId, Message& message);
+};
+
+} // project namespace
+
+#endif //RANDOMIZEDRUMORSPREADING_WIREFORMAT_H
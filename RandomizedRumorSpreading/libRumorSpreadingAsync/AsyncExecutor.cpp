@@ -0,0 +1,99 @@
+#include "AsyncExecutor.h"
+
+namespace RRS {
+
+// CONSTRUCTORS
+AsyncWaitList::AsyncWaitList()
+: m_head(nullptr)
+, m_tail(nullptr)
+{
+}
+
+// PUBLIC METHODS
+void AsyncWaitList::pushBack(AsyncWaiter* waiter)
+{
+    waiter->m_next = nullptr;
+    if (m_tail) {
+        m_tail->m_next = waiter;
+    }
+    else {
+        m_head = waiter;
+    }
+    m_tail = waiter;
+}
+
+AsyncWaiter* AsyncWaitList::popFront()
+{
+    AsyncWaiter* waiter = m_head;
+    if (waiter) {
+        m_head = waiter->m_next;
+        if (!m_head) {
+            m_tail = nullptr;
+        }
+        waiter->m_next = nullptr;
+    }
+    return waiter;
+}
+
+AsyncWaiter* AsyncWaitList::takeAll()
+{
+    AsyncWaiter* chain = m_head;
+    m_head = nullptr;
+    m_tail = nullptr;
+    return chain;
+}
+
+// PUBLIC CONST METHODS
+bool AsyncWaitList::empty() const
+{
+    return m_head == nullptr;
+}
+
+// CONSTRUCTORS
+AsyncExecutor::AsyncExecutor()
+: m_ready()
+, m_numResumed(0)
+{
+}
+
+// PUBLIC METHODS
+void AsyncExecutor::post(AsyncWaiter* waiter)
+{
+    m_ready.pushBack(waiter);
+}
+
+bool AsyncExecutor::runOne()
+{
+    AsyncWaiter* waiter = m_ready.popFront();
+    if (!waiter) {
+        return false;
+    }
+
+    // The node may be re-linked or destroyed by the resumed coroutine, copy the handle first
+    std::coroutine_handle<> handle = waiter->m_handle;
+    ++m_numResumed;
+    handle.resume();
+    return true;
+}
+
+size_t AsyncExecutor::run()
+{
+    size_t count = 0;
+    while (runOne()) {
+        ++count;
+    }
+    return count;
+}
+
+// PUBLIC CONST METHODS
+bool AsyncExecutor::empty() const
+{
+    return m_ready.empty();
+}
+
+size_t AsyncExecutor::numResumed() const
+{
+    return m_numResumed;
+}
+
+} // project namespace
@@ -0,0 +1,92 @@
+#ifndef RANDOMIZEDRUMORSPREADING_ASYNCEXECUTOR_H
+#define RANDOMIZEDRUMORSPREADING_ASYNCEXECUTOR_H
+
+#include <coroutine>
+#include <cstddef>
+
+namespace RRS {
+
+/**
+ * Intrusive list node for a suspended coroutine. Awaiters embed this node, so it lives inside the
+ * coroutine frame and suspending never allocates. A node is linked into at most one list at a
+ * time: either a wait list owned by an 'AsyncMember' or the ready queue of an 'AsyncExecutor'.
+ */
+struct AsyncWaiter {
+    std::coroutine_handle<> m_handle;
+    AsyncWaiter*            m_next = nullptr;
+
+    AsyncWaiter() = default;
+
+    // Linked nodes are referenced by address, they must never be copied or moved.
+    AsyncWaiter(const AsyncWaiter& other) = delete;
+
+    AsyncWaiter& operator=(const AsyncWaiter& other) = delete;
+};
+
+// FIFO list of 'AsyncWaiter' nodes.
+class AsyncWaitList {
+  private:
+    // MEMBERS
+    AsyncWaiter* m_head;
+    AsyncWaiter* m_tail;
+
+  public:
+    // CONSTRUCTORS
+    AsyncWaitList();
+
+    AsyncWaitList(const AsyncWaitList& other) = delete;
+
+    AsyncWaitList& operator=(const AsyncWaitList& other) = delete;
+
+    // METHODS
+    void pushBack(AsyncWaiter* waiter);
+
+    // Return the first waiter or 'nullptr' if the list is empty.
+    AsyncWaiter* popFront();
+
+    // Remove all waiters and return them as a singly linked chain.
+    AsyncWaiter* takeAll();
+
+    // CONST METHODS
+    bool empty() const;
+};
+
+/**
+ * Single-threaded executor. Coroutines that become runnable are queued here and resumed, in FIFO
+ * order, by whichever thread calls 'run()' or 'runOne()'. None of the methods are thread-safe:
+ * all members driven by one executor must be driven from the same thread.
+ */
+class AsyncExecutor {
+  private:
+    // MEMBERS
+    AsyncWaitList m_ready;
+    size_t        m_numResumed;
+
+  public:
+    // CONSTRUCTORS
+    AsyncExecutor();
+
+    AsyncExecutor(const AsyncExecutor& other) = delete;
+
+    AsyncExecutor& operator=(const AsyncExecutor& other) = delete;
+
+    // METHODS
+    // Queue the coroutine referenced by 'waiter' to be resumed.
+    void post(AsyncWaiter* waiter);
+
+    // Resume a single queued coroutine. Return false if nothing was queued.
+    bool runOne();
+
+    // Resume queued coroutines until the queue is empty. Return the number of resumptions.
+    size_t run();
+
+    // CONST METHODS
+    bool empty() const;
+
+    // Total number of coroutine resumptions performed by this executor.
+    size_t numResumed() const;
+};
+
+} // project namespace
+
+#endif //RANDOMIZEDRUMORSPREADING_ASYNCEXECUTOR_H
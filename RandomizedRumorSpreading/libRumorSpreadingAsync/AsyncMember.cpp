@@ -0,0 +1,212 @@
+#include "AsyncMember.h"
+
+namespace RRS {
+
+// AWAITERS
+AsyncMember::RoundAwaiter::RoundAwaiter(AsyncMember& owner)
+: m_owner(owner)
+, m_result(-1, std::vector<Message>())
+{
+}
+
+bool AsyncMember::RoundAwaiter::await_ready() const noexcept
+{
+    return m_owner.m_closed;
+}
+
+void AsyncMember::RoundAwaiter::await_suspend(std::coroutine_handle<> handle)
+{
+    m_handle = handle;
+    m_owner.m_roundWaiters.pushBack(this);
+}
+
+AsyncMember::Outbound AsyncMember::RoundAwaiter::await_resume()
+{
+    return std::move(m_result);
+}
+
+AsyncMember::ReceiveAwaiter::ReceiveAwaiter(AsyncMember& owner)
+: m_owner(owner)
+, m_result()
+{
+}
+
+bool AsyncMember::ReceiveAwaiter::await_ready()
+{
+    if (!m_owner.m_inbox.empty()) {
+        m_result = m_owner.m_inbox.front();
+        m_owner.m_inbox.pop_front();
+        return true;
+    }
+    return m_owner.m_closed;
+}
+
+void AsyncMember::ReceiveAwaiter::await_suspend(std::coroutine_handle<> handle)
+{
+    m_handle = handle;
+    m_owner.m_receiveWaiters.pushBack(this);
+}
+
+AsyncMember::Inbound AsyncMember::ReceiveAwaiter::await_resume()
+{
+    return m_result;
+}
+
+AsyncMember::OldAwaiter::OldAwaiter(AsyncMember& owner, int rumorId)
+: m_owner(owner)
+, m_rumorId(rumorId)
+, m_known(false)
+{
+}
+
+bool AsyncMember::OldAwaiter::await_ready() const
+{
+    return m_owner.m_closed || m_owner.m_member.isOld(m_rumorId);
+}
+
+void AsyncMember::OldAwaiter::await_suspend(std::coroutine_handle<> handle)
+{
+    m_handle = handle;
+    m_known = m_owner.m_member.rumorExists(m_rumorId);
+    m_owner.m_oldWaiters.pushBack(this);
+}
+
+bool AsyncMember::OldAwaiter::await_resume() const
+{
+    return m_owner.m_member.isOld(m_rumorId);
+}
+
+// PRIVATE METHODS
+void AsyncMember::notifyOldWaiters()
+{
+    AsyncWaiter* chain = m_oldWaiters.takeAll();
+    while (chain) {
+        AsyncWaiter* next = chain->m_next;
+        OldAwaiter* awaiter = static_cast<OldAwaiter*>(chain);
+        const bool exists = m_member.rumorExists(awaiter->m_rumorId);
+        if (m_member.isOld(awaiter->m_rumorId) || (awaiter->m_known && !exists)) {
+            m_executor.post(awaiter);
+        }
+        else {
+            awaiter->m_known = exists;
+            m_oldWaiters.pushBack(awaiter);
+        }
+        chain = next;
+    }
+}
+
+void AsyncMember::wakeAll(AsyncWaitList& waiters)
+{
+    AsyncWaiter* chain = waiters.takeAll();
+    while (chain) {
+        AsyncWaiter* next = chain->m_next;
+        m_executor.post(chain);
+        chain = next;
+    }
+}
+
+// CONSTRUCTORS
+AsyncMember::AsyncMember(RumorMember& member, AsyncExecutor& executor)
+: m_member(member)
+, m_executor(executor)
+, m_roundWaiters()
+, m_receiveWaiters()
+, m_oldWaiters()
+, m_inbox()
+, m_closed(false)
+{
+}
+
+// PUBLIC METHODS
+void AsyncMember::tick()
+{
+    if (m_closed) {
+        return;
+    }
+
+    Outbound result = m_member.advanceRound();
+
+    // Every waiter gets its own copy, the last one takes ownership of the result
+    AsyncWaiter* chain = m_roundWaiters.takeAll();
+    while (chain) {
+        AsyncWaiter* next = chain->m_next;
+        RoundAwaiter* awaiter = static_cast<RoundAwaiter*>(chain);
+        if (next) {
+            awaiter->m_result = result;
+        }
+        else {
+            awaiter->m_result = std::move(result);
+        }
+        m_executor.post(awaiter);
+        chain = next;
+    }
+
+    notifyOldWaiters();
+}
+
+void AsyncMember::deliver(const Message& message, int fromMember)
+{
+    if (m_closed) {
+        return;
+    }
+
+    AsyncWaiter* waiter = m_receiveWaiters.popFront();
+    if (waiter) {
+        ReceiveAwaiter* awaiter = static_cast<ReceiveAwaiter*>(waiter);
+        awaiter->m_result.m_message = message;
+        awaiter->m_result.m_fromMember = fromMember;
+        m_executor.post(awaiter);
+    }
+    else {
+        m_inbox.push_back({message, fromMember});
+    }
+}
+
+AsyncMember::Outbound AsyncMember::handle(const Inbound& inbound)
+{
+    Outbound result = m_member.receivedMessage(inbound.m_message, inbound.m_fromMember);
+    notifyOldWaiters();
+    return result;
+}
+
+void AsyncMember::close()
+{
+    m_closed = true;
+    m_inbox.clear();
+    wakeAll(m_roundWaiters);
+    wakeAll(m_receiveWaiters);
+    wakeAll(m_oldWaiters);
+}
+
+AsyncMember::RoundAwaiter AsyncMember::nextRound()
+{
+    return RoundAwaiter(*this);
+}
+
+AsyncMember::ReceiveAwaiter AsyncMember::receive()
+{
+    return ReceiveAwaiter(*this);
+}
+
+AsyncMember::OldAwaiter AsyncMember::untilOld(int rumorId)
+{
+    return OldAwaiter(*this, rumorId);
+}
+
+RumorMember& AsyncMember::member()
+{
+    return m_member;
+}
+
+// PUBLIC CONST METHODS
+bool AsyncMember::closed() const
+{
+    return m_closed;
+}
+
+size_t AsyncMember::numQueued() const
+{
+    return m_inbox.size();
+}
+
+} // project namespace
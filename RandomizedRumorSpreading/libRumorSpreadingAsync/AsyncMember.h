@@ -0,0 +1,148 @@
+#ifndef RANDOMIZEDRUMORSPREADING_ASYNCMEMBER_H
+#define RANDOMIZEDRUMORSPREADING_ASYNCMEMBER_H
+
+#include <coroutine>
+#include <deque>
+#include <utility>
+#include <vector>
+
+#include <Message.h>
+#include <RumorMember.h>
+
+#include "AsyncExecutor.h"
+
+namespace RRS {
+
+/**
+ * Coroutine front-end for a 'RumorMember'.
+ *
+ * The owner of the event loop calls 'tick()' once per round and 'deliver()' for every message that
+ * arrives from the network. Coroutines running on the associated 'AsyncExecutor' consume those
+ * events with 'co_await nextRound()', 'co_await receive()' and 'co_await untilOld(rumorId)'.
+ * Awaiters keep their state inside the coroutine frame, so awaiting never allocates.
+ *
+ * Like the executor, an 'AsyncMember' must only be used from the executor's thread. After
+ * 'close()' every pending and future await completes immediately with an empty result.
+ */
+class AsyncMember {
+  public:
+    // TYPES
+    typedef std::pair<int, std::vector<Message>> Outbound;
+
+    struct Inbound {
+        Message m_message;
+        int     m_fromMember = -1;  // -1 when the member was closed
+    };
+
+    // Result of 'co_await nextRound()': the target member and the PUSH messages of the round.
+    class RoundAwaiter : public AsyncWaiter {
+      private:
+        friend class AsyncMember;
+
+        AsyncMember& m_owner;
+        Outbound     m_result;
+
+      public:
+        explicit RoundAwaiter(AsyncMember& owner);
+
+        bool await_ready() const noexcept;
+
+        void await_suspend(std::coroutine_handle<> handle);
+
+        Outbound await_resume();
+    };
+
+    // Result of 'co_await receive()': the next message delivered to this member.
+    class ReceiveAwaiter : public AsyncWaiter {
+      private:
+        friend class AsyncMember;
+
+        AsyncMember& m_owner;
+        Inbound      m_result;
+
+      public:
+        explicit ReceiveAwaiter(AsyncMember& owner);
+
+        bool await_ready();
+
+        void await_suspend(std::coroutine_handle<> handle);
+
+        Inbound await_resume();
+    };
+
+    // Result of 'co_await untilOld(rumorId)': true once the rumor is OLD locally, false if closed
+    // or if the rumor was evicted before becoming OLD, see 'RumorMember::setMaxRumors'.
+    class OldAwaiter : public AsyncWaiter {
+      private:
+        friend class AsyncMember;
+
+        AsyncMember& m_owner;
+        int          m_rumorId;
+        bool         m_known;    // The rumor was seen at the member while waiting
+
+      public:
+        OldAwaiter(AsyncMember& owner, int rumorId);
+
+        bool await_ready() const;
+
+        void await_suspend(std::coroutine_handle<> handle);
+
+        bool await_resume() const;
+    };
+
+  private:
+    // MEMBERS
+    RumorMember&        m_member;
+    AsyncExecutor&      m_executor;
+    AsyncWaitList       m_roundWaiters;
+    AsyncWaitList       m_receiveWaiters;
+    AsyncWaitList       m_oldWaiters;
+    std::deque<Inbound> m_inbox;
+    bool                m_closed;
+
+    // METHODS
+    // Resume the coroutines waiting for rumors that became OLD or were evicted.
+    void notifyOldWaiters();
+
+    // Resume every coroutine in 'waiters' without touching their results.
+    void wakeAll(AsyncWaitList& waiters);
+
+  public:
+    // CONSTRUCTORS
+    AsyncMember(RumorMember& member, AsyncExecutor& executor);
+
+    AsyncMember(const AsyncMember& other) = delete;
+
+    AsyncMember& operator=(const AsyncMember& other) = delete;
+
+    // METHODS
+    // Advance 'member()' by one round and hand the PUSH messages to the 'nextRound()' waiters.
+    void tick();
+
+    // Queue 'message' from 'fromMember'. It is handed to the next 'receive()' waiter.
+    void deliver(const Message& message, int fromMember);
+
+    // Pass 'inbound' to 'RumorMember::receivedMessage' and return the PULL messages to send.
+    Outbound handle(const Inbound& inbound);
+
+    // Complete all pending awaits and make future awaits complete immediately.
+    void close();
+
+    RoundAwaiter nextRound();
+
+    ReceiveAwaiter receive();
+
+    OldAwaiter untilOld(int rumorId);
+
+    RumorMember& member();
+
+    // CONST METHODS
+    bool closed() const;
+
+    // Number of delivered messages that were not received yet.
+    size_t numQueued() const;
+};
+
+} // project namespace
+
+#endif //RANDOMIZEDRUMORSPREADING_ASYNCMEMBER_H
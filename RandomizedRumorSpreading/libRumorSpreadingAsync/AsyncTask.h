@@ -0,0 +1,79 @@
+#ifndef RANDOMIZEDRUMORSPREADING_ASYNCTASK_H
+#define RANDOMIZEDRUMORSPREADING_ASYNCTASK_H
+
+#include <coroutine>
+#include <exception>
+#include <utility>
+
+#include "AsyncExecutor.h"
+
+namespace RRS {
+
+/**
+ * Fire-and-forget coroutine type. The coroutine is created suspended and starts running on the
+ * executor passed to 'start()'. Once started the frame owns itself and is released when the
+ * coroutine body returns. Exceptions escaping the body terminate the program.
+ */
+class AsyncTask {
+  public:
+    // TYPES
+    struct promise_type {
+        AsyncWaiter m_startNode;
+
+        AsyncTask get_return_object()
+        {
+            return AsyncTask(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() noexcept { return {}; }
+
+        std::suspend_never final_suspend() noexcept { return {}; }
+
+        void return_void() {}
+
+        void unhandled_exception() { std::terminate(); }
+    };
+
+  private:
+    // MEMBERS
+    std::coroutine_handle<promise_type> m_handle;
+
+    // CONSTRUCTORS
+    explicit AsyncTask(std::coroutine_handle<promise_type> handle)
+    : m_handle(handle)
+    {
+    }
+
+  public:
+    AsyncTask(const AsyncTask& other) = delete;
+
+    AsyncTask(AsyncTask&& other) noexcept
+    : m_handle(std::exchange(other.m_handle, nullptr))
+    {
+    }
+
+    // DESTRUCTOR
+    // A task that was never started is destroyed together with its frame.
+    ~AsyncTask()
+    {
+        if (m_handle) {
+            m_handle.destroy();
+        }
+    }
+
+    // OPERATORS
+    AsyncTask& operator=(const AsyncTask& other) = delete;
+
+    // METHODS
+    // Hand the coroutine over to 'executor'. It will run on the next 'executor.run()'.
+    void start(AsyncExecutor& executor)
+    {
+        std::coroutine_handle<promise_type> handle = std::exchange(m_handle, nullptr);
+        handle.promise().m_startNode.m_handle = handle;
+        executor.post(&handle.promise().m_startNode);
+    }
+};
+
+} // project namespace
+
+#endif //RANDOMIZEDRUMORSPREADING_ASYNCTASK_H
@@ -0,0 +1,332 @@
+#include "CoreRuntime.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace RRS {
+
+struct CoreRuntime::Worker : CacheAligned {
+    int                                               m_index;
+    std::thread                                       m_thread;
+    std::vector<Hosted>                               m_members;
+    std::vector<std::unique_ptr<SpscQueue<Envelope>>> m_inbound;        // Producer worker --> queue
+    int                                               m_round;          // Last round advanced
+    Envelope                                          m_envelope;       // Scratch, reused
+    std::vector<Message>                              m_pullMessages;   // Scratch, reused
+    // Written by every worker: round in the high 32 bits, next member to claim in the low ones
+    alignas(k_cacheLineSize) std::atomic<uint64_t>    m_cursor;
+    // Written by this worker only
+    alignas(k_cacheLineSize) std::atomic<long>        m_numBatches;
+    std::atomic<long>                                 m_numStolen;
+    std::atomic<long>                                 m_numDropped;
+
+    explicit Worker(int index)
+    : m_index(index)
+    , m_thread()
+    , m_members()
+    , m_inbound()
+    , m_round(0)
+    , m_envelope()
+    , m_pullMessages()
+    , m_cursor(0)
+    , m_numBatches(0)
+    , m_numStolen(0)
+    , m_numDropped(0)
+    {
+    }
+};
+
+namespace {
+
+void pinToCore(std::thread& thread, int index)
+{
+#ifdef __linux__
+    const unsigned numCores = std::thread::hardware_concurrency();
+    if (numCores == 0) {
+        return;
+    }
+
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(index % numCores, &cpus);
+    // Best effort, e.g. the process may be restricted to fewer cores
+    pthread_setaffinity_np(thread.native_handle(), sizeof(cpus), &cpus);
+#else
+    (void) thread;
+    (void) index;
+#endif
+}
+
+void add(std::atomic<long>& counter, long value)
+{
+    // Single writer
+    counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+} // anonymous namespace
+
+// PRIVATE METHODS
+void CoreRuntime::run(Worker& worker)
+{
+    // First touch of the member state on this core
+    for (Hosted& hosted : worker.m_members) {
+        hosted.m_member.reset(new RumorMember(hosted.m_peers, hosted.m_networkConfig, hosted.m_memberId));
+    }
+    m_numStarted.fetch_add(1, std::memory_order_release);
+
+    while (m_running.load(std::memory_order_acquire)) {
+        bool busy = drain(worker);
+        const int round = m_round.load(std::memory_order_acquire);
+        if (worker.m_round < round) {
+            advanceMembers(worker, round);
+            worker.m_round = round;
+            busy = true;
+        }
+        if (!busy) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+long CoreRuntime::claim(Worker& owner, int round)
+{
+    const uint64_t size = owner.m_members.size();
+    uint64_t cursor = owner.m_cursor.load(std::memory_order_relaxed);
+    for (;;) {
+        const int cursorRound = static_cast<int>(cursor >> 32);
+        uint64_t index = cursor & 0xffffffffULL;
+        if (cursorRound > round) {
+            return -1;
+        }
+        if (cursorRound < round) {
+            // First claim of the round
+            index = 0;
+        }
+        if (index >= size) {
+            return -1;
+        }
+
+        const uint64_t next = (static_cast<uint64_t>(round) << 32) | (index + 1);
+        if (owner.m_cursor.compare_exchange_weak(cursor, next, std::memory_order_acq_rel)) {
+            return static_cast<long>(index);
+        }
+    }
+}
+
+void CoreRuntime::advanceMembers(Worker& worker, int round)
+{
+    // Own members first, then the ones other workers did not get to yet
+    for (int i = 0; i < m_numWorkers; ++i) {
+        Worker& owner = *m_workers[(worker.m_index + i) % m_numWorkers];
+        long index;
+        while ((index = claim(owner, round)) >= 0) {
+            Hosted& hosted = owner.m_members[index];
+            std::pair<int, std::vector<Message>> push = hosted.m_member->advanceRound();
+            if (push.first >= 0) {
+                route(worker, hosted.m_memberId, push.first, push.second);
+            }
+            if (i > 0) {
+                add(worker.m_numStolen, 1);
+            }
+            m_numAdvanced.fetch_add(1, std::memory_order_acq_rel);
+        }
+    }
+}
+
+bool CoreRuntime::drain(Worker& worker)
+{
+    bool drained = false;
+    Envelope& envelope = worker.m_envelope;
+    for (const std::unique_ptr<SpscQueue<Envelope>>& queue : worker.m_inbound) {
+        while (queue->pop(envelope)) {
+            drained = true;
+            RumorMember& receiver = *worker.m_members[m_location.at(envelope.m_toMember).second].m_member;
+            worker.m_pullMessages.clear();
+            for (const Message& message : envelope.m_messages) {
+                std::pair<int, std::vector<Message>> pull = receiver.receivedMessage(message, envelope.m_fromMember);
+                worker.m_pullMessages.insert(worker.m_pullMessages.end(), pull.second.begin(), pull.second.end());
+            }
+
+            if (!worker.m_pullMessages.empty()) {
+                route(worker, envelope.m_toMember, envelope.m_fromMember, worker.m_pullMessages);
+            }
+            add(worker.m_numBatches, 1);
+            // After the replies were queued, so that 'quiesce' cannot see zero in between
+            m_numInFlight.fetch_sub(1, std::memory_order_acq_rel);
+        }
+    }
+    return drained;
+}
+
+void CoreRuntime::route(Worker& worker, int fromMember, int toMember, std::vector<Message>& messages)
+{
+    const auto& iter = m_location.find(toMember);
+    if (iter == m_location.end()) {
+        add(worker.m_numDropped, 1);
+        return;
+    }
+
+    Envelope envelope = {fromMember, toMember, std::move(messages)};
+    m_numInFlight.fetch_add(1, std::memory_order_acq_rel);
+    if (!m_workers[iter->second.first]->m_inbound[worker.m_index]->push(envelope)) {
+        m_numInFlight.fetch_sub(1, std::memory_order_acq_rel);
+        add(worker.m_numDropped, 1);
+    }
+    messages.clear();
+}
+
+// CONSTRUCTORS
+CoreRuntime::CoreRuntime(int numWorkers, bool pinThreads, size_t queueCapacity)
+: m_numWorkers(numWorkers > 0 ? numWorkers : std::max(1, static_cast<int>(std::thread::hardware_concurrency())))
+, m_pinThreads(pinThreads)
+, m_queueCapacity(queueCapacity > 0 ? queueCapacity : 1)
+, m_workers()
+, m_location()
+, m_numMembers(0)
+, m_running(false)
+, m_numStarted(0)
+, m_round(0)
+, m_numAdvanced(0)
+, m_numInFlight(0)
+{
+    for (int i = 0; i < m_numWorkers; ++i) {
+        m_workers.emplace_back(new Worker(i));
+    }
+}
+
+// DESTRUCTOR
+CoreRuntime::~CoreRuntime()
+{
+    stop();
+}
+
+// PUBLIC METHODS
+void CoreRuntime::addMember(int memberId, const std::unordered_set<int>& peers, const NetworkConfig& networkConfig)
+{
+    if (m_numStarted.load() > 0 || m_location.count(memberId) > 0) {
+        throw std::logic_error("Members must be added once, before the runtime is started");
+    }
+
+    const int index = static_cast<int>(m_numMembers++ % m_numWorkers);
+    Worker& worker = *m_workers[index];
+    m_location[memberId] = {index, worker.m_members.size()};
+    worker.m_members.push_back({memberId, peers, networkConfig, nullptr});
+}
+
+void CoreRuntime::start()
+{
+    if (m_numStarted.load() > 0 || m_running.exchange(true)) {
+        return;
+    }
+
+    for (std::unique_ptr<Worker>& worker : m_workers) {
+        for (int producer = 0; producer < m_numWorkers; ++producer) {
+            worker->m_inbound.emplace_back(new SpscQueue<Envelope>(m_queueCapacity));
+        }
+    }
+
+    for (std::unique_ptr<Worker>& worker : m_workers) {
+        Worker& self = *worker;
+        worker->m_thread = std::thread([this, &self] { run(self); });
+        if (m_pinThreads) {
+            pinToCore(worker->m_thread, worker->m_index);
+        }
+    }
+
+    while (m_numStarted.load(std::memory_order_acquire) < m_numWorkers) {
+        std::this_thread::yield();
+    }
+}
+
+void CoreRuntime::advanceRound()
+{
+    if (!m_running.load()) {
+        return;
+    }
+
+    // Every member finished the previous round, nobody else writes the counter now
+    m_numAdvanced.store(0, std::memory_order_relaxed);
+    m_round.fetch_add(1, std::memory_order_acq_rel);
+    while (m_numAdvanced.load(std::memory_order_acquire) < m_numMembers) {
+        std::this_thread::yield();
+    }
+}
+
+void CoreRuntime::quiesce()
+{
+    while (m_running.load() && m_numInFlight.load(std::memory_order_acquire) > 0) {
+        std::this_thread::yield();
+    }
+}
+
+void CoreRuntime::stop()
+{
+    m_running.store(false, std::memory_order_release);
+    for (std::unique_ptr<Worker>& worker : m_workers) {
+        if (worker->m_thread.joinable()) {
+            worker->m_thread.join();
+        }
+    }
+}
+
+RumorMember& CoreRuntime::member(int memberId)
+{
+    const std::pair<int, size_t>& location = m_location.at(memberId);
+    const std::unique_ptr<RumorMember>& member = m_workers[location.first]->m_members[location.second].m_member;
+    if (!member) {
+        throw std::out_of_range("The runtime is not started");
+    }
+    return *member;
+}
+
+// PUBLIC CONST METHODS
+int CoreRuntime::numWorkers() const
+{
+    return m_numWorkers;
+}
+
+size_t CoreRuntime::numMembers() const
+{
+    return m_numMembers;
+}
+
+int CoreRuntime::workerOf(int memberId) const
+{
+    const auto& iter = m_location.find(memberId);
+    return iter != m_location.end() ? iter->second.first : -1;
+}
+
+long CoreRuntime::numBatches() const
+{
+    long sum = 0;
+    for (const std::unique_ptr<Worker>& worker : m_workers) {
+        sum += worker->m_numBatches.load(std::memory_order_relaxed);
+    }
+    return sum;
+}
+
+long CoreRuntime::numStolen() const
+{
+    long sum = 0;
+    for (const std::unique_ptr<Worker>& worker : m_workers) {
+        sum += worker->m_numStolen.load(std::memory_order_relaxed);
+    }
+    return sum;
+}
+
+long CoreRuntime::numDropped() const
+{
+    long sum = 0;
+    for (const std::unique_ptr<Worker>& worker : m_workers) {
+        sum += worker->m_numDropped.load(std::memory_order_relaxed);
+    }
+    return sum;
+}
+
+} // project namespace
@@ -0,0 +1,131 @@
+#ifndef RANDOMIZEDRUMORSPREADING_CORERUNTIME_H
+#define RANDOMIZEDRUMORSPREADING_CORERUNTIME_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <NetworkConfig.h>
+#include <RumorMember.h>
+
+#include "SpscQueue.h"
+
+namespace RRS {
+
+/**
+ * Hosts many 'RumorMember's in one process on one worker thread per core.
+ *
+ * Members are sharded round robin over the workers. Every worker is pinned to its core and
+ * constructs its own members, so their state is first touched, and on NUMA systems allocated, by
+ * the core that uses it. Batches of messages between members travel through one single-producer
+ * single-consumer queue per pair of workers and are dispatched by the worker that owns the
+ * receiver, PULL replies included.
+ *
+ * Rounds are driven by the caller. A worker advances its own members and then steals the members
+ * that other workers have not started yet, so a round is not held back by a busy worker.
+ * 'RumorMember' is thread-safe, so a stolen member may receive messages on its owner concurrently.
+ */
+class CoreRuntime : public CacheAligned {
+  private:
+    // TYPES
+    struct Envelope {
+        int                  m_fromMember;
+        int                  m_toMember;
+        std::vector<Message> m_messages;
+    };
+
+    struct Hosted {
+        int                          m_memberId;
+        std::unordered_set<int>      m_peers;
+        NetworkConfig                m_networkConfig;
+        std::unique_ptr<RumorMember> m_member;
+    };
+
+    struct Worker;
+
+    // MEMBERS
+    int                                             m_numWorkers;
+    bool                                            m_pinThreads;
+    size_t                                          m_queueCapacity;
+    std::vector<std::unique_ptr<Worker>>            m_workers;
+    std::unordered_map<int, std::pair<int, size_t>> m_location;     // Member ID --> worker, index
+    size_t                                          m_numMembers;
+    std::atomic<bool>                               m_running;
+    std::atomic<int>                                m_numStarted;
+    alignas(k_cacheLineSize) std::atomic<int>       m_round;
+    alignas(k_cacheLineSize) std::atomic<size_t>    m_numAdvanced;  // Members done with 'm_round'
+    alignas(k_cacheLineSize) std::atomic<long>      m_numInFlight;  // Batches not dispatched yet
+
+    // METHODS
+    void run(Worker& worker);
+
+    // Claim the next member of 'owner' to advance in 'round'. Return -1 if there is none left.
+    long claim(Worker& owner, int round);
+
+    void advanceMembers(Worker& worker, int round);
+
+    // Dispatch the inbound batches of 'worker'. Return false if there were none.
+    bool drain(Worker& worker);
+
+    // Queue a batch from 'worker' to the worker that owns 'toMember'
+    void route(Worker& worker, int fromMember, int toMember, std::vector<Message>& messages);
+
+  public:
+    // CONSTRUCTORS
+    // 'numWorkers' 0 for one worker per hardware thread. 'queueCapacity' is in batches per pair of
+    // workers, batches that do not fit are dropped like lost datagrams.
+    explicit CoreRuntime(int numWorkers = 0, bool pinThreads = true, size_t queueCapacity = 1024);
+
+    CoreRuntime(const CoreRuntime& other) = delete;
+
+    CoreRuntime& operator=(const CoreRuntime& other) = delete;
+
+    // DESTRUCTOR
+    ~CoreRuntime();
+
+    // METHODS
+    // Host a member. Must be called before 'start'.
+    void addMember(int memberId, const std::unordered_set<int>& peers, const NetworkConfig& networkConfig);
+
+    // Start the workers and return once they constructed their members.
+    void start();
+
+    // Advance every member by one round and return when they all sent their PUSH messages. The
+    // messages may still be in flight.
+    void advanceRound();
+
+    // Wait until every batch sent so far, and the replies to it, has been dispatched.
+    void quiesce();
+
+    // Stop and join the workers. Messages in flight are discarded.
+    void stop();
+
+    // The hosted member 'memberId', for adding and inspecting rumors. Throws std::out_of_range if
+    // there is no such member or the runtime is not started.
+    RumorMember& member(int memberId);
+
+    // CONST METHODS
+    int numWorkers() const;
+
+    size_t numMembers() const;
+
+    // Worker that owns 'memberId', -1 if it is not hosted
+    int workerOf(int memberId) const;
+
+    // Number of batches dispatched
+    long numBatches() const;
+
+    // Number of member rounds advanced by a worker other than the owner
+    long numStolen() const;
+
+    // Number of batches dropped because a queue was full or the receiver is not hosted
+    long numDropped() const;
+};
+
+} // project namespace
+
+#endif //RANDOMIZEDRUMORSPREADING_CORERUNTIME_H
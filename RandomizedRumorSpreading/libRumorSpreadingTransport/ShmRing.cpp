@@ -0,0 +1,294 @@
+#include "ShmRing.h"
+
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <ctime>
+#include <new>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+namespace RRS {
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2 && ATOMIC_INT_LOCK_FREE == 2,
+              "Shared memory rings need address-free atomics");
+
+namespace {
+
+const uint64_t k_magic = 0x5252532d52494e47ULL; // "RRS-RING"
+
+enum FrameState : uint32_t {
+    EMPTY = 0,
+    DATA = 1,
+    PADDING = 2,
+};
+
+uint64_t align8(uint64_t size)
+{
+    return (size + 7) & ~static_cast<uint64_t>(7);
+}
+
+void futexWait(std::atomic<uint32_t>* word, uint32_t expected, int timeoutMs)
+{
+#ifdef __linux__
+    timespec timeout;
+    timeout.tv_sec = timeoutMs / 1000;
+    timeout.tv_nsec = (timeoutMs % 1000) * 1000000L;
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAIT, expected,
+            timeoutMs >= 0 ? &timeout : nullptr, nullptr, 0);
+#else
+    (void) word;
+    (void) expected;
+    usleep(static_cast<useconds_t>(timeoutMs > 0 ? 1000 : 0));
+#endif
+}
+
+void futexWakeAll(std::atomic<uint32_t>* word)
+{
+#ifdef __linux__
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+#else
+    (void) word;
+#endif
+}
+
+inline void cpuRelax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+} // anonymous namespace
+
+// Producers and the consumer write different cache lines
+struct ShmRing::Header {
+    std::atomic<uint64_t>             m_magic;    // set last by the creator
+    uint64_t                          m_capacity;
+    alignas(64) std::atomic<uint64_t> m_reserve;  // next byte producers reserve
+    alignas(64) std::atomic<uint64_t> m_head;     // next byte the consumer reads
+    alignas(64) std::atomic<uint32_t> m_wakeSeq;  // futex word
+    std::atomic<uint32_t>             m_sleeping; // consumer is about to sleep
+};
+
+struct ShmRing::FrameHeader {
+    std::atomic<uint32_t> m_state;
+    uint32_t              m_size;  // header and payload, without alignment padding
+};
+
+// CONSTRUCTORS
+ShmRing::ShmRing(const std::string& name, bool owner, void* mapping, size_t mappingSize)
+: m_name(name)
+, m_owner(owner)
+, m_mapping(mapping)
+, m_mappingSize(mappingSize)
+, m_header(static_cast<Header*>(mapping))
+, m_data(static_cast<char*>(mapping) + align8(sizeof(Header)))
+, m_capacity(m_header->m_capacity)
+{
+}
+
+// STATIC METHODS
+std::unique_ptr<ShmRing> ShmRing::create(const std::string& name, size_t capacity)
+{
+    if (capacity < 64 || (capacity & (capacity - 1)) != 0) {
+        return nullptr;
+    }
+
+    shm_unlink(name.c_str());
+    const int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        return nullptr;
+    }
+
+    const size_t mappingSize = align8(sizeof(Header)) + capacity;
+    if (ftruncate(fd, static_cast<off_t>(mappingSize)) != 0) {
+        close(fd);
+        shm_unlink(name.c_str());
+        return nullptr;
+    }
+    void* mapping = mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        shm_unlink(name.c_str());
+        return nullptr;
+    }
+
+    // ftruncate zero-fills, so every frame starts EMPTY
+    Header* header = new (mapping) Header();
+    header->m_capacity = capacity;
+    header->m_reserve.store(0);
+    header->m_head.store(0);
+    header->m_wakeSeq.store(0);
+    header->m_sleeping.store(0);
+    header->m_magic.store(k_magic, std::memory_order_release);
+
+    return std::unique_ptr<ShmRing>(new ShmRing(name, true, mapping, mappingSize));
+}
+
+std::unique_ptr<ShmRing> ShmRing::open(const std::string& name)
+{
+    const int fd = shm_open(name.c_str(), O_RDWR, 0600);
+    if (fd < 0) {
+        return nullptr;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) <= align8(sizeof(Header))) {
+        close(fd);
+        return nullptr;
+    }
+    const size_t mappingSize = static_cast<size_t>(st.st_size);
+    void* mapping = mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        return nullptr;
+    }
+
+    Header* header = static_cast<Header*>(mapping);
+    const uint64_t magic = header->m_magic.load(std::memory_order_acquire);
+    if (magic != k_magic || align8(sizeof(Header)) + header->m_capacity != mappingSize) {
+        munmap(mapping, mappingSize);
+        return nullptr;
+    }
+
+    return std::unique_ptr<ShmRing>(new ShmRing(name, false, mapping, mappingSize));
+}
+
+// DESTRUCTOR
+ShmRing::~ShmRing()
+{
+    munmap(m_mapping, m_mappingSize);
+    if (m_owner) {
+        shm_unlink(m_name.c_str());
+    }
+}
+
+// PRIVATE METHODS
+ShmRing::FrameHeader* ShmRing::frameAt(uint64_t position) const
+{
+    return reinterpret_cast<FrameHeader*>(m_data + (position & (m_capacity - 1)));
+}
+
+void ShmRing::wake()
+{
+    // Pairs with the store to 'm_sleeping' in 'wait': either the consumer sees the new frame or
+    // this thread sees that the consumer is going to sleep
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_header->m_sleeping.load(std::memory_order_relaxed) != 0) {
+        m_header->m_wakeSeq.fetch_add(1, std::memory_order_release);
+        futexWakeAll(&m_header->m_wakeSeq);
+    }
+}
+
+// PRODUCER METHODS
+bool ShmRing::push(size_t size, const FillCb& fill)
+{
+    const uint64_t frameSize = align8(sizeof(FrameHeader) + size);
+    if (frameSize > m_capacity / 2) {
+        return false;
+    }
+
+    uint64_t position = m_header->m_reserve.load(std::memory_order_relaxed);
+    uint64_t padding;
+    do {
+        const uint64_t offset = position & (m_capacity - 1);
+        padding = m_capacity - offset < frameSize ? m_capacity - offset : 0;
+        const uint64_t head = m_header->m_head.load(std::memory_order_acquire);
+        if (position + padding + frameSize - head > m_capacity) {
+            return false;
+        }
+    } while (!m_header->m_reserve.compare_exchange_weak(position,
+                                                        position + padding + frameSize,
+                                                        std::memory_order_acq_rel,
+                                                        std::memory_order_relaxed));
+
+    if (padding > 0) {
+        FrameHeader* pad = frameAt(position);
+        pad->m_size = static_cast<uint32_t>(padding);
+        pad->m_state.store(PADDING, std::memory_order_release);
+    }
+
+    FrameHeader* frame = frameAt(position + padding);
+    frame->m_size = static_cast<uint32_t>(sizeof(FrameHeader) + size);
+    fill(reinterpret_cast<char*>(frame + 1));
+    frame->m_state.store(DATA, std::memory_order_release);
+
+    wake();
+    return true;
+}
+
+// CONSUMER METHODS
+size_t ShmRing::consume(const FrameCb& cb)
+{
+    size_t numFrames = 0;
+    uint64_t head = m_header->m_head.load(std::memory_order_relaxed);
+    while (true) {
+        FrameHeader* frame = frameAt(head);
+        const uint32_t state = frame->m_state.load(std::memory_order_acquire);
+        if (state == EMPTY) {
+            break;
+        }
+
+        const uint32_t size = frame->m_size;
+        if (state == DATA) {
+            cb(reinterpret_cast<const char*>(frame + 1), size - sizeof(FrameHeader));
+            ++numFrames;
+        }
+
+        // Producers may only reuse the space once it reads as EMPTY again
+        const uint64_t advance = align8(size);
+        std::memset(static_cast<void*>(frame), 0, advance);
+        head += advance;
+        m_header->m_head.store(head, std::memory_order_release);
+    }
+    return numFrames;
+}
+
+bool ShmRing::wait(int timeoutMs, int spinIterations)
+{
+    for (int i = 0; i < spinIterations; ++i) {
+        if (!empty()) {
+            return true;
+        }
+        cpuRelax();
+    }
+    if (timeoutMs == 0) {
+        return !empty();
+    }
+
+    const uint32_t seq = m_header->m_wakeSeq.load(std::memory_order_acquire);
+    m_header->m_sleeping.store(1, std::memory_order_seq_cst);
+    if (empty()) {
+        futexWait(&m_header->m_wakeSeq, seq, timeoutMs);
+    }
+    m_header->m_sleeping.store(0, std::memory_order_relaxed);
+    return !empty();
+}
+
+// CONST METHODS
+bool ShmRing::empty() const
+{
+    const uint64_t head = m_header->m_head.load(std::memory_order_relaxed);
+    return frameAt(head)->m_state.load(std::memory_order_acquire) == EMPTY;
+}
+
+size_t ShmRing::maxFrameSize() const
+{
+    return m_capacity / 2 - sizeof(FrameHeader);
+}
+
+const std::string& ShmRing::name() const
+{
+    return m_name;
+}
+
+} // project namespace
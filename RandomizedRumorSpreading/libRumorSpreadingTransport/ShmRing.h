@@ -0,0 +1,95 @@
+#ifndef RANDOMIZEDRUMORSPREADING_SHMRING_H
+#define RANDOMIZEDRUMORSPREADING_SHMRING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace RRS {
+
+/**
+ * Multi-producer single-consumer ring of variable sized frames in POSIX shared memory.
+ *
+ * The consumer process creates the ring and producers in any process open it by name. Producers
+ * reserve space with a CAS on a shared counter, copy their frame in place and publish it with a
+ * release store of its state word, so producers never block each other or the consumer. A frame
+ * that would wrap around the end of the ring is preceded by a padding frame. The consumer clears
+ * consumed bytes before handing the space back to producers.
+ *
+ * An idle consumer spins for a while and then sleeps on a futex in the ring header. Producers only
+ * issue the wake-up system call when the consumer announced that it is going to sleep.
+ */
+class ShmRing {
+  public:
+    // TYPES
+    typedef std::function<void(char*)>              FillCb;
+    typedef std::function<void(const char*, size_t)> FrameCb;
+
+  private:
+    // TYPES
+    struct Header;
+    struct FrameHeader;
+
+    // MEMBERS
+    std::string m_name;
+    bool        m_owner;
+    void*       m_mapping;
+    size_t      m_mappingSize;
+    Header*     m_header;
+    char*       m_data;
+    uint64_t    m_capacity;
+
+    // CONSTRUCTORS
+    ShmRing(const std::string& name, bool owner, void* mapping, size_t mappingSize);
+
+    // METHODS
+    FrameHeader* frameAt(uint64_t position) const;
+
+    // Wake the consumer if it is sleeping
+    void wake();
+
+  public:
+    // STATIC METHODS
+    // Create the ring 'name' with 'capacity' bytes of frame storage, a power of two. Replaces a
+    // stale ring with the same name. Return nullptr on failure.
+    static std::unique_ptr<ShmRing> create(const std::string& name, size_t capacity);
+
+    // Open the existing ring 'name' as a producer. Return nullptr if it does not exist yet.
+    static std::unique_ptr<ShmRing> open(const std::string& name);
+
+    ShmRing(const ShmRing& other) = delete;
+
+    ShmRing& operator=(const ShmRing& other) = delete;
+
+    // DESTRUCTOR
+    // Unmap the ring. The creator also removes its name.
+    ~ShmRing();
+
+    // PRODUCER METHODS
+    // Reserve a frame of 'size' bytes, let 'fill' write it in place and publish it. Return false
+    // if the ring is full or the frame is larger than half of the ring.
+    bool push(size_t size, const FillCb& fill);
+
+    // CONSUMER METHODS
+    // Pass every published frame to 'cb', in order, and release its space. Return the number of
+    // frames consumed.
+    size_t consume(const FrameCb& cb);
+
+    // Wait until a frame is published, spinning 'spinIterations' times before sleeping for up to
+    // 'timeoutMs' milliseconds. Return true if a frame is available.
+    bool wait(int timeoutMs, int spinIterations);
+
+    // CONST METHODS
+    bool empty() const;
+
+    // Largest 'size' that 'push' accepts, about half of the ring
+    size_t maxFrameSize() const;
+
+    const std::string& name() const;
+};
+
+} // project namespace
+
+#endif //RANDOMIZEDRUMORSPREADING_SHMRING_H
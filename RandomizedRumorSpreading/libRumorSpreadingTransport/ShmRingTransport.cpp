@@ -0,0 +1,100 @@
+#include "ShmRingTransport.h"
+
+#include <algorithm>
+#include <thread>
+
+#include <WireFormat.h>
+
+namespace RRS {
+
+// STATIC METHODS
+std::string ShmRingTransport::ringName(const std::string& cluster, int memberId)
+{
+    return "/rrs." + cluster + "." + std::to_string(memberId);
+}
+
+// PRIVATE METHODS
+ShmRing* ShmRingTransport::outbound(int toMember)
+{
+    std::unique_ptr<ShmRing>& ring = m_outbound[toMember];
+    if (!ring) {
+        ring = ShmRing::open(ringName(m_cluster, toMember));
+    }
+    return ring.get();
+}
+
+// CONSTRUCTORS
+ShmRingTransport::ShmRingTransport(int memberId,
+                                   const std::string& cluster,
+                                   size_t capacity,
+                                   int spinIterations)
+: m_memberId(memberId)
+, m_cluster(cluster)
+, m_spinIterations(spinIterations)
+, m_inbound(ShmRing::create(ringName(cluster, memberId), capacity))
+, m_outbound()
+, m_messages()
+{
+}
+
+// PUBLIC METHODS
+bool ShmRingTransport::send(int toMember, const std::vector<Message>& messages)
+{
+    ShmRing* ring = outbound(toMember);
+    if (!ring) {
+        return false;
+    }
+
+    if (ring->maxFrameSize() < WireFormat::k_headerSize + WireFormat::k_maxEntrySize) {
+        return false;
+    }
+    const size_t perFrame = (ring->maxFrameSize() - WireFormat::k_headerSize) / WireFormat::k_maxEntrySize;
+
+    size_t first = 0;
+    do {
+        const size_t count = std::min(perFrame, messages.size() - first);
+        const Message* batch = messages.data() + first;
+        const auto fill = [&](char* out) {
+            WireFormat::encode(m_memberId, batch, count, out);
+        };
+
+        // Frames never exceed the ring, so a failed push means it is full: give the consumer a
+        // chance to drain it before dropping the rest of the batch
+        const size_t size = WireFormat::frameSize(batch, count);
+        int spins = 0;
+        while (!ring->push(size, fill)) {
+            if (++spins > m_spinIterations) {
+                return false;
+            }
+            std::this_thread::yield();
+        }
+        first += count;
+    } while (first < messages.size());
+
+    return true;
+}
+
+int ShmRingTransport::poll(int timeoutMs, const ReceiveCb& cb)
+{
+    if (!m_inbound || !m_inbound->wait(timeoutMs, m_spinIterations)) {
+        return 0;
+    }
+
+    int numBatches = 0;
+    m_inbound->consume([&](const char* data, size_t size) {
+        int fromMember;
+        if (WireFormat::decode(data, size, fromMember, m_messages)) {
+            cb(fromMember, m_messages);
+            ++numBatches;
+        }
+    });
+    return numBatches;
+}
+
+// PUBLIC CONST METHODS
+bool ShmRingTransport::isOpen() const
+{
+    return m_inbound != nullptr;
+}
+
+} // project namespace
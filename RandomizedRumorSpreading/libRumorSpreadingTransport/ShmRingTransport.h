@@ -0,0 +1,66 @@
+#ifndef RANDOMIZEDRUMORSPREADING_SHMRINGTRANSPORT_H
+#define RANDOMIZEDRUMORSPREADING_SHMRINGTRANSPORT_H
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ShmRing.h"
+#include "Transport.h"
+
+namespace RRS {
+
+/**
+ * Transport for members running on the same host. Every member owns an inbound 'ShmRing' named
+ * after the cluster and its member id, and writes batches directly into the rings of its peers.
+ * Rings of peers are opened lazily on the first send, so members may start in any order. Batches
+ * are split into frames that fit the ring of the peer, and a full ring is retried for up to
+ * 'spinIterations' yields before the rest of the batch is dropped.
+ */
+class ShmRingTransport : public Transport {
+  private:
+    // MEMBERS
+    const int                                     m_memberId;
+    const std::string                             m_cluster;
+    const int                                     m_spinIterations;
+    std::unique_ptr<ShmRing>                      m_inbound;
+    std::unordered_map<int, std::unique_ptr<ShmRing>> m_outbound;  // Member ID --> peer ring
+    std::vector<Message>                          m_messages;
+
+    // METHODS
+    // Return the ring of 'toMember', or nullptr if it does not exist yet
+    ShmRing* outbound(int toMember);
+
+  public:
+    // CONSTANTS
+    static const size_t k_defaultCapacity = 4 << 20;
+    static const int    k_defaultSpinIterations = 4000;
+
+    // STATIC METHODS
+    // Name of the shared memory ring of 'memberId' in 'cluster'
+    static std::string ringName(const std::string& cluster, int memberId);
+
+    // CONSTRUCTORS
+    // Create the inbound ring of 'memberId'. Check 'isOpen()' for success.
+    ShmRingTransport(int memberId,
+                     const std::string& cluster,
+                     size_t capacity = k_defaultCapacity,
+                     int spinIterations = k_defaultSpinIterations);
+
+    ShmRingTransport(const ShmRingTransport& other) = delete;
+
+    ShmRingTransport& operator=(const ShmRingTransport& other) = delete;
+
+    // METHODS
+    bool send(int toMember, const std::vector<Message>& messages) override;
+
+    int poll(int timeoutMs, const ReceiveCb& cb) override;
+
+    // CONST METHODS
+    bool isOpen() const;
+};
+
+} // project namespace
+
+#endif //RANDOMIZEDRUMORSPREADING_SHMRINGTRANSPORT_H
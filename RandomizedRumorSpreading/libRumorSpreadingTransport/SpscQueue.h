@@ -0,0 +1,116 @@
+#ifndef RANDOMIZEDRUMORSPREADING_SPSCQUEUE_H
+#define RANDOMIZEDRUMORSPREADING_SPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace RRS {
+
+// Size of a cache line, the distance kept between data written by different threads
+static const size_t k_cacheLineSize = 64;
+
+// Base of the classes with members aligned on a cache line. Before C++17 a plain 'new' only
+// guarantees the alignment of 'std::max_align_t', so they are allocated aligned here.
+struct CacheAligned {
+    static void* operator new(size_t size)
+    {
+        void* ptr = nullptr;
+        if (posix_memalign(&ptr, k_cacheLineSize, size) != 0) {
+            throw std::bad_alloc();
+        }
+        return ptr;
+    }
+
+    static void operator delete(void* ptr)
+    {
+        free(ptr);
+    }
+};
+
+/**
+ * Bounded single-producer single-consumer queue. The producer only writes the tail and the
+ * consumer only writes the head, each on its own cache line, and each side caches the other's
+ * index so that it reads the shared one only when the queue looks full or empty.
+ */
+template <typename T>
+class SpscQueue : public CacheAligned {
+  private:
+    // MEMBERS
+    std::vector<T>                           m_slots;
+    size_t                                   m_mask;
+    alignas(k_cacheLineSize) std::atomic<size_t> m_head;        // Next slot to pop
+    size_t                                   m_cachedTail;  // Consumer's copy of 'm_tail'
+    alignas(k_cacheLineSize) std::atomic<size_t> m_tail;        // Next slot to push
+    size_t                                   m_cachedHead;  // Producer's copy of 'm_head'
+
+  public:
+    // CONSTRUCTORS
+    // Hold up to 'capacity' items, rounded up to a power of two
+    explicit SpscQueue(size_t capacity)
+    : m_slots()
+    , m_mask(0)
+    , m_head(0)
+    , m_cachedTail(0)
+    , m_tail(0)
+    , m_cachedHead(0)
+    {
+        size_t size = 1;
+        while (size < capacity) {
+            size *= 2;
+        }
+        m_slots.resize(size);
+        m_mask = size - 1;
+    }
+
+    SpscQueue(const SpscQueue& other) = delete;
+
+    SpscQueue& operator=(const SpscQueue& other) = delete;
+
+    // PRODUCER METHODS
+    // Move 'item' into the queue. Return false if the queue is full, 'item' is then unchanged.
+    bool push(T& item)
+    {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_cachedHead > m_mask) {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if (tail - m_cachedHead > m_mask) {
+                return false;
+            }
+        }
+
+        m_slots[tail & m_mask] = std::move(item);
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // CONSUMER METHODS
+    // Move the oldest item into 'item'. Return false if the queue is empty.
+    bool pop(T& item)
+    {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_cachedTail) {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            if (head == m_cachedTail) {
+                return false;
+            }
+        }
+
+        item = std::move(m_slots[head & m_mask]);
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // CONST METHODS
+    size_t capacity() const
+    {
+        return m_slots.size();
+    }
+};
+
+} // project namespace
+
+#endif //RANDOMIZEDRUMORSPREADING_SPSCQUEUE_H
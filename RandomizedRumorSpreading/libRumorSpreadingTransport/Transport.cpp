@@ -0,0 +1,9 @@
+#include "Transport.h"
+
+namespace RRS {
+
+Transport::~Transport()
+{
+}
+
+} // project namespace
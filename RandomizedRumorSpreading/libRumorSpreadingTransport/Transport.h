@@ -0,0 +1,41 @@
+#ifndef RANDOMIZEDRUMORSPREADING_TRANSPORT_H
+#define RANDOMIZEDRUMORSPREADING_TRANSPORT_H
+
+#include <functional>
+#include <vector>
+
+#include <Message.h>
+
+namespace RRS {
+
+// Moves batches of messages between members. Implementations are not thread-safe.
+class Transport {
+  public:
+    // TYPES
+    // Invoked with the sender member id and the messages of one received batch
+    typedef std::function<void(int, const std::vector<Message>&)> ReceiveCb;
+
+    // DESTRUCTOR
+    virtual ~Transport();
+
+    // METHODS
+    /**
+    *  @brief  Send a batch of messages.
+    *  @param  toMember The member id of the receiver.
+    *  @param  messages The messages to send, in order.
+    *  @return Return false if the batch could not be handed to the network.
+    */
+    virtual bool send(int toMember, const std::vector<Message>& messages) = 0;
+
+    /**
+    *  @brief  Receive the pending batches.
+    *  @param  timeoutMs Maximum time to wait for the first batch, 0 to return immediately.
+    *  @param  cb Invoked for every received batch.
+    *  @return Return the number of batches passed to 'cb'.
+    */
+    virtual int poll(int timeoutMs, const ReceiveCb& cb) = 0;
+};
+
+} // project namespace
+
+#endif //RANDOMIZEDRUMORSPREADING_TRANSPORT_H
@@ -0,0 +1,83 @@
+#include "TransportMember.h"
+
+namespace RRS {
+
+// PRIVATE METHODS
+void TransportMember::dispatch(int fromMember, const std::vector<Message>& messages)
+{
+    ++m_numBatchesReceived;
+    m_numMessagesReceived += static_cast<long>(messages.size());
+
+    m_pullMessages.clear();
+    for (const Message& message : messages) {
+        std::pair<int, std::vector<Message>> pull = m_member.receivedMessage(message, fromMember);
+        m_pullMessages.insert(m_pullMessages.end(), pull.second.begin(), pull.second.end());
+    }
+
+    if (!m_pullMessages.empty()) {
+        send(fromMember, m_pullMessages);
+    }
+}
+
+void TransportMember::send(int toMember, const std::vector<Message>& messages)
+{
+    if (m_transport.send(toMember, messages)) {
+        ++m_numBatchesSent;
+        m_numMessagesSent += static_cast<long>(messages.size());
+    }
+}
+
+// CONSTRUCTORS
+TransportMember::TransportMember(RumorMember& member, Transport& transport)
+: m_member(member)
+, m_transport(transport)
+, m_pullMessages()
+, m_numMessagesSent(0)
+, m_numMessagesReceived(0)
+, m_numBatchesSent(0)
+, m_numBatchesReceived(0)
+{
+}
+
+// PUBLIC METHODS
+void TransportMember::tick()
+{
+    sendRound(m_member.advanceRound());
+}
+
+void TransportMember::sendRound(const std::pair<int, std::vector<Message>>& push)
+{
+    if (push.first >= 0) {
+        send(push.first, push.second);
+    }
+}
+
+int TransportMember::poll(int timeoutMs)
+{
+    return m_transport.poll(timeoutMs, [this](int fromMember, const std::vector<Message>& messages) {
+        dispatch(fromMember, messages);
+    });
+}
+
+// PUBLIC CONST METHODS
+long TransportMember::numMessagesSent() const
+{
+    return m_numMessagesSent;
+}
+
+long TransportMember::numMessagesReceived() const
+{
+    return m_numMessagesReceived;
+}
+
+long TransportMember::numBatchesSent() const
+{
+    return m_numBatchesSent;
+}
+
+long TransportMember::numBatchesReceived() const
+{
+    return m_numBatchesReceived;
+}
+
+} // project namespace
@@ -0,0 +1,57 @@
+#ifndef RANDOMIZEDRUMORSPREADING_TRANSPORTMEMBER_H
+#define RANDOMIZEDRUMORSPREADING_TRANSPORTMEMBER_H
+
+#include <RumorMember.h>
+
+#include "Transport.h"
+
+namespace RRS {
+
+/**
+ * Connects a 'RumorMember' to a 'Transport': rounds are sent as one PUSH batch to the selected
+ * member and every received batch is dispatched into 'RumorMember::receivedMessage', with the
+ * resulting PULL messages sent back to the sender as one batch.
+ */
+class TransportMember {
+  private:
+    // MEMBERS
+    RumorMember&         m_member;
+    Transport&           m_transport;
+    std::vector<Message> m_pullMessages;
+    long                 m_numMessagesSent;
+    long                 m_numMessagesReceived;
+    long                 m_numBatchesSent;
+    long                 m_numBatchesReceived;
+
+    // METHODS
+    void dispatch(int fromMember, const std::vector<Message>& messages);
+
+    void send(int toMember, const std::vector<Message>& messages);
+
+  public:
+    // CONSTRUCTORS
+    TransportMember(RumorMember& member, Transport& transport);
+
+    // METHODS
+    // Advance the member by one round and send its PUSH messages.
+    void tick();
+
+    // Send the PUSH messages of a round the caller advanced, e.g. through a 'RoundScheduler'.
+    void sendRound(const std::pair<int, std::vector<Message>>& push);
+
+    // Wait up to 'timeoutMs' for inbound batches and dispatch them. Return the number of batches.
+    int poll(int timeoutMs);
+
+    // CONST METHODS
+    long numMessagesSent() const;
+
+    long numMessagesReceived() const;
+
+    long numBatchesSent() const;
+
+    long numBatchesReceived() const;
+};
+
+} // project namespace
+
+#endif //RANDOMIZEDRUMORSPREADING_TRANSPORTMEMBER_H
@@ -0,0 +1,120 @@
+#include "UdpTransport.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <WireFormat.h>
+
+namespace RRS {
+
+namespace {
+
+sockaddr_in makeAddress(const std::string& host, int port)
+{
+    sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    inet_pton(AF_INET, host.c_str(), &addr.sin_addr);
+    return addr;
+}
+
+} // anonymous namespace
+
+// CONSTRUCTORS
+UdpTransport::UdpTransport(int memberId, int basePort, const std::string& host)
+: m_memberId(memberId)
+, m_basePort(basePort)
+, m_host(host)
+, m_fd(socket(AF_INET, SOCK_DGRAM, 0))
+, m_sendBuffer()
+, m_recvBuffer(k_maxDatagram)
+, m_messages()
+{
+    if (m_fd < 0) {
+        return;
+    }
+
+    int bufferSize = 4 << 20;
+    setsockopt(m_fd, SOL_SOCKET, SO_RCVBUF, &bufferSize, sizeof(bufferSize));
+
+    sockaddr_in addr = makeAddress(m_host, m_basePort + m_memberId);
+    if (bind(m_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        close(m_fd);
+        m_fd = -1;
+        return;
+    }
+    fcntl(m_fd, F_SETFL, O_NONBLOCK);
+}
+
+// DESTRUCTOR
+UdpTransport::~UdpTransport()
+{
+    if (m_fd >= 0) {
+        close(m_fd);
+    }
+}
+
+// PUBLIC METHODS
+bool UdpTransport::send(int toMember, const std::vector<Message>& messages)
+{
+    if (m_fd < 0) {
+        return false;
+    }
+
+    sockaddr_in addr = makeAddress(m_host, m_basePort + toMember);
+    const size_t perDatagram = (k_maxDatagram - WireFormat::k_headerSize) / WireFormat::k_maxEntrySize;
+
+    bool sent = true;
+    size_t first = 0;
+    do {
+        const size_t count = std::min(perDatagram, messages.size() - first);
+        m_sendBuffer.resize(WireFormat::maxFrameSize(count));
+        const size_t size = WireFormat::encode(m_memberId, messages.data() + first, count, m_sendBuffer.data());
+        if (sendto(m_fd, m_sendBuffer.data(), size, 0,
+                   reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+            sent = false;
+        }
+        first += count;
+    } while (first < messages.size());
+
+    return sent;
+}
+
+int UdpTransport::poll(int timeoutMs, const ReceiveCb& cb)
+{
+    if (m_fd < 0) {
+        return 0;
+    }
+
+    pollfd pfd = {m_fd, POLLIN, 0};
+    if (::poll(&pfd, 1, timeoutMs) <= 0) {
+        return 0;
+    }
+
+    int numBatches = 0;
+    ssize_t size;
+    while ((size = recv(m_fd, m_recvBuffer.data(), m_recvBuffer.size(), 0)) > 0) {
+        int fromMember;
+        if (WireFormat::decode(m_recvBuffer.data(), static_cast<size_t>(size), fromMember, m_messages)) {
+            cb(fromMember, m_messages);
+            ++numBatches;
+        }
+    }
+    return numBatches;
+}
+
+// PUBLIC CONST METHODS
+bool UdpTransport::isOpen() const
+{
+    return m_fd >= 0;
+}
+
+} // project namespace
@@ -0,0 +1,52 @@
+#ifndef RANDOMIZEDRUMORSPREADING_UDPTRANSPORT_H
+#define RANDOMIZEDRUMORSPREADING_UDPTRANSPORT_H
+
+#include <string>
+#include <vector>
+
+#include "Transport.h"
+
+namespace RRS {
+
+/**
+ * Datagram transport for members that share a host address. Member 'm' listens on UDP port
+ * 'basePort + m'. Batches that do not fit in one datagram are split over several datagrams.
+ */
+class UdpTransport : public Transport {
+  private:
+    // MEMBERS
+    const int         m_memberId;
+    const int         m_basePort;
+    const std::string m_host;
+    int               m_fd;
+    std::vector<char> m_sendBuffer;
+    std::vector<char> m_recvBuffer;
+    std::vector<Message> m_messages;
+
+  public:
+    // CONSTANTS
+    static const size_t k_maxDatagram = 60000;
+
+    // CONSTRUCTORS
+    // Bind 'host:(basePort + memberId)'. Check 'isOpen()' for success.
+    UdpTransport(int memberId, int basePort, const std::string& host = "127.0.0.1");
+
+    UdpTransport(const UdpTransport& other) = delete;
+
+    UdpTransport& operator=(const UdpTransport& other) = delete;
+
+    // DESTRUCTOR
+    ~UdpTransport() override;
+
+    // METHODS
+    bool send(int toMember, const std::vector<Message>& messages) override;
+
+    int poll(int timeoutMs, const ReceiveCb& cb) override;
+
+    // CONST METHODS
+    bool isOpen() const;
+};
+
+} // project namespace
+
+#endif //RANDOMIZEDRUMORSPREADING_UDPTRANSPORT_H
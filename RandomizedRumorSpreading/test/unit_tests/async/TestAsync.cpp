@@ -0,0 +1,158 @@
+#include <unordered_map>
+#include <memory>
+
+#include <AsyncExecutor.h>
+#include <AsyncMember.h>
+#include <AsyncTask.h>
+#include <RumorMember.h>
+
+#include "gtest/gtest.h"
+
+using namespace RRS;
+
+namespace {
+
+typedef std::unordered_map<int, std::unique_ptr<AsyncMember>> AsyncMembers;
+
+// Forward the PUSH messages of every round to the selected member
+AsyncTask roundLoop(AsyncMember& self, AsyncMembers& members)
+{
+    while (true) {
+        AsyncMember::Outbound push = co_await self.nextRound();
+        if (self.closed()) {
+            co_return;
+        }
+        for (const Message& msg : push.second) {
+            members.at(push.first)->deliver(msg, self.member().id());
+        }
+    }
+}
+
+// Handle every inbound message and answer with PULL messages
+AsyncTask receiveLoop(AsyncMember& self, AsyncMembers& members)
+{
+    while (true) {
+        AsyncMember::Inbound inbound = co_await self.receive();
+        if (self.closed()) {
+            co_return;
+        }
+        AsyncMember::Outbound pull = self.handle(inbound);
+        for (const Message& msg : pull.second) {
+            members.at(pull.first)->deliver(msg, self.member().id());
+        }
+    }
+}
+
+AsyncTask waitUntilOld(AsyncMember& self, int rumorId, int& numOld)
+{
+    // GCC 12 miscompiles 'co_await' inside an 'if' condition, keep the result in a local
+    bool isOld = co_await self.untilOld(rumorId);
+    if (isOld) {
+        ++numOld;
+    }
+}
+
+} // anonymous namespace
+
+TEST(TestAsync, Spread_One_Rumor)
+{
+    const int numPeers = 8;
+    const int rumorId = 0;
+
+    std::unordered_set<int> peerIds;
+    for (int i = 0; i < numPeers; ++i) {
+        peerIds.insert(i);
+    }
+
+    NetworkConfig networkConfig(numPeers);
+    std::unordered_map<int, RumorMember> rumorMembers;
+    for (int i : peerIds) {
+        rumorMembers.insert(std::make_pair(i, RumorMember(peerIds, networkConfig, i)));
+    }
+
+    AsyncExecutor executor;
+    AsyncMembers members;
+    for (auto& kv : rumorMembers) {
+        members[kv.first].reset(new AsyncMember(kv.second, executor));
+    }
+
+    int numOld = 0;
+    for (auto& kv : members) {
+        roundLoop(*kv.second, members).start(executor);
+        receiveLoop(*kv.second, members).start(executor);
+        waitUntilOld(*kv.second, rumorId, numOld).start(executor);
+    }
+    executor.run();
+
+    EXPECT_TRUE(rumorMembers.at(0).addRumor(rumorId));
+
+    int maxNumOfRounds = 4 * networkConfig.maxRoundsTotal();
+    while (numOld < numPeers && maxNumOfRounds-- > 0) {
+        for (auto& kv : members) {
+            kv.second->tick();
+        }
+        executor.run();
+    }
+    EXPECT_EQ(numOld, numPeers);
+
+    // Closing completes the remaining loops so that every coroutine frame is released
+    for (auto& kv : members) {
+        kv.second->close();
+    }
+    executor.run();
+    EXPECT_TRUE(executor.empty());
+}
+
+TEST(TestAsync, Close_Completes_Pending_Awaits)
+{
+    std::unordered_set<int> peerIds = {0, 1};
+    RumorMember rumorMember(peerIds, 0);
+
+    AsyncExecutor executor;
+    AsyncMember member(rumorMember, executor);
+
+    int numOld = 0;
+    waitUntilOld(member, 42, numOld).start(executor);
+    executor.run();
+    EXPECT_EQ(executor.numResumed(), 1u);
+
+    member.close();
+    EXPECT_EQ(executor.run(), 1u);
+    EXPECT_EQ(numOld, 0);
+}
+
+TEST(TestAsync, Eviction_Completes_Old_Await)
+{
+    std::unordered_set<int> peerIds = {0, 1};
+    RumorMember rumorMember(peerIds, NetworkConfig(peerIds.size(), 1, 4, 8), 0);
+    rumorMember.setMaxRumors(1);
+
+    AsyncExecutor executor;
+    AsyncMember member(rumorMember, executor);
+
+    // Rumor 42 becomes KNOWN, then a received rumor evicts it
+    EXPECT_TRUE(rumorMember.addRumor(42));
+    for (int round = 0; round < 20 && rumorMember.numRumors(RumorStateMachine::State::KNOWN) == 0; ++round) {
+        member.tick();
+    }
+    ASSERT_EQ(rumorMember.numRumors(RumorStateMachine::State::KNOWN), 1u);
+
+    int numOld = 0;
+    waitUntilOld(member, 42, numOld).start(executor);
+    executor.run();
+    const size_t numResumed = executor.numResumed();
+
+    member.handle({Message(Message::Type::PUSH, 7, 0), 1});
+    EXPECT_FALSE(rumorMember.rumorExists(42));
+    EXPECT_EQ(executor.run(), 1u);
+    EXPECT_EQ(executor.numResumed(), numResumed + 1);
+    EXPECT_EQ(numOld, 0);
+    EXPECT_TRUE(executor.empty());
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    int ret = RUN_ALL_TESTS();
+    return ret;
+}
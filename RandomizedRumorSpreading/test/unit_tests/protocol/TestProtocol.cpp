@@ -1,11 +1,30 @@
 #include "TestProtocol.h"
 
 // STD
+#include <algorithm>
+#include <atomic>
 #include <condition_variable>
 #include <mutex>
+#include <random>
+#include <sstream>
 
 // RRS
+#include <AggregateSimulator.h>
 #include <MemberID.h>
+#include <CountingResource.h>
+#include <IntervalMap.h>
+#include <MessageView.h>
+#include <MonotonicArena.h>
+#include <PeerSchedule.h>
+#include <PhaseTimers.h>
+#include <RoundScheduler.h>
+#include <RoundTimerWheel.h>
+#include <RumorReader.h>
+#include <SizeEstimator.h>
+#include <StateTransfer.h>
+#include <TraceRecorder.h>
+#include <TraceReplayer.h>
+#include <WireFormat.h>
 #include <thread>
 #include <cmath>
 
@@ -18,23 +37,12 @@ void TestProtocol::constructNetwork(size_t numOfPeers)
     }
 
     for (auto i : m_peerIds) {
-        auto nextCb = [=]() { return nextId(i); };
-        m_members.insert(std::make_pair(i, RumorMember(m_peerIds, m_networkConfig, nextCb)));
+        m_members.insert(std::make_pair(i, RumorMember(m_peerIds, m_networkConfig, i)));
     }
-}
 
-int TestProtocol::nextId(int memberId) const
-{
-    static std::map<int, int> memberToLastIndex;
-    if (memberToLastIndex.count(memberId) <= 0) {
-        memberToLastIndex[memberId] = memberId;
-    }
-
-    int& idx = memberToLastIndex[memberId];
-    if (++idx == memberId) {
-        idx++;
+    for (auto& kv : m_members) {
+        m_tracker.track(kv.second);
     }
-    return idx % m_peerIds.size();
 }
 
 void TestProtocol::handleMessage(int fromMember, int toMember, const Message& msg)
@@ -58,6 +66,7 @@ TestProtocol::TestProtocol(size_t numPeers)
 : m_peerIds()
 , m_networkConfig(numPeers)
 , m_members()
+, m_tracker()
 , m_StringToRumorId()
 , m_rumorIdToStringPtr()
 , m_tickInterval(100)
@@ -130,12 +139,7 @@ const std::unordered_map<int, RRS::RumorMember>& TestProtocol::members() const
 
 bool TestProtocol::isRumorOld(int rumorId) const
 {
-    for (const auto& kv : m_members) {
-        if (!kv.second.isOld(rumorId)) {
-            return false;
-        }
-    }
-    return true;
+    return m_tracker.isOldEverywhere(rumorId);
 }
 
 bool TestProtocol::allRumorsOld() const
@@ -187,46 +191,1230 @@ TEST(TestProtocol, Spread_One_Rumor)
     testObj.addRumor(0, 0);
 
     // Schedule periodic ticks
-    std::thread([&]()
+    bool done = false;
+    std::thread ticker([&]()
     {
         // This is an estimation, need to replace random selection with a callback
         int maxNumOfRounds = 2 * testObj.networkConfig().maxRoundsTotal();
         while (!testObj.allRumorsOld() && maxNumOfRounds-- > 0) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (done) {
+                    break;
+                }
+            }
             testObj.tick();
             std::this_thread::sleep_for(testObj.tickInterval());
         }
 
         // mark as isOld and signal to exit
         std::lock_guard<std::mutex> lock(mutex);
+        done = true;
         doneCondVar.notify_one();
-    }).detach();
+    });
+
+    // Calculate timeout
+    int lnn = static_cast<int>(std::ceil(std::log(testObj.peers().size())));
+    std::chrono::milliseconds timeoutMs(2 * lnn * testObj.tickInterval());
 
-    // Schedule timeout
-    std::thread([&]()
+    // Wait for condition variable signal or timeout, then stop ticking
     {
-        // Calculate timeout and sleep
-        int lnn = static_cast<int>(std::ceil(std::log(testObj.peers().size())));
-        std::chrono::milliseconds timeoutMs(2 * lnn * testObj.tickInterval());
-        std::this_thread::sleep_for(std::chrono::milliseconds(timeoutMs));
+        std::unique_lock<std::mutex> lock(mutex);
+        doneCondVar.wait_for(lock, timeoutMs, [&]() { return done; });
+        done = true;
+    }
+    ticker.join();
 
-        // Notify done
-        std::lock_guard<std::mutex> lock(mutex);
-        doneCondVar.notify_one();
-    }).detach();
+    EXPECT_TRUE(testObj.allRumorsOld());
+
+    testObj.printRumorsState(std::cout) << std::endl;
+
+    std::cout << "Member statistics: [" << std::endl;
+    for (const auto& kv : testObj.members()) {
+        kv.second.printStatistics(std::cout) << "\n";
+    }
+    std::cout << "]" << std::endl;
+}
+
+TEST(TestProtocol, Add_Rumors_In_Bulk)
+{
+    std::unordered_set<int> peerIds = {0, 1, 2, 3};
+    RumorMember member(peerIds, 0);
+
+    EXPECT_TRUE(member.addRumor(5));
+
+    std::vector<bool> added = member.addRumors(0, 10);
+    ASSERT_EQ(added.size(), 10u);
+    for (int rumorId = 0; rumorId < 10; ++rumorId) {
+        EXPECT_EQ(added[rumorId], rumorId != 5);
+        EXPECT_TRUE(member.rumorExists(rumorId));
+    }
+    EXPECT_EQ(member.rumorsMap().size(), 10u);
+}
+
+TEST(TestProtocol, Rumors_Share_Cohorts)
+{
+    std::unordered_set<int> peerIds = {0, 1, 2, 3};
+    RumorMember member(peerIds, NetworkConfig(peerIds.size(), 3, 3, 6), 0);
+
+    member.addRumors(0, 1000);
+    EXPECT_EQ(member.numCohorts(), 1u);
+
+    member.advanceRound();
+    EXPECT_EQ(member.numCohorts(), 1u);
+
+    // Rumors that receive the same message in a round stay together
+    member.receivedMessage(Message(Message::Type::PUSH, 0, 1), 1);
+    member.receivedMessage(Message(Message::Type::PUSH, 1, 1), 1);
+    EXPECT_EQ(member.numCohorts(), 2u);
+
+    member.receivedMessage(Message(Message::Type::PUSH, 2, 1), 2);
+    EXPECT_EQ(member.numCohorts(), 3u);
+
+    // Rumors first received from the same member with the same age form one cohort
+    member.receivedMessage(Message(Message::Type::PULL, 2000, 1), 3);
+    member.receivedMessage(Message(Message::Type::PULL, 2001, 1), 3);
+    EXPECT_EQ(member.numCohorts(), 4u);
+
+    // Long runs of rumors are pushed as ranges
+    std::pair<int, std::vector<Message>> push = member.advanceRound();
+    size_t numPushed = 0;
+    for (const Message& message : push.second) {
+        numPushed += static_cast<size_t>(message.count());
+    }
+    EXPECT_EQ(numPushed, 1002u);
+    EXPECT_LT(push.second.size(), 1002u);
+    EXPECT_EQ(member.rumorsMap().size(), 1002u);
+}
+
+TEST(TestProtocol, Duplicate_Messages_Are_Ignored_And_Counted)
+{
+    std::unordered_set<int> peerIds = {0, 1, 2};
+    const NetworkConfig networkConfig(peerIds.size(), 3, 3, 6);
+    RumorMember member(peerIds, networkConfig, [] { return 1; }, 0);
+    RumorMember twin(peerIds, networkConfig, [] { return 1; }, 0);
+    for (RumorMember* m : {&member, &twin}) {
+        m->addRumors(0, 10);
+        m->advanceRound();
+    }
+
+    // The twin hears every rumor from member 1 once
+    EXPECT_FALSE(member.receivedMessage(Message(Message::Type::PUSH, 0, 1), 1).second.empty());
+    twin.receivedMessage(Message(Message::Type::PUSH, 0, 1), 1);
+    EXPECT_EQ(member.numCohorts(), 2u);
+
+    // A retransmit gets no PULL messages and changes nothing
+    EXPECT_TRUE(member.receivedMessage(Message(Message::Type::PUSH, 0, 1), 1).second.empty());
+    EXPECT_EQ(member.numCohorts(), 2u);
+
+    // Only the rumors not heard from member 1 yet take the age of a later message
+    member.receivedMessage(Message(Message::Type::PULL, 0, 5, 10), 1);
+    twin.receivedMessage(Message(Message::Type::PULL, 1, 5, 9), 1);
+    EXPECT_EQ(member.statistics().at(RumorMember::StatisticKey::NumDuplicateRumors), 2.0);
+
+    for (int round = 0; round < 8; ++round) {
+        EXPECT_EQ(member.advanceRound().second, twin.advanceRound().second);
+    }
+}
+
+TEST(TestProtocol, State_Changes_Are_Reported)
+{
+    typedef RumorStateMachine::State State;
+
+    std::unordered_set<int> peerIds = {0, 1};
+    RumorMember member(peerIds, NetworkConfig(peerIds.size(), 1, 1, 4), 0);
+
+    std::vector<std::pair<State, State>> changes;
+    member.addStateChangeCb([&](int memberId, int rumorId, State from, State to) {
+        EXPECT_EQ(memberId, 0);
+        EXPECT_EQ(rumorId, 7);
+        EXPECT_EQ(member.isOld(rumorId), to == State::OLD);
+        changes.emplace_back(from, to);
+    });
+
+    ConvergenceTracker tracker;
+    tracker.stateChanged(7, State::UNKNOWN, State::NEW);
+
+    member.addRumor(7);
+    member.advanceRound();
+    member.advanceRound();
+    member.advanceRound();
+
+    std::vector<std::pair<State, State>> expected = {
+        {State::UNKNOWN, State::NEW},
+        {State::NEW, State::KNOWN},
+        {State::KNOWN, State::OLD},
+    };
+    EXPECT_EQ(changes, expected);
+    EXPECT_EQ(tracker.counters(7).m_numLearned, 1u);
+}
+
+TEST(TestProtocol, Tracker_Forgets_Evicted_Rumors)
+{
+    typedef RumorStateMachine::State State;
 
-    // Wait for condition variable signal
+    const std::unordered_set<int> peers = {0, 1};
+    RumorMember member(peers, NetworkConfig(peers.size(), 1, 1, 4), 0);
+    member.setMaxRumors(15);
+    ConvergenceTracker tracker;
+    tracker.track(member);
+    auto advanceUntilOld = [&]() {
+        for (int round = 0; round < 20 && member.numRumors(State::OLD) < member.maxRumors(); ++round) {
+            member.advanceRound();
+        }
+    };
+
+    member.addRumors(0, 10);
+    advanceUntilOld();
+    EXPECT_TRUE(tracker.isOldEverywhere(0));
+    EXPECT_TRUE(tracker.allRumorsOld());
+
+    // The oldest rumors make room and no longer count
+    member.addRumors(100, 10);
+    ASSERT_FALSE(member.rumorExists(0));
+    EXPECT_EQ(tracker.counters(0).m_numLearned, 0u);
+    EXPECT_FALSE(tracker.isOldEverywhere(0));
+
+    // Learned again, the rumor counts once
+    member.receivedMessage(Message(Message::Type::PUSH, 0, 0), 1);
+    ASSERT_TRUE(member.rumorExists(0));
+    EXPECT_EQ(tracker.counters(0).m_numLearned, 1u);
+    EXPECT_EQ(tracker.counters(0).m_numOld, 0u);
+    EXPECT_FALSE(tracker.isOldEverywhere(0));
+    EXPECT_FALSE(tracker.allRumorsOld());
+
+    advanceUntilOld();
+    EXPECT_EQ(tracker.counters(0).m_numLearned, 1u);
+    EXPECT_EQ(tracker.counters(0).m_numKnown, 1u);
+    EXPECT_EQ(tracker.counters(0).m_numOld, 1u);
+    EXPECT_TRUE(tracker.isOldEverywhere(100));
+    EXPECT_TRUE(tracker.allRumorsOld());
+}
+
+TEST(TestProtocol, Round_Scheduler_Follows_Rumor_Activity)
+{
+    typedef RoundScheduler::Clock Clock;
+
+    std::unordered_set<int> peerIds = {0, 1};
+    RumorMember member(peerIds, NetworkConfig(peerIds.size(), 1, 3, 6), 0);
+    RoundScheduler scheduler(member, std::chrono::milliseconds(10), std::chrono::milliseconds(30));
+
+    // Nothing to spread
+    EXPECT_TRUE(scheduler.isIdle());
+
+    // A new rumor makes a round due right away
+    member.addRumor(7);
+    EXPECT_LE(scheduler.nextRoundAt(), Clock::now());
+
+    // NEW --> KNOWN, then back off while KNOWN
+    scheduler.advanceRound();
+    EXPECT_EQ(member.numRumors(RumorStateMachine::State::KNOWN), 1u);
+    EXPECT_EQ(scheduler.interval(), std::chrono::milliseconds(20));
+    scheduler.advanceRound();
+    EXPECT_EQ(scheduler.interval(), std::chrono::milliseconds(30));
+
+    // A rumor learned from a peer restores the fast interval
+    member.receivedMessage(Message(Message::Type::PUSH, 8, 0), 1);
+    EXPECT_EQ(scheduler.interval(), std::chrono::milliseconds(10));
+
+    // Idle once every rumor is OLD
+    int maxNumOfRounds = 10;
+    while (!scheduler.isIdle() && maxNumOfRounds-- > 0) {
+        scheduler.advanceRound();
+    }
+    EXPECT_TRUE(member.isOld(7));
+    EXPECT_TRUE(member.isOld(8));
+    EXPECT_TRUE(scheduler.isIdle());
+
+    // A driver thread blocked on the idle scheduler runs the rounds of a new rumor
+    int numRounds = 0;
+    std::thread driver([&]() {
+        while (scheduler.waitForRound()) {
+            scheduler.advanceRound();
+            ++numRounds;
+        }
+    });
+    member.addRumor(9);
+    maxNumOfRounds = 100;
+    while (!member.isOld(9) && maxNumOfRounds-- > 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_TRUE(member.isOld(9));
+    EXPECT_TRUE(scheduler.isIdle());
+
+    scheduler.stop();
+    driver.join();
+    EXPECT_GE(numRounds, 4);
+}
+
+TEST(TestProtocol, Interval_Map_Merges_And_Splits)
+{
+    IntervalMap map;
+    map.assign(0, 100, 1);
+    map.assign(100, 200, 1);
+    EXPECT_EQ(map.numIntervals(), 1u);
+    EXPECT_EQ(map.size(), 200u);
+
+    // Overwrite the middle
+    map.assign(50, 60, 2);
+    EXPECT_EQ(map.numIntervals(), 3u);
+    EXPECT_EQ(map.size(), 200u);
+
+    int value = -1;
+    EXPECT_TRUE(map.find(49, value));
+    EXPECT_EQ(value, 1);
+    EXPECT_TRUE(map.find(50, value));
+    EXPECT_EQ(value, 2);
+    EXPECT_TRUE(map.find(60, value));
+    EXPECT_EQ(value, 1);
+    EXPECT_FALSE(map.contains(200));
+    EXPECT_FALSE(map.contains(-1));
+
+    std::vector<std::tuple<int, int, int>> ranges;
+    map.forEach(40, 70, [&](int first, int end, int v) { ranges.emplace_back(first, end, v); });
+    std::vector<std::tuple<int, int, int>> expected = {
+        std::make_tuple(40, 50, 1), std::make_tuple(50, 60, 2), std::make_tuple(60, 70, 1)};
+    EXPECT_EQ(ranges, expected);
+
+    // Restoring the value merges the intervals again
+    map.assign(50, 60, 1);
+    EXPECT_EQ(map.numIntervals(), 1u);
+
+    map.erase(10, 20);
+    EXPECT_EQ(map.numIntervals(), 2u);
+    EXPECT_EQ(map.size(), 190u);
+    EXPECT_FALSE(map.contains(15));
+}
+
+TEST(TestProtocol, Range_Messages_Cover_Consecutive_Rumors)
+{
+    std::unordered_set<int> peerIds = {0, 1};
+    RumorMember sender(peerIds, 0);
+    RumorMember receiver(peerIds, 1);
+    sender.setRangeMessages(true);
+
+    sender.addRumors(0, 10000);
+    sender.addRumor(20000);
+
+    std::pair<int, std::vector<Message>> push = sender.advanceRound();
+    std::vector<Message> expected = {
+        Message(Message::Type::PUSH, 0, 1, 10000),
+        Message(Message::Type::PUSH, 20000, 1),
+    };
+    EXPECT_EQ(push.second, expected);
+
+    for (const Message& message : push.second) {
+        receiver.receivedMessage(message, sender.id());
+    }
+    EXPECT_TRUE(receiver.rumorExists(0));
+    EXPECT_TRUE(receiver.rumorExists(9999));
+    EXPECT_FALSE(receiver.rumorExists(10000));
+    EXPECT_TRUE(receiver.rumorExists(20000));
+    EXPECT_EQ(receiver.numCohorts(), 1u);
+    EXPECT_EQ(receiver.numRumors(RumorStateMachine::State::NEW), 10001u);
+
+    // Without range messages short runs are listed rumor by rumor, but a long run received as one
+    // range is answered with one range rather than a message per rumor
+    receiver.receivedMessage(Message(Message::Type::PUSH, 30000, 1, RumorMember::k_maxExpandedRumors), sender.id());
+    receiver.advanceRound();
+    std::pair<int, std::vector<Message>> pull = receiver.receivedMessage(Message(Message::Type::PUSH, -1, 0), 0);
+    ASSERT_EQ(pull.second.size(), 2u + RumorMember::k_maxExpandedRumors);
+    EXPECT_EQ(pull.second[0].rumorId(), 0);
+    EXPECT_EQ(pull.second[0].count(), 10000);
+    for (size_t i = 1; i < pull.second.size(); ++i) {
+        EXPECT_EQ(pull.second[i].count(), 1);
+    }
+    EXPECT_EQ(pull.second.back().rumorId(), 30000 + RumorMember::k_maxExpandedRumors - 1);
+
+    // A flood of rumors in one message is answered with one message
+    RumorMember flooded(peerIds, 1);
+    flooded.receivedMessage(Message(Message::Type::PUSH, 0, 1, 1 << 24), sender.id());
+    flooded.advanceRound();
+    pull = flooded.receivedMessage(Message(Message::Type::PUSH, -1, 0), 0);
+    ASSERT_EQ(pull.second.size(), 1u);
+    EXPECT_EQ(pull.second[0].count(), 1 << 24);
+}
+
+TEST(TestProtocol, Overlapping_Range_Messages_Commute)
+{
+    // Member 6 sends the rumors at the age that makes them KNOWN, member 5 at age 0
+    const std::unordered_set<int> peerIds = {0, 5, 6};
+    const NetworkConfig networkConfig(peerIds.size(), 3, 4, 20);
+    const Message fromFiveHead(Message::Type::PUSH, 0, 0, 5);
+    const Message fromSix(Message::Type::PUSH, 0, networkConfig.maxRoundsInB(), 10);
+    const Message fromFiveTail(Message::Type::PUSH, 5, 0, 3);
+
+    auto deliver = [&](const std::vector<std::pair<Message, int>>& messages) {
+        RumorMember member(peerIds, networkConfig, 0);
+        member.addRumors(0, 10);
+        member.advanceRound();
+        for (const auto& message : messages) {
+            member.receivedMessage(message.first, message.second);
+        }
+        member.advanceRound();
+        return member.rumorsMap();
+    };
+    const std::unordered_map<int, RumorStateMachine> inOrder = deliver({{fromFiveHead, 5}, {fromSix, 6}, {fromFiveTail, 5}});
+    const std::unordered_map<int, RumorStateMachine> reordered = deliver({{fromSix, 6}, {fromFiveHead, 5}, {fromFiveTail, 5}});
+    ASSERT_EQ(inOrder.size(), 10u);
+    for (int rumorId = 0; rumorId < 10; ++rumorId) {
+        EXPECT_EQ(inOrder.at(rumorId).state(), RumorStateMachine::State::KNOWN) << "rumor " << rumorId;
+        EXPECT_EQ(inOrder.at(rumorId).state(), reordered.at(rumorId).state()) << "rumor " << rumorId;
+    }
+}
+
+TEST(TestProtocol, Silent_Peers_Are_Suspected)
+{
+    std::unordered_set<int> peerIds;
+    for (int i = 0; i < 10; ++i) {
+        peerIds.insert(i);
+    }
+    RumorMember member(peerIds, 0);
+    member.trackLiveness(2, 4);
+    member.addRumor(7);
+
+    // Peer 9 is down, every other peer answers each PUSH with an empty PULL
+    bool isDown = true;
+    int numPushesToDown = 0;
+    auto round = [&]() {
+        const int to = member.advanceRound().first;
+        if (to == 9) {
+            ++numPushesToDown;
+            if (isDown) {
+                return;
+            }
+        }
+        member.receivedMessage(Message(Message::Type::PULL, -1, 0), to);
+    };
+
+    for (int i = 0; i < 200; ++i) {
+        round();
+    }
+    EXPECT_EQ(member.numSuspectedPeers(), 1u);
+
+    // Only probes reach the suspected peer, 4, 8, 16, 32, 64 then 64 rounds apart
+    numPushesToDown = 0;
+    for (int i = 0; i < 200; ++i) {
+        round();
+    }
+    EXPECT_GE(numPushesToDown, 3);
+    EXPECT_LE(numPushesToDown, 6);
+
+    // Once it answers a probe it is selected like any other peer
+    isDown = false;
+    int maxNumOfRounds = 8 * PeerLiveness::k_maxProbeBackoff;
+    while (member.numSuspectedPeers() > 0 && maxNumOfRounds-- > 0) {
+        round();
+    }
+    EXPECT_EQ(member.numSuspectedPeers(), 0u);
+}
+
+TEST(TestProtocol, Peer_Schedule_Visits_Every_Peer_Once_Per_Epoch)
+{
+    const std::vector<int> peers = {3, 5, 8, 13, 21};
+    PeerSchedule schedule(peers, 42);
+    EXPECT_EQ(schedule.size(), peers.size());
+
+    for (int epoch = 0; epoch < 10; ++epoch) {
+        std::vector<int> visited;
+        for (size_t i = 0; i < peers.size(); ++i) {
+            visited.push_back(schedule.next());
+        }
+        std::sort(visited.begin(), visited.end());
+        EXPECT_EQ(visited, peers);
+    }
+
+    EXPECT_EQ(PeerSchedule().next(), -1);
+}
+
+TEST(TestProtocol, Peer_Schedule_Prefers_Local_Peers)
+{
+    const std::vector<int> localPeers = {1, 2};
+    const std::vector<int> remotePeers = {3, 4, 5, 6};
+    PeerSchedule schedule(localPeers, remotePeers, 0.25, 42);
+    EXPECT_EQ(schedule.size(), localPeers.size() + remotePeers.size());
+
+    const int numDraws = 4000;
+    std::map<int, int> counts;
+    for (int i = 0; i < numDraws; ++i) {
+        ++counts[schedule.next()];
+    }
+    EXPECT_EQ(counts.size(), localPeers.size() + remotePeers.size());
+    const int numRemote = counts[3] + counts[4] + counts[5] + counts[6];
+    EXPECT_NEAR(numRemote, numDraws / 4, numDraws / 20);
+
+    // Without local peers every draw is remote
+    PeerSchedule remoteOnly({}, remotePeers, 0.25, 42);
+    for (size_t i = 0; i < 2 * remotePeers.size(); ++i) {
+        EXPECT_GE(remoteOnly.next(), 3);
+    }
+}
+
+TEST(TestProtocol, Phase_Timers_Cover_Hot_Paths)
+{
+    const std::unordered_set<int> peers = {0, 1};
+    RumorMember sender(peers, 0);
+    RumorMember receiver(peers, 1);
+    sender.addRumor(7);
+
+    const std::vector<Message> pushMessages = sender.advanceRound().second;
+    for (const Message& message : pushMessages) {
+        receiver.receivedMessage(message, 0);
+    }
+
+    const PhaseTimers::Snapshot senderTimes = sender.phaseTimes();
+    const PhaseTimers::Snapshot receiverTimes = receiver.phaseTimes();
+    auto count = [](const PhaseTimers::Snapshot& snapshot, PhaseTimers::Phase phase) {
+        return snapshot[static_cast<size_t>(phase)].m_count;
+    };
+
+    if (!PhaseTimers::k_enabled) {
+        for (const PhaseTimers::Histogram& histogram : receiverTimes) {
+            EXPECT_EQ(histogram.m_count, 0u);
+            EXPECT_EQ(histogram.percentile(0.99), 0);
+        }
+        return;
+    }
+
+    // One lock per call, each of which updates state and builds messages
+    EXPECT_EQ(count(senderTimes, PhaseTimers::Phase::LOCK_WAIT), 1u);
+    EXPECT_EQ(count(senderTimes, PhaseTimers::Phase::STATE_UPDATE), 1u);
+    EXPECT_EQ(count(senderTimes, PhaseTimers::Phase::MESSAGE_BUILD), 1u);
+    EXPECT_EQ(count(receiverTimes, PhaseTimers::Phase::LOCK_WAIT), pushMessages.size());
+    EXPECT_EQ(count(receiverTimes, PhaseTimers::Phase::MESSAGE_BUILD), 1u);
+
+    // The rumor was learned, which is not reported without callbacks
+    EXPECT_EQ(count(receiverTimes, PhaseTimers::Phase::CALLBACKS), 0u);
+
+    const PhaseTimers::Histogram& update = receiverTimes[static_cast<size_t>(PhaseTimers::Phase::STATE_UPDATE)];
+    EXPECT_EQ(update.m_count, 2u);
+    EXPECT_GT(update.m_totalNs, 0);
+    EXPECT_LE(update.percentile(0.5), update.percentile(1.0));
+    EXPECT_LE(update.percentile(1.0), update.m_maxNs);
+    EXPECT_NEAR(update.meanNs() * update.m_count, update.m_totalNs, 1e-6);
+
+    // Copies carry the histograms along
+    RumorMember copy(receiver);
+    EXPECT_EQ(copy.phaseTimes()[static_cast<size_t>(PhaseTimers::Phase::STATE_UPDATE)].m_count, 2u);
+}
+
+TEST(TestProtocol, Size_Estimator_Tracks_Membership)
+{
+    const int epochRounds = 10;
+    auto startEpoch = [&](SizeEstimator& estimator, int epoch) {
+        while (estimator.epoch() < epoch) {
+            estimator.newRound();
+        }
+    };
+
+    // Member 0 hears every other member's own register
+    SizeEstimator estimator(0, epochRounds);
+    EXPECT_NEAR(estimator.estimate(), 1, 0.1);
+    for (int id = 1; id < 1000; ++id) {
+        estimator.sampleReceived(SizeEstimator(id, epochRounds).nextSample());
+    }
+    EXPECT_NEAR(estimator.estimate(), 1000, 250);
+
+    // Repeated samples change nothing
+    const double estimate = estimator.estimate();
+    for (int id = 1; id < 1000; ++id) {
+        estimator.sampleReceived(SizeEstimator(id, epochRounds).nextSample());
+    }
+    EXPECT_EQ(estimator.estimate(), estimate);
+
+    // A sample from a later epoch starts that epoch, the previous estimate stays until it is over
+    SizeEstimator ahead(1, epochRounds);
+    startEpoch(ahead, 1);
+    estimator.sampleReceived(ahead.nextSample());
+    EXPECT_EQ(estimator.epoch(), 1);
+    EXPECT_NEAR(estimator.currentEstimate(), 2, 0.5);
+    EXPECT_EQ(estimator.estimate(), estimate);
+
+    // Only 100 members are left, which shows once the epoch is over
+    for (int epoch = 1; epoch <= 2; ++epoch) {
+        startEpoch(estimator, epoch);
+        for (int id = 1; id < 100; ++id) {
+            SizeEstimator member(id, epochRounds);
+            startEpoch(member, epoch);
+            estimator.sampleReceived(member.nextSample());
+        }
+    }
+    EXPECT_NEAR(estimator.estimate(), 100, 25);
+
+    // Samples of earlier epochs are ignored
+    estimator.sampleReceived(SizeEstimator(5000, epochRounds).nextSample());
+    EXPECT_EQ(estimator.epoch(), 2);
+}
+
+TEST(TestProtocol, Copies_Follow_Their_Own_Network_Config)
+{
+    // Configured for 1000 members but only knows one peer: once the size is estimated, the round
+    // limits shrink to those of 2 members
+    const std::unordered_set<int> peerIds = {0, 1};
+    auto makeMember = [&]() {
+        RumorMember member(peerIds, NetworkConfig(1000), [] { return 1; }, 0);
+        member.addRumor(7);
+        return member;
+    };
+
+    RumorMember original = makeMember();
+    RumorMember copied(original);
+    RumorMember moved(makeMember());
+    RumorMember reference = makeMember();
+    for (RumorMember* member : {&copied, &moved, &reference}) {
+        member->estimateNetworkSize(4);
+    }
+
+    // The copies age their rumor against their own configuration, not that of the member they
+    // were made from, which keeps the limits of 1000 members
+    int round = 0;
+    for (; !reference.isOld(7) && round < 100; ++round) {
+        for (RumorMember* member : {&original, &copied, &moved, &reference}) {
+            member->advanceRound();
+        }
+        EXPECT_EQ(copied.isOld(7), reference.isOld(7));
+        EXPECT_EQ(moved.isOld(7), reference.isOld(7));
+    }
+    EXPECT_EQ(reference.networkConfig(), NetworkConfig(2));
+    EXPECT_FALSE(original.isOld(7));
+    EXPECT_LT(round, NetworkConfig(1000).maxRoundsTotal());
+}
+
+TEST(TestProtocol, Readers_See_Published_Views)
+{
+    const std::unordered_set<int> peers = {0, 1};
+    RumorMember member(peers, NetworkConfig(peers.size(), 1, 1, 3), 0);
+    RumorReader reader(member);
+    EXPECT_FALSE(reader.rumorExists(7));
+
+    // Consecutive rumors with the same state share a range
+    member.addRumors(0, 10);
+    member.addRumor(20);
+    EXPECT_TRUE(reader.rumorExists(7));
+    EXPECT_FALSE(reader.rumorExists(10));
+    EXPECT_TRUE(reader.rumorExists(20));
+    EXPECT_EQ(reader.view().ranges().size(), 2u);
+    EXPECT_EQ(reader.view().version(), member.viewVersion());
+
+    // Rounds that change no state publish nothing
+    const unsigned long version = member.viewVersion();
+    member.receivedMessage(Message(Message::Type::PULL, 5, 0), 1);
+    EXPECT_EQ(member.viewVersion(), version);
+
+    // Readers on other threads never block the member and never see an OLD rumor become NEW
+    std::atomic<bool> done(false);
+    std::atomic<int> numRegressions(0);
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 4; ++i) {
+        readers.emplace_back([&]() {
+            RumorReader threadReader(member);
+            bool wasOld = false;
+            while (!done) {
+                const bool isOld = threadReader.isOld(7);
+                if (wasOld && !isOld) {
+                    ++numRegressions;
+                }
+                wasOld = isOld;
+            }
+        });
+    }
+
+    int maxNumOfRounds = 10;
+    while (!member.isOld(7) && maxNumOfRounds-- > 0) {
+        member.advanceRound();
+        member.receivedMessage(Message(Message::Type::PULL, -1, 0), 1);
+    }
+    done = true;
+    for (std::thread& thread : readers) {
+        thread.join();
+    }
+
+    EXPECT_TRUE(member.isOld(7));
+    EXPECT_TRUE(reader.isOld(20));
+    EXPECT_EQ(numRegressions, 0);
+    EXPECT_EQ(reader.view().ranges().size(), 2u);
+}
+
+TEST(TestProtocol, Views_Follow_Rumors_Learned_One_By_One)
+{
+    const std::unordered_set<int> peers = {0, 1};
+    RumorMember member(peers, NetworkConfig(peers.size(), 1, 1, 3), 0);
+    std::vector<int> rumorIds;
+    for (int i = 0; i < 1000; ++i) {
+        rumorIds.push_back(3 * i);
+    }
+    std::shuffle(rumorIds.begin(), rumorIds.end(), std::mt19937(7));
+
+    // Each learned rumor is visible as soon as the call returns
+    for (const int rumorId : rumorIds) {
+        member.receivedMessage(Message(Message::Type::PUSH, rumorId, 0), 1);
+        member.addRumor(rumorId + 1);
+        EXPECT_TRUE(member.rumorExists(rumorId));
+        EXPECT_TRUE(member.rumorExists(rumorId + 1));
+        EXPECT_FALSE(member.rumorExists(rumorId + 2));
+    }
+    std::vector<RumorView::Range> ranges = member.view()->ranges();
+    ASSERT_EQ(ranges.size(), 1000u);
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_EQ(ranges[i].m_first, 3 * i);
+        EXPECT_EQ(ranges[i].m_end, 3 * i + 2);
+        EXPECT_FALSE(ranges[i].m_isOld);
+    }
+
+    // A rumor received past the maximum age is learned as OLD
+    member.receivedMessage(Message(Message::Type::PUSH, 4000, 4), 1);
+    EXPECT_TRUE(member.rumorExists(4000));
+    EXPECT_TRUE(member.isOld(4000));
+
+    // State changes and evictions publish a view of the whole table
+    int maxNumOfRounds = 10;
+    while (member.numRumors(RumorStateMachine::State::OLD) < 2000 && maxNumOfRounds-- > 0) {
+        member.advanceRound();
+    }
+    member.setMaxRumors(1500);
+    member.addRumor(5000);
+    const std::unordered_map<int, RumorStateMachine> rumors = member.rumorsMap();
+    for (int rumorId = 0; rumorId <= 5000; ++rumorId) {
+        const auto& iter = rumors.find(rumorId);
+        EXPECT_EQ(member.rumorExists(rumorId), iter != rumors.end()) << "rumor " << rumorId;
+        EXPECT_EQ(member.isOld(rumorId), iter != rumors.end() && iter->second.isOld()) << "rumor " << rumorId;
+    }
+    EXPECT_LT(rumors.size(), 2000u);
+}
+
+TEST(TestProtocol, Timer_Wheel_Matches_Per_Round_Advance)
+{
+    RoundTimerWheel wheel;
+    wheel.schedule(3, 1);
+    wheel.schedule(3 + static_cast<int>(RoundTimerWheel::k_numBuckets), 2);
+    wheel.schedule(5, 3);
+    std::vector<int> due;
+    wheel.expire(3, due);
+    EXPECT_EQ(due, std::vector<int>({1}));
+    EXPECT_EQ(wheel.size(), 2u);
+
+    // Rumors added in different rounds are KNOWN and OLD at different times. Their ages must be
+    // the same as if every state machine was advanced in every round.
+    const std::unordered_set<int> peers = {0, 1};
+    const NetworkConfig networkConfig(peers.size(), 1, 4, 9);
+    RumorMember member(peers, networkConfig, 0);
+    std::map<int, RumorStateMachine> expected;
+    const RumorStateMachine::PeerSet noPeers;
+    for (int round = 0; round < 30; ++round) {
+        if (round < 12) {
+            member.addRumor(round);
+            expected[round] = RumorStateMachine(&networkConfig);
+        }
+
+        const std::vector<Message> pushMessages = member.advanceRound().second;
+        for (auto& kv : expected) {
+            kv.second.advanceRound(noPeers);
+        }
+
+        ASSERT_EQ(pushMessages.size(), expected.size());
+        for (const Message& message : pushMessages) {
+            const RumorStateMachine& stateMachine = expected.at(message.rumorId());
+            EXPECT_EQ(message.age(), stateMachine.age()) << "rumor " << message.rumorId() << " round " << round;
+            EXPECT_EQ(member.isOld(message.rumorId()), stateMachine.isOld());
+        }
+
+        const auto rumors = member.rumorsMap();
+        for (const auto& kv : expected) {
+            EXPECT_EQ(rumors.at(kv.first).state(), kv.second.state());
+        }
+    }
+    EXPECT_EQ(member.numRumors(RumorStateMachine::State::OLD), expected.size());
+}
+
+TEST(TestProtocol, Wire_Format_Round_Trip)
+{
+    std::vector<Message> messages = {
+        Message(Message::Type::PUSH, 1, 2),
+        Message(Message::Type::PUSH, 2, 3),
+        Message(Message::Type::PUSH, 3, 200),
+        Message(Message::Type::PUSH, 10, 2, 500),
+        Message(Message::Type::PUSH, 7, 0),
+        Message(Message::Type::PULL, -1, 0),
+        Message(Message::Type::PUSH, INT32_MAX - 1, 1),
+        Message(Message::Type::PUSH, INT32_MIN, 1),
+    };
+    messages[3].setSizeSample(0x8123456789abcdefULL);
+    for (int i = 0; i < 20; ++i) {
+        messages.emplace_back(Message::Type::PUSH, 100 + i, i % 4);
+    }
+
+    std::vector<char> frame(WireFormat::maxFrameSize(messages.size()));
+    const size_t size = WireFormat::encode(5, messages.data(), messages.size(), frame.data());
+    EXPECT_EQ(size, WireFormat::frameSize(messages.data(), messages.size()));
+    // Consecutive rumors with small ages take 3 bytes each
+    EXPECT_LT(size, WireFormat::k_headerSize + 3 * messages.size() + 40);
+
+    int fromMember = -1;
+    std::vector<Message> decoded;
+    EXPECT_TRUE(WireFormat::decode(frame.data(), size, fromMember, decoded));
+    EXPECT_EQ(fromMember, 5);
+    EXPECT_EQ(decoded, messages);
+    EXPECT_EQ(decoded[3].sizeSample(), messages[3].sizeSample());
+    EXPECT_EQ(decoded[0].sizeSample(), 0u);
+
+    EXPECT_FALSE(WireFormat::decode(frame.data(), size - 1, fromMember, decoded));
+    for (size_t i = 0; i < size; ++i) {
+        // Any corrupted byte is caught by the checksum or the header checks
+        frame[i] ^= 0x10;
+        EXPECT_FALSE(WireFormat::decode(frame.data(), size, fromMember, decoded)) << "byte " << i;
+        frame[i] ^= 0x10;
+    }
+
+    std::vector<char> empty(WireFormat::maxFrameSize(0));
+    EXPECT_EQ(WireFormat::encode(3, nullptr, 0, empty.data()), WireFormat::k_headerSize);
+    EXPECT_TRUE(WireFormat::decode(empty.data(), WireFormat::k_headerSize, fromMember, decoded));
+    EXPECT_EQ(fromMember, 3);
+    EXPECT_TRUE(decoded.empty());
+}
+
+TEST(TestProtocol, Wire_Format_Rejects_Malformed_Entries)
+{
+    auto decodes = [](const std::vector<Message>& messages) {
+        std::vector<char> frame(WireFormat::maxFrameSize(messages.size()));
+        const size_t size = WireFormat::encode(5, messages.data(), messages.size(), frame.data());
+        int fromMember;
+        std::vector<Message> decoded;
+        const bool valid = WireFormat::decode(frame.data(), size, fromMember, decoded);
+        EXPECT_EQ(MessageView(frame.data(), size).valid(), valid);
+        return valid;
+    };
+
+    EXPECT_TRUE(decodes({Message(Message::Type::PUSH, INT32_MAX - 4, 1, 4)}));
+
+    // Undefined type, as a short entry, a pair of short entries and a long entry
+    EXPECT_FALSE(decodes({Message(Message::Type::UNDEFINED, 1, 0)}));
+    EXPECT_FALSE(decodes({Message(Message::Type::UNDEFINED, 1, 0), Message(Message::Type::UNDEFINED, 2, 0)}));
+    EXPECT_FALSE(decodes({Message(Message::Type::PUSH, 1, 0), Message(Message::Type::UNDEFINED, 2, 0)}));
+    EXPECT_FALSE(decodes({Message(Message::Type::UNDEFINED, 1, 0, 10)}));
+
+    // An age that does not fit an 'int'
+    EXPECT_FALSE(decodes({Message(Message::Type::PUSH, 1, -1)}));
+
+    // No rumors
+    EXPECT_FALSE(decodes({Message(Message::Type::PUSH, 1, 0, 0)}));
+
+    // Ranges going past the largest rumor ID
+    EXPECT_FALSE(decodes({Message(Message::Type::PUSH, INT32_MAX, 1)}));
+    EXPECT_FALSE(decodes({Message(Message::Type::PUSH, INT32_MAX - 4, 1, 5)}));
+    EXPECT_FALSE(decodes({Message(Message::Type::PUSH, INT32_MAX - 1, 1), Message(Message::Type::PUSH, INT32_MAX, 1)}));
+
+    // A member ignores such a range
+    const std::unordered_set<int> peers = {0, 1};
+    RumorMember member(peers, 0);
+    member.receivedMessage(Message(Message::Type::PUSH, INT32_MAX - 4, 1, 5), 1);
+    EXPECT_FALSE(member.rumorExists(INT32_MAX - 4));
+}
+
+TEST(TestProtocol, Message_View_Iterates_In_Place)
+{
+    std::vector<Message> messages;
+    for (int i = 0; i < 9; ++i) {
+        messages.emplace_back(Message::Type::PUSH, 40 - 3 * i, i, 1 + i % 2);
+    }
+    messages[4].setSizeSample(42);
+    std::vector<char> frame(WireFormat::maxFrameSize(messages.size()));
+    const size_t size = WireFormat::encode(8, messages.data(), messages.size(), frame.data());
+
+    const MessageView view(frame.data(), size);
+    ASSERT_TRUE(view.valid());
+    EXPECT_EQ(view.fromMember(), 8);
+    EXPECT_EQ(view.size(), messages.size());
+    const std::vector<Message> iterated(view.begin(), view.end());
+    EXPECT_EQ(iterated, messages);
+    EXPECT_EQ(iterated[4].sizeSample(), 42u);
+
+    size_t numMessages = 0;
+    for (const Message& message : view) {
+        EXPECT_EQ(message, messages[numMessages++]);
+    }
+    EXPECT_EQ(numMessages, messages.size());
+
+    const MessageView truncated(frame.data(), size - 2);
+    EXPECT_FALSE(truncated.valid());
+    EXPECT_TRUE(truncated.empty());
+    EXPECT_TRUE(truncated.begin() == truncated.end());
+}
+
+TEST(TestProtocol, Arena_Reuses_Its_Largest_Chunk)
+{
+    CountingResource upstream;
     {
-        std::unique_lock<std::mutex> lock(mutex);
-        doneCondVar.wait(lock);
-        EXPECT_TRUE(testObj.allRumorsOld());
+        MonotonicArena arena(&upstream, 256);
+        size_t numAllocations = 0;
+        for (int round = 0; round < 4; ++round) {
+            numAllocations = upstream.numAllocations();
+            for (int i = 0; i < 100; ++i) {
+                void* p = arena.allocate(1 + i % 24, 8);
+                EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % 8, 0u);
+                arena.deallocate(p, 1 + i % 24, 8);
+            }
+            EXPECT_GE(arena.bytesAllocated(), 100u);
+            arena.release();
+            EXPECT_EQ(arena.bytesAllocated(), 0u);
+        }
+        // Once the kept chunk holds a round, rounds no longer allocate
+        EXPECT_EQ(upstream.numAllocations(), numAllocations);
+        EXPECT_EQ(upstream.bytesInUse(), arena.bytesReserved());
+    }
+    EXPECT_EQ(upstream.bytesInUse(), 0u);
+    EXPECT_GT(upstream.peakBytes(), 0u);
+}
+
+TEST(TestProtocol, Memory_Usage_Is_Accounted)
+{
+    const std::unordered_set<int> peers = {0, 1, 2, 3};
+    CountingResource upstream;
+    {
+        RumorMember member(peers, NetworkConfig(peers.size()), 0, &upstream);
+        const RumorMember::MemoryUsage empty = member.memoryUsage();
+        EXPECT_EQ(empty.m_rumors, 0u);
+        EXPECT_GT(empty.m_peers, 0u);
+
+        for (int i = 0; i < 50; ++i) {
+            member.addRumor(3 * i);
+        }
+        for (int peer = 1; peer < 4; ++peer) {
+            member.receivedMessage(Message(Message::Type::PUSH, 1000 + peer, 0), peer);
+        }
+        const RumorMember::MemoryUsage usage = member.memoryUsage();
+        EXPECT_GT(usage.m_rumors, empty.m_rumors);
+        EXPECT_GT(usage.m_cohorts, empty.m_cohorts);
+        EXPECT_GT(usage.m_roundState, 0u);
+        EXPECT_GT(usage.m_view, empty.m_view);
+        EXPECT_EQ(usage.total(), usage.m_rumors + usage.m_cohorts + usage.m_roundState + usage.m_peers + usage.m_view);
+        EXPECT_GE(upstream.bytesInUse(), usage.m_rumors + usage.m_roundState);
+
+        // Copies allocate from the same upstream resource, moves take the memory along
+        RumorMember copy(member);
+        EXPECT_EQ(copy.memoryUsage().m_rumors, usage.m_rumors);
+        RumorMember moved(std::move(copy));
+        EXPECT_EQ(moved.memoryUsage().m_rumors, usage.m_rumors);
+
+        for (int round = 0; round < 40; ++round) {
+            member.advanceRound();
+            moved.advanceRound();
+        }
+        EXPECT_EQ(member.numRumors(RumorStateMachine::State::OLD), 53u);
+        EXPECT_EQ(member.memoryUsage().m_rumors, usage.m_rumors);
+    }
+    // Everything was given back
+    EXPECT_EQ(upstream.bytesInUse(), 0u);
+    EXPECT_GT(upstream.numAllocations(), 0u);
+}
+
+TEST(TestProtocol, Replay_Reproduces_Recorded_Outputs)
+{
+    const int n = 8;
+    std::unordered_set<int> peerIds;
+    for (int i = 0; i < n; ++i) {
+        peerIds.insert(i);
+    }
+    std::mt19937 gen(5);
+    std::vector<RumorMember> members;
+    members.reserve(n);
+    for (int i = 0; i < n; ++i) {
+        auto nextCb = [&gen, i]() {
+            int peer = std::uniform_int_distribution<int>(0, n - 2)(gen);
+            return peer >= i ? peer + 1 : peer;
+        };
+        members.emplace_back(peerIds, NetworkConfig(n), nextCb, i);
+    }
+
+    std::ostringstream trace;
+    TraceRecorder recorder(trace);
+    members[0].record(&recorder);
+    members[0].setRangeMessages(true);
+    members[0].trackLiveness(2, 4);
+    members[0].estimateNetworkSize(8);
+
+    // Every output of member 0
+    std::vector<std::pair<int, std::vector<Message>>> outputs;
+    auto deliver = [&](int to, const Message& message, int from) {
+        const std::pair<int, std::vector<Message>> output = members[to].receivedMessage(message, from);
+        if (to == 0) {
+            outputs.push_back(output);
+        }
+        return output;
+    };
+    for (int round = 0; round < 30; ++round) {
+        if (round < 10) {
+            members[round % n].addRumors(100 * round, 3);
+        }
+        for (int from = 0; from < n; ++from) {
+            const std::pair<int, std::vector<Message>> push = members[from].advanceRound();
+            if (from == 0 && push.first >= 0) {
+                outputs.push_back(push);
+            }
+            for (const Message& pushMsg : push.second) {
+                const std::pair<int, std::vector<Message>> pull = deliver(push.first, pushMsg, from);
+                for (const Message& pullMsg : pull.second) {
+                    deliver(pull.first, pullMsg, push.first);
+                }
+            }
+        }
+    }
+    members[0].record(nullptr);
+    recorder.flush();
+    EXPECT_EQ(recorder.numRecords(), outputs.size() + 10 / n + 1 + 3);
+
+    std::istringstream in(trace.str());
+    TraceReplayer replayer(in);
+    ASSERT_TRUE(replayer.valid());
+    size_t numOutputs = 0;
+    while (replayer.step()) {
+        if (replayer.lastRecord() == TraceRecorder::Record::RECEIVED ||
+            replayer.lastRecord() == TraceRecorder::Record::ROUND) {
+            ASSERT_LT(numOutputs, outputs.size());
+            EXPECT_EQ(replayer.lastOutput(), outputs[numOutputs]) << "output " << numOutputs;
+            ++numOutputs;
+        }
+    }
+    EXPECT_FALSE(replayer.failed());
+    EXPECT_EQ(numOutputs, outputs.size());
+    EXPECT_EQ(replayer.numRecords(), recorder.numRecords());
+    for (const auto state : {RumorStateMachine::State::NEW, RumorStateMachine::State::KNOWN, RumorStateMachine::State::OLD}) {
+        EXPECT_EQ(replayer.member().numRumors(state), members[0].numRumors(state));
+    }
+    EXPECT_EQ(replayer.member().estimatedNetworkSize(), members[0].estimatedNetworkSize());
+
+    // Replaying again yields the same member
+    replayer.reset();
+    EXPECT_EQ(replayer.run(), recorder.numRecords());
+    EXPECT_EQ(replayer.member().numRumors(RumorStateMachine::State::OLD), members[0].numRumors(RumorStateMachine::State::OLD));
+
+    // A truncated trace is detected
+    const std::string bytes = trace.str();
+    std::istringstream truncated(bytes.substr(0, bytes.size() - 1));
+    TraceReplayer partial(truncated);
+    ASSERT_TRUE(partial.valid());
+    partial.run();
+    EXPECT_TRUE(partial.failed());
+
+    std::istringstream garbage("RRSX");
+    EXPECT_FALSE(TraceReplayer(garbage).valid());
+}
+
+TEST(TestProtocol, Full_Table_Evicts_Old_Then_Known_Rumors)
+{
+    const std::unordered_set<int> peers = {0, 1, 2, 3};
+    RumorMember member(peers, NetworkConfig(peers.size()), 0);
+    member.setMaxRumors(100);
+    EXPECT_EQ(member.maxRumors(), 100u);
+    int numForgotten = 0;
+    member.addStateChangeCb([&](int, int, RumorStateMachine::State, RumorStateMachine::State to) {
+        numForgotten += to == RumorStateMachine::State::UNKNOWN ? 1 : 0;
+    });
+    auto statistic = [&](RumorMember::StatisticKey key) {
+        const auto& found = member.statistics().find(key);
+        return found == member.statistics().end() ? 0.0 : found->second;
+    };
+
+    member.addRumors(0, 60);
+    for (int round = 0; round < 40; ++round) {
+        member.advanceRound();
+    }
+    EXPECT_EQ(member.numRumors(RumorStateMachine::State::OLD), 60u);
+
+    // The oldest OLD rumors make room, with some slack
+    const std::vector<bool> added = member.addRumors(1000, 60);
+    EXPECT_EQ(std::count(added.begin(), added.end(), true), 60);
+    EXPECT_EQ(statistic(RumorMember::StatisticKey::NumEvictedRumors), 26.0);
+    EXPECT_FALSE(member.rumorExists(25));
+    EXPECT_TRUE(member.isOld(26));
+    EXPECT_EQ(member.numRumors(RumorStateMachine::State::OLD), 34u);
+
+    // NEW rumors are never evicted, the rumors that do not fit are refused
+    const std::vector<bool> partial = member.addRumors(2000, 50);
+    EXPECT_EQ(std::count(partial.begin(), partial.end(), true), 40);
+    EXPECT_EQ(member.numRumors(RumorStateMachine::State::OLD), 0u);
+    EXPECT_EQ(member.numRumors(RumorStateMachine::State::NEW), 100u);
+    EXPECT_FALSE(member.addRumor(3000));
+    EXPECT_EQ(statistic(RumorMember::StatisticKey::NumRejectedRumors), 11.0);
+
+    member.receivedMessage(Message(Message::Type::PUSH, 4000, 0), 1);
+    EXPECT_FALSE(member.rumorExists(4000));
+    EXPECT_EQ(statistic(RumorMember::StatisticKey::NumDroppedRumors), 1.0);
+
+    // Once rumors are KNOWN they can be evicted, as few as needed
+    for (int round = 0; round < 40 && member.numRumors(RumorStateMachine::State::KNOWN) == 0; ++round) {
+        member.advanceRound();
+    }
+    ASSERT_GT(member.numRumors(RumorStateMachine::State::KNOWN), 0u);
+    member.receivedMessage(Message(Message::Type::PUSH, 4000, 0, 2), 2);
+    EXPECT_TRUE(member.rumorExists(4001));
+    EXPECT_EQ(member.numRumors(RumorStateMachine::State::NEW) + member.numRumors(RumorStateMachine::State::KNOWN) +
+              member.numRumors(RumorStateMachine::State::OLD), 100u);
+    EXPECT_EQ(statistic(RumorMember::StatisticKey::NumEvictedRumors), 62.0);
+    EXPECT_EQ(numForgotten, 62);
+}
+
+TEST(TestProtocol, State_Transfer_Resumes_Active_Rumors)
+{
+    const int n = 16;
+    std::unordered_set<int> peerIds;
+    for (int i = 0; i < n; ++i) {
+        peerIds.insert(i);
+    }
+    std::mt19937 gen(11);
+    std::vector<RumorMember> members;
+    members.reserve(n);
+    for (int i = 0; i < n; ++i) {
+        auto nextCb = [&gen, i]() {
+            int peer = std::uniform_int_distribution<int>(0, n - 2)(gen);
+            return peer >= i ? peer + 1 : peer;
+        };
+        members.emplace_back(peerIds, NetworkConfig(n), nextCb, i);
+    }
+
+    // Rumors started in different rounds are in different states at member 0
+    for (int round = 0; round < 8; ++round) {
+        members[round % n].addRumors(100 * round, 5);
+        for (int from = 0; from < n; ++from) {
+            const std::pair<int, std::vector<Message>> push = members[from].advanceRound();
+            for (const Message& pushMsg : push.second) {
+                const std::pair<int, std::vector<Message>> pull = members[push.first].receivedMessage(pushMsg, from);
+                for (const Message& pullMsg : pull.second) {
+                    members[pull.first].receivedMessage(pullMsg, push.first);
+                }
+            }
+        }
+    }
+    RumorMember& donor = members[0];
+    donor.advanceRound();
+    const std::vector<StateTransfer::Range> ranges = donor.activeRumors();
+    ASSERT_GT(donor.numRumors(RumorStateMachine::State::NEW), 0u);
+    ASSERT_GT(donor.numRumors(RumorStateMachine::State::KNOWN), 0u);
+    ASSERT_GT(ranges.size(), 1u);
+
+    // Member 1 recovers with an empty table. The table is streamed in chunks of one range, each
+    // imported as it arrives.
+    RumorMember joiner(peerIds, NetworkConfig(n), 1);
+    std::ostringstream trace;
+    TraceRecorder recorder(trace);
+    joiner.record(&recorder);
+    std::vector<std::string> chunks;
+    const size_t numChunks = StateTransfer::encode(donor.id(), ranges, [&](const char* data, size_t size) {
+        chunks.emplace_back(data, size);
+    }, StateTransfer::k_headerSize + StateTransfer::k_maxEntrySize);
+    ASSERT_EQ(numChunks, chunks.size());
+    EXPECT_EQ(numChunks, ranges.size());
+    size_t numImported = 0;
+    StateTransfer::Chunk chunk;
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        ASSERT_TRUE(StateTransfer::decode(chunks[i].data(), chunks[i].size(), chunk));
+        EXPECT_EQ(chunk.m_fromMember, donor.id());
+        EXPECT_EQ(chunk.m_sequence, i);
+        EXPECT_EQ(chunk.m_last, i + 1 == chunks.size());
+        numImported += joiner.importRumors(chunk.m_ranges);
+    }
+    EXPECT_EQ(numImported, donor.numRumors(RumorStateMachine::State::NEW) + donor.numRumors(RumorStateMachine::State::KNOWN));
+    EXPECT_EQ(joiner.statistics().at(RumorMember::StatisticKey::NumImportedRumors), static_cast<double>(numImported));
+    EXPECT_EQ(joiner.importRumors(ranges), 0u);
+
+    std::string corrupted = chunks[0];
+    corrupted[StateTransfer::k_headerSize] ^= 1;
+    EXPECT_FALSE(StateTransfer::decode(corrupted.data(), corrupted.size(), chunk));
+    EXPECT_FALSE(StateTransfer::decode(chunks[0].data(), chunks[0].size() - 1, chunk));
+
+    // Ranges going past the largest rumor ID are rejected
+    const std::vector<StateTransfer::Range> wrapping = {
+        {INT32_MAX - 1, 5, RumorStateMachine::State::NEW, 1, 1},
+    };
+    std::string wrapped;
+    StateTransfer::encode(donor.id(), wrapping, [&](const char* data, size_t size) {
+        wrapped.assign(data, size);
+    });
+    EXPECT_FALSE(StateTransfer::decode(wrapped.data(), wrapped.size(), chunk));
+    EXPECT_EQ(joiner.importRumors(wrapping), 0u);
+
+    // Without further messages the joiner goes through the same states as the donor, at the same
+    // ages, from the first round on
+    for (int round = 0; round < 3 * NetworkConfig(n).maxRoundsTotal(); ++round) {
+        const std::unordered_map<int, RumorStateMachine> expected = donor.rumorsMap();
+        const std::unordered_map<int, RumorStateMachine> actual = joiner.rumorsMap();
+        ASSERT_EQ(actual.size(), numImported);
+        for (const auto& kv : actual) {
+            const RumorStateMachine& donorState = expected.at(kv.first);
+            ASSERT_EQ(kv.second.state(), donorState.state()) << "rumor " << kv.first << " round " << round;
+            ASSERT_EQ(kv.second.age(), donorState.age()) << "rumor " << kv.first << " round " << round;
+        }
+        donor.advanceRound();
+        joiner.advanceRound();
+    }
+    EXPECT_EQ(joiner.numRumors(RumorStateMachine::State::OLD), numImported);
+
+    // Imports are replayed
+    joiner.record(nullptr);
+    recorder.flush();
+    std::istringstream in(trace.str());
+    TraceReplayer replayer(in);
+    ASSERT_TRUE(replayer.valid());
+    replayer.run();
+    EXPECT_FALSE(replayer.failed());
+    EXPECT_EQ(replayer.member().numRumors(RumorStateMachine::State::OLD), numImported);
+}
+
+TEST(TestProtocol, Aggregate_Simulator_Matches_Members)
+{
+    for (const double lossRate : {0.0, 0.1}) {
+        const int n = 200;
+        const NetworkConfig networkConfig(n);
+        AggregateSimulator sim(n, networkConfig, 11, lossRate);
+
+        // The members choose the peers of the simulator and lose the same messages
+        int round = 0;
+        std::unordered_set<int> peerIds;
+        for (int i = 0; i < n; ++i) {
+            peerIds.insert(i);
+        }
+        std::vector<RumorMember> members;
+        members.reserve(n);
+        for (int i = 0; i < n; ++i) {
+            auto nextCb = [&sim, &round, i]() { return static_cast<int>(sim.peerOf(i, round)); };
+            members.emplace_back(peerIds, networkConfig, nextCb, i);
+        }
+        auto deliver = [&](int to, const Message& message, int from) {
+            return members[to].receivedMessage(message, from);
+        };
 
-        testObj.printRumorsState(std::cout) << std::endl;
+        members[3].addRumor(0);
+        sim.start(3);
+        while (!sim.done() && round < 60) {
+            std::vector<std::pair<int, std::vector<Message>>> pushes;
+            for (RumorMember& member : members) {
+                pushes.push_back(member.advanceRound());
+            }
+            for (int from = 0; from < n; ++from) {
+                const int to = pushes[from].first;
+                if (to < 0 || sim.isLost(from, to, round, Message::Type::PUSH)) {
+                    continue;
+                }
+                const std::pair<int, std::vector<Message>> pull = deliver(to, pushes[from].second.front(), from);
+                if (!pull.second.empty() && !sim.isLost(to, from, round, Message::Type::PULL)) {
+                    deliver(from, pull.second.front(), to);
+                }
+            }
 
-        std::cout << "Member statistics: [" << std::endl;
-        for (const auto& kv : testObj.members()) {
-            kv.second.printStatistics(std::cout) << "\n";
+            const AggregateSimulator::RoundStats stats = sim.advanceRound();
+            EXPECT_EQ(stats.m_round, round);
+            ++round;
+            for (int i = 0; i < n; ++i) {
+                const std::unordered_map<int, RumorStateMachine> rumors = members[i].rumorsMap();
+                const RumorStateMachine::State state = rumors.empty() ? RumorStateMachine::State::UNKNOWN
+                                                                      : rumors.at(0).state();
+                ASSERT_EQ(sim.state(i), state) << "member " << i << " round " << round << " loss " << lossRate;
+                if (!rumors.empty()) {
+                    ASSERT_EQ(sim.age(i), rumors.at(0).age()) << "member " << i << " round " << round;
+                }
+            }
         }
-        std::cout << "]" << std::endl;
+        EXPECT_TRUE(sim.done());
+        EXPECT_GT(members[0].numRumors(RumorStateMachine::State::OLD) + members[1].numRumors(RumorStateMachine::State::OLD), 0u);
     }
 }
 
@@ -3,6 +3,7 @@
 
 #include <map>
 #include <unordered_set>
+#include <ConvergenceTracker.h>
 #include <RumorMember.h>
 #include <Message.h>
 
@@ -13,6 +14,7 @@ class TestProtocol {
     std::unordered_set<int>                   m_peerIds;
     RRS::NetworkConfig                        m_networkConfig;
     std::unordered_map<int, RRS::RumorMember> m_members;
+    RRS::ConvergenceTracker                   m_tracker;
     std::map<std::string, int>                m_StringToRumorId;
     std::map<int, const std::string *>        m_rumorIdToStringPtr;
     std::chrono::milliseconds                 m_tickInterval;
@@ -20,8 +22,6 @@ class TestProtocol {
 
     void constructNetwork(size_t numOfPeers);
 
-    int nextId(int memberId) const;
-
     void handleMessage(int fromMember, int toMember, const RRS::Message& msg);
 
   public:
@@ -0,0 +1,172 @@
+#include "LinkModel.h"
+
+#include <algorithm>
+#include <cmath>
+
+LinkStats &LinkStats::operator+=(const LinkStats &other) {
+    m_numSent += other.m_numSent;
+    m_numDelivered += other.m_numDelivered;
+    m_numLost += other.m_numLost;
+    m_numPartitioned += other.m_numPartitioned;
+    m_numQueueDropped += other.m_numQueueDropped;
+    return *this;
+}
+
+std::ostream &operator<<(std::ostream &os, const LinkStats &stats) {
+    os << "{ sent: " << stats.m_numSent
+       << ", delivered: " << stats.m_numDelivered
+       << ", lost: " << stats.m_numLost
+       << ", partitioned: " << stats.m_numPartitioned
+       << ", queueDropped: " << stats.m_numQueueDropped
+       << "}";
+    return os;
+}
+
+LinkModel::Latency LinkModel::fixedLatency(Duration latency) {
+    return [=](std::mt19937 &) { return latency; };
+}
+
+LinkModel::Latency LinkModel::uniformLatency(Duration min, Duration max) {
+    return [=](std::mt19937 &gen) {
+        std::uniform_int_distribution<Duration::rep> dis(min.count(), max.count());
+        return Duration(dis(gen));
+    };
+}
+
+LinkModel::Latency LinkModel::exponentialLatency(Duration min, Duration mean) {
+    return [=](std::mt19937 &gen) {
+        std::exponential_distribution<double> dis(1.0 / static_cast<double>((mean - min).count()));
+        return min + Duration(static_cast<Duration::rep>(dis(gen)));
+    };
+}
+
+LinkModel::LinkModel(unsigned seed)
+        : m_gen(seed),
+          m_lossProbability(0),
+          m_linkLossProbability(),
+          m_latency(fixedLatency(Duration::zero())),
+          m_linkLatency(),
+          m_partitions(),
+          m_messagesPerSecond(0),
+          m_egress(),
+          m_maxQueued(0),
+          m_stats() {
+}
+
+void LinkModel::setLossProbability(double probability) {
+    m_lossProbability = probability;
+}
+
+void LinkModel::setLossProbability(int from, int to, double probability) {
+    m_linkLossProbability[Link(from, to)] = probability;
+}
+
+void LinkModel::setLatency(const Latency &latency) {
+    m_latency = latency;
+}
+
+void LinkModel::setLatency(int from, int to, const Latency &latency) {
+    m_linkLatency[Link(from, to)] = latency;
+}
+
+void LinkModel::partition(Time start, Time end, const std::unordered_set<int> &side) {
+    m_partitions.push_back({start, end, side});
+}
+
+void LinkModel::setEgressBandwidth(double messagesPerSecond) {
+    m_messagesPerSecond = messagesPerSecond;
+}
+
+void LinkModel::setEgressBandwidth(int node, double messagesPerSecond) {
+    m_egress[node].m_messagesPerSecond = messagesPerSecond;
+}
+
+void LinkModel::setEgressQueueLimit(size_t maxQueued) {
+    m_maxQueued = maxQueued;
+}
+
+bool LinkModel::transmit(Time now, int from, int to, Time &arrival) {
+    LinkStats &stats = m_stats[from];
+    ++stats.m_numSent;
+
+    // Queue behind the messages that are still waiting for the egress link
+    Time departure = now;
+    auto egressIter = m_egress.find(from);
+    double rate = m_messagesPerSecond;
+    if (egressIter != m_egress.end() && egressIter->second.m_messagesPerSecond > 0) {
+        rate = egressIter->second.m_messagesPerSecond;
+    }
+    if (rate > 0) {
+        Egress &egress = m_egress[from];
+        // At least one tick, so that rates beyond the clock resolution do not divide by zero
+        const Duration perMessage = std::max(Duration(1), duration_cast<Duration>(duration<double>(1.0 / rate)));
+        departure = std::max(now, egress.m_freeAt);
+        if (m_maxQueued > 0 && (departure - now) / perMessage >= static_cast<long>(m_maxQueued)) {
+            ++stats.m_numQueueDropped;
+            return false;
+        }
+        egress.m_freeAt = departure + perMessage;
+    }
+
+    if (isPartitioned(departure, from, to)) {
+        ++stats.m_numPartitioned;
+        return false;
+    }
+
+    std::bernoulli_distribution lost(lossProbability(from, to));
+    if (lost(m_gen)) {
+        ++stats.m_numLost;
+        return false;
+    }
+
+    arrival = departure + latency(from, to)(m_gen);
+    ++stats.m_numDelivered;
+    return true;
+}
+
+const LinkStats &LinkModel::stats(int node) const {
+    static const LinkStats s_empty;
+    auto iter = m_stats.find(node);
+    return iter != m_stats.end() ? iter->second : s_empty;
+}
+
+LinkStats LinkModel::totalStats() const {
+    LinkStats total;
+    for (const auto &kv : m_stats) {
+        total += kv.second;
+    }
+    return total;
+}
+
+double LinkModel::messagesPerNode() const {
+    if (m_stats.empty()) {
+        return 0;
+    }
+    return static_cast<double>(totalStats().m_numSent) / m_stats.size();
+}
+
+const std::map<int, LinkStats> &LinkModel::allStats() const {
+    return m_stats;
+}
+
+bool LinkModel::isPartitioned(Time now, int from, int to) const {
+    for (const auto &partition : m_partitions) {
+        if (now < partition.m_start || now >= partition.m_end) {
+            continue;
+        }
+        if (partition.m_side.count(from) != partition.m_side.count(to)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+double LinkModel::lossProbability(int from, int to) const {
+    auto iter = m_linkLossProbability.find(Link(from, to));
+    return iter != m_linkLossProbability.end() ? iter->second : m_lossProbability;
+}
+
+const LinkModel::Latency &LinkModel::latency(int from, int to) const {
+    auto iter = m_linkLatency.find(Link(from, to));
+    return iter != m_linkLatency.end() ? iter->second : m_latency;
+}
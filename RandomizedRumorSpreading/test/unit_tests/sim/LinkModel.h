@@ -0,0 +1,139 @@
+#ifndef RANDOMIZEDRUMORSPREADING_LINKMODEL_H
+#define RANDOMIZEDRUMORSPREADING_LINKMODEL_H
+
+#include <functional>
+#include <map>
+#include <ostream>
+#include <random>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "Sim.h"
+
+// Counters kept per sending node.
+struct LinkStats {
+    long m_numSent = 0;          // messages handed to the network
+    long m_numDelivered = 0;     // messages that will reach the receiver
+    long m_numLost = 0;          // dropped by the per-link loss probability
+    long m_numPartitioned = 0;   // dropped because sender and receiver were partitioned
+    long m_numQueueDropped = 0;  // dropped because the egress queue was full
+
+    LinkStats& operator+=(const LinkStats& other);
+};
+
+std::ostream& operator<<(std::ostream& os, const LinkStats& stats);
+
+/**
+ * Network model used by the simulator. For every message 'transmit()' decides whether it is
+ * delivered and when it arrives, based on:
+ *  - a loss probability, per link or network wide,
+ *  - a latency distribution, per link or network wide,
+ *  - scheduled partitions that isolate a set of nodes from the rest until they heal,
+ *  - a per-node egress bandwidth: messages wait in a FIFO queue until the link is free.
+ * All randomness comes from a seeded generator, so experiments are reproducible.
+ */
+class LinkModel {
+public:
+
+    using Time = Sim::Time;
+
+    using Duration = steady_clock::duration;
+
+    using Latency = std::function<Duration(std::mt19937 &)>;
+
+    // LATENCY DISTRIBUTIONS
+    static Latency fixedLatency(Duration latency);
+
+    static Latency uniformLatency(Duration min, Duration max);
+
+    static Latency exponentialLatency(Duration min, Duration mean);
+
+private:
+    struct Partition {
+        Time m_start;
+        Time m_end;
+        std::unordered_set<int> m_side;
+    };
+
+    struct Egress {
+        double m_messagesPerSecond = 0;  // 0 means unlimited
+        Time m_freeAt;
+    };
+
+    using Link = std::pair<int, int>;
+
+public:
+    explicit LinkModel(unsigned seed = 0);
+
+    // CONFIGURATION
+    void setLossProbability(double probability);
+
+    void setLossProbability(int from, int to, double probability);
+
+    void setLatency(const Latency &latency);
+
+    void setLatency(int from, int to, const Latency &latency);
+
+    // Isolate the nodes in 'side' from every other node in '[start, end)'.
+    void partition(Time start, Time end, const std::unordered_set<int> &side);
+
+    // Limit the egress of every node, respectively of 'node', to 'messagesPerSecond'. Rates beyond
+    // the clock resolution are capped at one message per tick.
+    void setEgressBandwidth(double messagesPerSecond);
+
+    void setEgressBandwidth(int node, double messagesPerSecond);
+
+    // Drop messages that would wait more than 'maxQueued' messages in an egress queue.
+    void setEgressQueueLimit(size_t maxQueued);
+
+    // SIMULATION
+    // Return true and set 'arrival' if the message from 'from' to 'to' sent at 'now' is delivered.
+    bool transmit(Time now, int from, int to, Time &arrival);
+
+    // Wire 'transmit' in front of 'deliver', the returned function can be used as 'System::send'.
+    template <typename Payload>
+    std::function<void(Time, int, int, const Payload &)>
+    attach(Sim &sim, const std::function<void(Time, int, int, const Payload &)> &deliver);
+
+    // STATISTICS
+    const LinkStats &stats(int node) const;
+
+    LinkStats totalStats() const;
+
+    // Average number of messages sent per node that sent at least one message.
+    double messagesPerNode() const;
+
+    const std::map<int, LinkStats> &allStats() const;
+
+private:
+    bool isPartitioned(Time now, int from, int to) const;
+
+    double lossProbability(int from, int to) const;
+
+    const Latency &latency(int from, int to) const;
+
+    std::mt19937 m_gen;
+    double m_lossProbability;
+    std::map<Link, double> m_linkLossProbability;
+    Latency m_latency;
+    std::map<Link, Latency> m_linkLatency;
+    std::vector<Partition> m_partitions;
+    double m_messagesPerSecond;
+    std::unordered_map<int, Egress> m_egress;
+    size_t m_maxQueued;
+    std::map<int, LinkStats> m_stats;
+};
+
+template <typename Payload>
+std::function<void(Sim::Time, int, int, const Payload &)>
+LinkModel::attach(Sim &sim, const std::function<void(Time, int, int, const Payload &)> &deliver) {
+    return [this, &sim, deliver](Time now, int from, int to, const Payload &payload) {
+        Time arrival;
+        if (transmit(now, from, to, arrival)) {
+            sim.at(arrival, [=](Time at) { deliver(at, from, to, payload); });
+        }
+    };
+}
+
+#endif //RANDOMIZEDRUMORSPREADING_LINKMODEL_H
@@ -0,0 +1,315 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <CoreRuntime.h>
+#include <ShmRing.h>
+#include <ShmRingTransport.h>
+#include <TransportMember.h>
+#include <WireFormat.h>
+
+#include "gtest/gtest.h"
+
+using namespace RRS;
+
+namespace {
+
+std::string uniqueName(const std::string& test)
+{
+    return "/rrs.test." + test + "." + std::to_string(getpid());
+}
+
+bool pushValue(ShmRing& ring, int producer, int value, size_t size)
+{
+    return ring.push(size, [&](char* out) {
+        std::memset(out, 0, size);
+        std::memcpy(out, &producer, sizeof(producer));
+        std::memcpy(out + sizeof(producer), &value, sizeof(value));
+    });
+}
+
+} // anonymous namespace
+
+TEST(TestTransport, Ring_Preserves_Order_Across_Wrap_Around)
+{
+    std::unique_ptr<ShmRing> ring = ShmRing::create(uniqueName("wrap"), 1024);
+    ASSERT_TRUE(ring);
+    EXPECT_TRUE(ring->empty());
+
+    int expected = 0;
+    for (int value = 0; value < 1000; ++value) {
+        // Frame sizes vary so that frames regularly wrap around the end of the ring
+        const size_t size = 8 + static_cast<size_t>(value % 57);
+        if (!pushValue(*ring, 0, value, size)) {
+            ring->consume([&](const char* data, size_t) {
+                int received;
+                std::memcpy(&received, data + sizeof(int), sizeof(int));
+                EXPECT_EQ(received, expected++);
+            });
+            ASSERT_TRUE(pushValue(*ring, 0, value, size));
+        }
+    }
+    ring->consume([&](const char* data, size_t) {
+        int received;
+        std::memcpy(&received, data + sizeof(int), sizeof(int));
+        EXPECT_EQ(received, expected++);
+    });
+    EXPECT_EQ(expected, 1000);
+    EXPECT_TRUE(ring->empty());
+}
+
+TEST(TestTransport, Ring_Accepts_Concurrent_Producers)
+{
+    const std::string name = uniqueName("mpsc");
+    std::unique_ptr<ShmRing> ring = ShmRing::create(name, 1 << 16);
+    ASSERT_TRUE(ring);
+
+    const int numProducers = 4;
+    const int numValues = 20000;
+    std::vector<std::thread> producers;
+    for (int producer = 0; producer < numProducers; ++producer) {
+        producers.emplace_back([&, producer]() {
+            std::unique_ptr<ShmRing> outbound = ShmRing::open(name);
+            ASSERT_TRUE(outbound);
+            for (int value = 0; value < numValues; ++value) {
+                while (!pushValue(*outbound, producer, value, 16)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::vector<int> next(numProducers, 0);
+    int numReceived = 0;
+    while (numReceived < numProducers * numValues) {
+        ring->wait(10, 100);
+        numReceived += static_cast<int>(ring->consume([&](const char* data, size_t size) {
+            int producer;
+            int value;
+            std::memcpy(&producer, data, sizeof(producer));
+            std::memcpy(&value, data + sizeof(producer), sizeof(value));
+            EXPECT_EQ(size, 16u);
+            EXPECT_EQ(value, next[producer]++);
+        }));
+    }
+
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    EXPECT_TRUE(ring->empty());
+}
+
+TEST(TestTransport, Ring_Wakes_Consumer_In_Another_Process)
+{
+    const std::string name = uniqueName("process");
+    std::unique_ptr<ShmRing> ring = ShmRing::create(name, 4096);
+    ASSERT_TRUE(ring);
+
+    const pid_t pid = fork();
+    if (pid == 0) {
+        std::unique_ptr<ShmRing> outbound = ShmRing::open(name);
+        usleep(20000);  // let the parent go to sleep on the futex
+        _exit(outbound && pushValue(*outbound, 1, 42, 8) ? 0 : 1);
+    }
+
+    EXPECT_TRUE(ring->wait(5000, 0));
+    int value = 0;
+    EXPECT_EQ(ring->consume([&](const char* data, size_t) {
+        std::memcpy(&value, data + sizeof(int), sizeof(int));
+    }), 1u);
+    EXPECT_EQ(value, 42);
+
+    int status = -1;
+    waitpid(pid, &status, 0);
+    EXPECT_EQ(status, 0);
+}
+
+TEST(TestTransport, Members_Exchange_Messages)
+{
+    const std::string cluster = "test" + std::to_string(getpid());
+    ShmRingTransport transport0(0, cluster);
+    ShmRingTransport transport1(1, cluster);
+    ASSERT_TRUE(transport0.isOpen());
+    ASSERT_TRUE(transport1.isOpen());
+
+    std::unordered_set<int> peerIds = {0, 1};
+    RumorMember member0(peerIds, 0);
+    RumorMember member1(peerIds, 1);
+    TransportMember endpoint0(member0, transport0);
+    TransportMember endpoint1(member1, transport1);
+
+    member0.addRumor(7);
+    endpoint0.tick();
+    EXPECT_EQ(endpoint1.poll(100), 1);
+    EXPECT_TRUE(member1.rumorExists(7));
+
+    // member1 answered the PUSH with a PULL
+    EXPECT_EQ(endpoint0.poll(100), 1);
+    EXPECT_EQ(endpoint0.numMessagesReceived(), 1);
+    EXPECT_EQ(endpoint1.numMessagesSent(), 1);
+}
+
+TEST(TestTransport, Batches_Larger_Than_The_Ring_Are_Split)
+{
+    const std::string cluster = "split" + std::to_string(getpid());
+    const size_t capacity = 1024;
+    ShmRingTransport transport0(0, cluster);
+    ShmRingTransport transport1(1, cluster, capacity);
+    ASSERT_TRUE(transport0.isOpen());
+    ASSERT_TRUE(transport1.isOpen());
+
+    std::vector<Message> batch;
+    for (int i = 0; i < 1000; ++i) {
+        batch.emplace_back(Message::Type::PUSH, 3 * i, i % 8);
+    }
+    ASSERT_GT(WireFormat::frameSize(batch.data(), batch.size()), capacity);
+
+    std::vector<Message> received;
+    std::thread consumer([&]() {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (received.size() < batch.size() && std::chrono::steady_clock::now() < deadline) {
+            transport1.poll(10, [&](int fromMember, const std::vector<Message>& messages) {
+                EXPECT_EQ(fromMember, 0);
+                received.insert(received.end(), messages.begin(), messages.end());
+            });
+        }
+    });
+
+    const bool sent = transport0.send(1, batch);
+    consumer.join();
+
+    EXPECT_TRUE(sent);
+    EXPECT_EQ(received, batch);
+}
+
+TEST(TestTransport, Queue_Preserves_Order_Across_Threads)
+{
+    SpscQueue<int> queue(16);
+    EXPECT_EQ(queue.capacity(), 16u);
+    // The indices stay on their own cache lines on the heap too
+    std::unique_ptr<SpscQueue<int>> allocated(new SpscQueue<int>(16));
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(allocated.get()) % k_cacheLineSize, 0u);
+    const int numValues = 100000;
+    std::thread producer([&] {
+        for (int i = 0; i < numValues; ++i) {
+            int value = i;
+            while (!queue.push(value)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    int expected = 0;
+    while (expected < numValues) {
+        int value;
+        if (queue.pop(value)) {
+            ASSERT_EQ(value, expected++);
+        }
+        else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    int value;
+    EXPECT_FALSE(queue.pop(value));
+}
+
+TEST(TestTransport, Core_Runtime_Spreads_Rumors)
+{
+    const int numMembers = 32;
+    std::unordered_set<int> peerIds;
+    for (int i = 0; i < numMembers; ++i) {
+        peerIds.insert(i);
+    }
+
+    CoreRuntime runtime(4, false);
+    for (int i = 0; i < numMembers; ++i) {
+        runtime.addMember(i, peerIds, NetworkConfig(numMembers));
+    }
+    EXPECT_THROW(runtime.member(0), std::out_of_range);
+    runtime.start();
+    EXPECT_EQ(runtime.numMembers(), static_cast<size_t>(numMembers));
+    EXPECT_EQ(runtime.workerOf(5), 1);
+    EXPECT_EQ(runtime.workerOf(numMembers), -1);
+
+    runtime.member(0).addRumor(7);
+    runtime.member(5).addRumor(8);
+    for (int round = 0; round < 60; ++round) {
+        runtime.advanceRound();
+        runtime.quiesce();
+    }
+
+    for (int i = 0; i < numMembers; ++i) {
+        EXPECT_TRUE(runtime.member(i).rumorExists(7)) << "member " << i;
+        EXPECT_TRUE(runtime.member(i).rumorExists(8)) << "member " << i;
+    }
+    EXPECT_GT(runtime.numBatches(), 0);
+    EXPECT_EQ(runtime.numDropped(), 0);
+    runtime.stop();
+}
+
+TEST(TestTransport, Core_Runtime_Steals_Rounds)
+{
+    const int numMembers = 8;
+    std::unordered_set<int> peerIds;
+    for (int i = 0; i < numMembers; ++i) {
+        peerIds.insert(i);
+    }
+
+    CoreRuntime runtime(2, false);
+    for (int i = 0; i < numMembers; ++i) {
+        runtime.addMember(i, peerIds, NetworkConfig(numMembers));
+    }
+    runtime.start();
+
+    // Worker 1 blocks while member 1 learns the rumor, worker 0 has to advance its members
+    std::atomic<bool> blocked(false);
+    std::atomic<bool> released(false);
+    runtime.member(1).addStateChangeCb([&](int, int, RumorStateMachine::State from, RumorStateMachine::State) {
+        if (from == RumorStateMachine::State::UNKNOWN) {
+            blocked = true;
+            while (!released) {
+                std::this_thread::yield();
+            }
+        }
+    });
+    std::thread releaser([&] {
+        while (!blocked && !released) {
+            std::this_thread::yield();
+        }
+        const long stolen = runtime.numStolen();
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+        while (runtime.numStolen() < stolen + numMembers / 2 && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::yield();
+        }
+        released = true;
+    });
+
+    runtime.member(0).addRumor(3);
+    for (int round = 0; round < 1000 && !released; ++round) {
+        runtime.advanceRound();
+    }
+    released = true;
+    releaser.join();
+    runtime.quiesce();
+
+    EXPECT_TRUE(blocked);
+    EXPECT_GE(runtime.numStolen(), numMembers / 2);
+    EXPECT_TRUE(runtime.member(1).rumorExists(3));
+    runtime.stop();
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    int ret = RUN_ALL_TESTS();
+    return ret;
+}
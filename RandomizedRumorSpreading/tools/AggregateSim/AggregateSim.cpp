@@ -0,0 +1,134 @@
+// Single rumor simulation at the scale of 10^7 to 10^8 members.
+//
+// Spreads one rumor started by member 0 with an 'AggregateSimulator', which keeps 6 bytes per
+// member instead of a 'RumorMember', until no member is NEW or KNOWN. Prints JSON with the members
+// in each state and the messages of every round, then the coverage, the rounds until every member
+// that learned the rumor is OLD, the messages per member, the run time and the memory used. Build
+// with '-DCMAKE_BUILD_TYPE=Release' so that the state transitions are vectorized.
+//
+// Usage:
+//   AggregateSim [--size 1000000] [--max-rounds-b B] [--max-rounds-c C] [--max-rounds-total T]
+//                [--loss 0] [--seed 1] [--max-rounds 200]
+//
+// The round limits default to those of 'NetworkConfig(size)'.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <AggregateSimulator.h>
+#include <NetworkConfig.h>
+
+using namespace RRS;
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+struct Options {
+    uint32_t m_size = 1000000;
+    int      m_maxRoundsInB = 0;     // 0: from 'NetworkConfig(size)'
+    int      m_maxRoundsInC = 0;
+    int      m_maxRoundsTotal = 0;
+    double   m_lossRate = 0;
+    uint64_t m_seed = 1;
+    int      m_maxRounds = 200;
+};
+
+bool parseOptions(int argc, char* argv[], Options& options)
+{
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << std::endl;
+            return false;
+        }
+        const std::string value = argv[++i];
+        if (arg == "--size") {
+            options.m_size = static_cast<uint32_t>(std::stoul(value));
+        }
+        else if (arg == "--max-rounds-b") {
+            options.m_maxRoundsInB = std::stoi(value);
+        }
+        else if (arg == "--max-rounds-c") {
+            options.m_maxRoundsInC = std::stoi(value);
+        }
+        else if (arg == "--max-rounds-total") {
+            options.m_maxRoundsTotal = std::stoi(value);
+        }
+        else if (arg == "--loss") {
+            options.m_lossRate = std::stod(value);
+        }
+        else if (arg == "--seed") {
+            options.m_seed = std::stoull(value);
+        }
+        else if (arg == "--max-rounds") {
+            options.m_maxRounds = std::stoi(value);
+        }
+        else {
+            std::cerr << "Unknown option " << arg << std::endl;
+            return false;
+        }
+    }
+    return options.m_size >= 2 && options.m_maxRounds > 0;
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[])
+{
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        return 1;
+    }
+
+    const NetworkConfig theory(options.m_size);
+    const NetworkConfig networkConfig(options.m_size,
+                                      options.m_maxRoundsInB > 0 ? options.m_maxRoundsInB : theory.maxRoundsInB(),
+                                      options.m_maxRoundsInC > 0 ? options.m_maxRoundsInC : theory.maxRoundsInC(),
+                                      options.m_maxRoundsTotal > 0 ? options.m_maxRoundsTotal : theory.maxRoundsTotal());
+    if (networkConfig.maxRoundsTotal() >= 0xff) {
+        std::cerr << "--max-rounds-total must be below 255" << std::endl;
+        return 1;
+    }
+
+    const Clock::time_point start = Clock::now();
+    AggregateSimulator sim(options.m_size, networkConfig, options.m_seed, options.m_lossRate);
+    sim.start(0);
+    const std::vector<AggregateSimulator::RoundStats> rounds = sim.run(options.m_maxRounds);
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    uint64_t numMessages = 0;
+    std::cout << "{\n  \"size\": " << options.m_size
+              << ",\n  \"maxRoundsInB\": " << networkConfig.maxRoundsInB()
+              << ",\n  \"maxRoundsInC\": " << networkConfig.maxRoundsInC()
+              << ",\n  \"maxRoundsTotal\": " << networkConfig.maxRoundsTotal()
+              << ",\n  \"loss\": " << options.m_lossRate
+              << ",\n  \"rounds\": [";
+    for (size_t i = 0; i < rounds.size(); ++i) {
+        const AggregateSimulator::RoundStats& round = rounds[i];
+        numMessages += round.m_numPushMessages + round.m_numPullMessages;
+        std::cout << (i > 0 ? "," : "") << "\n    {\"round\": " << round.m_round
+                  << ", \"unknown\": " << round.m_numMembers[0]
+                  << ", \"new\": " << round.m_numMembers[1]
+                  << ", \"known\": " << round.m_numMembers[2]
+                  << ", \"old\": " << round.m_numMembers[3]
+                  << ", \"push\": " << round.m_numPushMessages
+                  << ", \"pull\": " << round.m_numPullMessages
+                  << ", \"lost\": " << round.m_numLost
+                  << ", \"duplicates\": " << round.m_numDuplicates << "}";
+    }
+
+    const uint64_t numUnknown = rounds.empty() ? options.m_size - 1 : rounds.back().m_numMembers[0];
+    std::cout << "\n  ]"
+              << ",\n  \"done\": " << (sim.done() ? "true" : "false")
+              << ",\n  \"roundsToOld\": " << rounds.size()
+              << ",\n  \"coverage\": " << 1 - static_cast<double>(numUnknown) / options.m_size
+              << ",\n  \"messagesPerMember\": " << static_cast<double>(numMessages) / options.m_size
+              << ",\n  \"seconds\": " << seconds
+              << ",\n  \"memoryBytes\": " << sim.memoryUsage() << "\n}" << std::endl;
+    return 0;
+}
@@ -0,0 +1,371 @@
+// Loopback cluster benchmark.
+//
+// Forks one process per member. Every process runs a 'RumorMember' behind a transport, either a
+// UDP socket bound to 127.0.0.1:(basePort + memberId) or a shared memory ring, and advances a
+// round every '--round-ms' milliseconds. Rumor 'k' is injected by member 'k % nodes' at
+// 'start + k / rate', so every process knows when each rumor was born and can measure its
+// dissemination latency without clock exchange (all processes share CLOCK_MONOTONIC). When the
+// run is over every process reports its measurements to the parent through a pipe, and the parent
+// prints a single JSON document with latency percentiles, throughput, CPU time and peak RSS per
+// node.
+//
+// Usage:
+//   ClusterBench [--nodes 8] [--rate 100] [--duration 5] [--drain 2] [--round-ms 10]
+//                [--base-port 47000] [--transport udp|shm] [--max-round-ms 0] [--ranges 0|1]
+//
+// With '--max-round-ms' greater than zero rounds are driven by a 'RoundScheduler': every
+// '--round-ms' while a rumor is NEW, backing off up to '--max-round-ms' while only KNOWN rumors
+// remain, and not at all once every rumor is OLD. '--ranges 1' makes members send one message per
+// run of consecutive rumor IDs ('RumorMember::setRangeMessages').
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <Message.h>
+#include <RoundScheduler.h>
+#include <RumorMember.h>
+#include <ShmRingTransport.h>
+#include <TransportMember.h>
+#include <UdpTransport.h>
+
+using namespace RRS;
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+struct Options {
+    int    m_nodes = 8;
+    double m_rate = 100;      // rumors per second, whole cluster
+    double m_duration = 5;    // seconds of rumor injection
+    double m_drain = 2;       // seconds to keep running after the last injection
+    int    m_roundMs = 10;
+    int    m_maxRoundMs = 0;  // 0 for a fixed round clock
+    bool   m_ranges = false;
+    int    m_basePort = 47000;
+    std::string m_transport = "udp";  // or "shm"
+};
+
+struct NodeReport {
+    int                   m_node = -1;
+    long                  m_numRumorsLearned = 0;
+    long                  m_numMessagesSent = 0;
+    long                  m_numMessagesReceived = 0;
+    long                  m_numDatagramsSent = 0;     // batches
+    long                  m_numDatagramsReceived = 0;
+    long                  m_numDuplicateRumors = 0;
+    std::vector<long>     m_latenciesUs;
+    double                m_cpuSeconds = 0;
+    long                  m_maxRssKb = 0;
+};
+
+long elapsedUs(Clock::time_point from, Clock::time_point to)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(to - from).count();
+}
+
+std::unique_ptr<Transport> makeTransport(const Options& options, int self, const std::string& cluster)
+{
+    if (options.m_transport == "shm") {
+        std::unique_ptr<ShmRingTransport> transport(new ShmRingTransport(self, cluster));
+        return transport->isOpen() ? std::move(transport) : nullptr;
+    }
+
+    std::unique_ptr<UdpTransport> transport(new UdpTransport(self, options.m_basePort));
+    return transport->isOpen() ? std::move(transport) : nullptr;
+}
+
+NodeReport runNode(const Options& options, int self, const std::string& cluster, Clock::time_point start)
+{
+    NodeReport report;
+    report.m_node = self;
+
+    std::unique_ptr<Transport> transport = makeTransport(options, self, cluster);
+    if (!transport) {
+        std::cerr << "node " << self << ": cannot open " << options.m_transport << " transport: "
+                  << std::strerror(errno) << std::endl;
+        return report;
+    }
+
+    std::unordered_set<int> peerIds;
+    for (int i = 0; i < options.m_nodes; ++i) {
+        peerIds.insert(i);
+    }
+    RumorMember member(peerIds, self);
+    member.setRangeMessages(options.m_ranges);
+    TransportMember endpoint(member, *transport);
+
+    const long numRumors = static_cast<long>(options.m_rate * options.m_duration);
+    const double rumorIntervalUs = 1e6 / options.m_rate;
+    auto bornAt = [&](long rumorId) {
+        return start + std::chrono::microseconds(static_cast<long>(rumorId * rumorIntervalUs));
+    };
+
+    // Measure the latency of every rumor learned from a peer
+    member.addStateChangeCb([&](int, int rumorId, RumorStateMachine::State from, RumorStateMachine::State) {
+        if (from == RumorStateMachine::State::UNKNOWN && rumorId % options.m_nodes != self) {
+            ++report.m_numRumorsLearned;
+            report.m_latenciesUs.push_back(elapsedUs(bornAt(rumorId), Clock::now()));
+        }
+    });
+
+    const Clock::time_point end = start + std::chrono::microseconds(
+        static_cast<long>((options.m_duration + options.m_drain) * 1e6));
+    const std::chrono::milliseconds roundInterval(options.m_roundMs);
+    Clock::time_point nextRound = start + roundInterval;
+    long nextRumor = self;
+
+    std::unique_ptr<RoundScheduler> scheduler;
+    if (options.m_maxRoundMs > 0) {
+        scheduler.reset(new RoundScheduler(member, roundInterval,
+                                           std::chrono::milliseconds(options.m_maxRoundMs)));
+    }
+
+    while (true) {
+        Clock::time_point now = Clock::now();
+        if (now >= end) {
+            break;
+        }
+
+        // Inject the rumors this member is responsible for
+        while (nextRumor < numRumors && bornAt(nextRumor) <= now) {
+            member.addRumor(static_cast<int>(nextRumor));
+            nextRumor += options.m_nodes;
+        }
+
+        if (scheduler) {
+            if (now >= scheduler->nextRoundAt()) {
+                endpoint.sendRound(scheduler->advanceRound());
+            }
+            nextRound = scheduler->nextRoundAt();
+        }
+        else if (now >= nextRound) {
+            endpoint.tick();
+            nextRound += roundInterval;
+        }
+
+        Clock::time_point wakeUp = std::min(nextRound, end);
+        if (nextRumor < numRumors) {
+            wakeUp = std::min(wakeUp, bornAt(nextRumor));
+        }
+        const int timeoutMs = static_cast<int>(std::max<long>(0, elapsedUs(Clock::now(), wakeUp) / 1000));
+        endpoint.poll(timeoutMs);
+    }
+
+    report.m_numMessagesSent = endpoint.numMessagesSent();
+    report.m_numMessagesReceived = endpoint.numMessagesReceived();
+    report.m_numDatagramsSent = endpoint.numBatchesSent();
+    report.m_numDatagramsReceived = endpoint.numBatchesReceived();
+    const auto& duplicates = member.statistics().find(RumorMember::StatisticKey::NumDuplicateRumors);
+    report.m_numDuplicateRumors = duplicates == member.statistics().end() ? 0 : static_cast<long>(duplicates->second);
+    return report;
+}
+
+void writeReport(std::ostream& os, const NodeReport& report)
+{
+    os << report.m_node << " " << report.m_numRumorsLearned << " "
+       << report.m_numMessagesSent << " " << report.m_numMessagesReceived << " "
+       << report.m_numDatagramsSent << " " << report.m_numDatagramsReceived << " "
+       << report.m_numDuplicateRumors << " " << report.m_latenciesUs.size();
+    for (long latency : report.m_latenciesUs) {
+        os << " " << latency;
+    }
+    os << "\n";
+}
+
+bool readReport(const std::string& text, NodeReport& report)
+{
+    std::istringstream is(text);
+    size_t numLatencies = 0;
+    is >> report.m_node >> report.m_numRumorsLearned
+       >> report.m_numMessagesSent >> report.m_numMessagesReceived
+       >> report.m_numDatagramsSent >> report.m_numDatagramsReceived >> report.m_numDuplicateRumors
+       >> numLatencies;
+    report.m_latenciesUs.resize(numLatencies);
+    for (size_t i = 0; i < numLatencies; ++i) {
+        is >> report.m_latenciesUs[i];
+    }
+    return !is.fail();
+}
+
+double percentileMs(const std::vector<long>& sorted, double percentile)
+{
+    if (sorted.empty()) {
+        return 0;
+    }
+    const size_t index = std::min(sorted.size() - 1,
+                                  static_cast<size_t>(percentile / 100.0 * sorted.size()));
+    return sorted[index] / 1000.0;
+}
+
+bool parseOptions(int argc, char* argv[], Options& options)
+{
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const std::string arg = argv[i];
+        const char* value = argv[i + 1];
+        if (arg == "--nodes") {
+            options.m_nodes = std::atoi(value);
+        }
+        else if (arg == "--rate") {
+            options.m_rate = std::atof(value);
+        }
+        else if (arg == "--duration") {
+            options.m_duration = std::atof(value);
+        }
+        else if (arg == "--drain") {
+            options.m_drain = std::atof(value);
+        }
+        else if (arg == "--round-ms") {
+            options.m_roundMs = std::atoi(value);
+        }
+        else if (arg == "--ranges") {
+            options.m_ranges = std::atoi(value) != 0;
+        }
+        else if (arg == "--max-round-ms") {
+            options.m_maxRoundMs = std::atoi(value);
+        }
+        else if (arg == "--base-port") {
+            options.m_basePort = std::atoi(value);
+        }
+        else if (arg == "--transport" && (std::string(value) == "udp" || std::string(value) == "shm")) {
+            options.m_transport = value;
+        }
+        else {
+            std::cerr << "Unknown option " << arg << std::endl;
+            return false;
+        }
+    }
+    return argc % 2 == 1 && options.m_nodes > 1 && options.m_rate > 0 && options.m_roundMs > 0;
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[])
+{
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        return 1;
+    }
+
+    const std::string cluster = "bench" + std::to_string(getpid());
+
+    // Leave the children time to bind their sockets before the first round
+    const Clock::time_point start = Clock::now() + std::chrono::milliseconds(200);
+
+    std::vector<pid_t> pids;
+    std::vector<int> pipes;
+    for (int node = 0; node < options.m_nodes; ++node) {
+        int fds[2];
+        if (pipe(fds) != 0) {
+            return 1;
+        }
+        const pid_t pid = fork();
+        if (pid == 0) {
+            close(fds[0]);
+            std::ostringstream os;
+            writeReport(os, runNode(options, node, cluster, start));
+            const std::string text = os.str();
+            size_t written = 0;
+            while (written < text.size()) {
+                const ssize_t n = write(fds[1], text.data() + written, text.size() - written);
+                if (n <= 0) {
+                    break;
+                }
+                written += static_cast<size_t>(n);
+            }
+            _exit(0);
+        }
+        close(fds[1]);
+        pids.push_back(pid);
+        pipes.push_back(fds[0]);
+    }
+
+    // Collect the reports, CPU time and peak RSS of every node
+    std::vector<NodeReport> reports(options.m_nodes);
+    for (int node = 0; node < options.m_nodes; ++node) {
+        std::string text;
+        char chunk[4096];
+        ssize_t n;
+        while ((n = read(pipes[node], chunk, sizeof(chunk))) > 0) {
+            text.append(chunk, static_cast<size_t>(n));
+        }
+        close(pipes[node]);
+
+        int status = 0;
+        rusage usage;
+        std::memset(&usage, 0, sizeof(usage));
+        wait4(pids[node], &status, 0, &usage);
+
+        NodeReport& report = reports[node];
+        if (!readReport(text, report)) {
+            std::cerr << "node " << node << " did not report" << std::endl;
+            report.m_node = node;
+        }
+        report.m_cpuSeconds = usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6 +
+                              usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1e6;
+        report.m_maxRssKb = usage.ru_maxrss;
+    }
+
+    std::vector<long> latencies;
+    long numLearned = 0;
+    long numMessages = 0;
+    long numDatagrams = 0;
+    for (const NodeReport& report : reports) {
+        latencies.insert(latencies.end(), report.m_latenciesUs.begin(), report.m_latenciesUs.end());
+        numLearned += report.m_numRumorsLearned;
+        numMessages += report.m_numMessagesSent;
+        numDatagrams += report.m_numDatagramsSent;
+    }
+    std::sort(latencies.begin(), latencies.end());
+
+    const long numRumors = static_cast<long>(options.m_rate * options.m_duration);
+    const long numExpected = numRumors * (options.m_nodes - 1);  // every rumor, except at its origin
+    const double seconds = options.m_duration + options.m_drain;
+
+    std::cout << "{\n"
+              << "  \"transport\": \"" << options.m_transport << "\""
+              << ",\n  \"nodes\": " << options.m_nodes
+              << ",\n  \"rate\": " << options.m_rate
+              << ",\n  \"durationSeconds\": " << options.m_duration
+              << ",\n  \"drainSeconds\": " << options.m_drain
+              << ",\n  \"roundMs\": " << options.m_roundMs
+              << ",\n  \"maxRoundMs\": " << options.m_maxRoundMs
+              << ",\n  \"ranges\": " << (options.m_ranges ? "true" : "false")
+              << ",\n  \"rumors\": " << numRumors
+              << ",\n  \"coverage\": "
+              << (numExpected > 0 ? static_cast<double>(numLearned) / numExpected : 0)
+              << ",\n  \"latencyMs\": {\"p50\": " << percentileMs(latencies, 50)
+              << ", \"p90\": " << percentileMs(latencies, 90)
+              << ", \"p99\": " << percentileMs(latencies, 99)
+              << ", \"max\": " << percentileMs(latencies, 100) << "}"
+              << ",\n  \"messagesPerSecond\": " << numMessages / seconds
+              << ",\n  \"datagramsPerSecond\": " << numDatagrams / seconds
+              << ",\n  \"perNode\": [";
+    for (size_t i = 0; i < reports.size(); ++i) {
+        const NodeReport& report = reports[i];
+        std::cout << (i == 0 ? "\n" : ",\n")
+                  << "    {\"node\": " << report.m_node
+                  << ", \"rumorsLearned\": " << report.m_numRumorsLearned
+                  << ", \"messagesSent\": " << report.m_numMessagesSent
+                  << ", \"messagesReceived\": " << report.m_numMessagesReceived
+                  << ", \"duplicateRumors\": " << report.m_numDuplicateRumors
+                  << ", \"cpuSeconds\": " << report.m_cpuSeconds
+                  << ", \"maxRssKb\": " << report.m_maxRssKb << "}";
+    }
+    std::cout << "\n  ]\n}" << std::endl;
+
+    return 0;
+}
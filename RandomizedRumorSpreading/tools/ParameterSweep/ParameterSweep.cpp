@@ -0,0 +1,448 @@
+// Parameter sweep for 'NetworkConfig' tuning.
+//
+// Runs many independent round-synchronous simulations of a single rumor over a grid of network
+// sizes, round limits and message loss rates, spread over all cores. For every grid point it
+// reports the probability that the rumor reached every member, the number of rounds until every
+// member that learned the rumor considers it OLD and the number of messages sent per member.
+// Finally it recommends, per network size and loss rate, the configuration with the fewest
+// messages per member whose coverage probability meets the target.
+//
+// With '--zones', member i is in zone 'i % zones' and chooses its peers with a zone-aware
+// 'PeerSchedule' that contacts another zone with probability '--remote'. The fraction of the
+// messages that cross zones and the rounds until every member learned the rumor are reported too.
+//
+// Usage:
+//   ParameterSweep [--sizes 64,256,1024] [--loss 0,0.01,0.05] [--max-rounds-b 1,2,3]
+//                  [--max-rounds-c 1,2,3] [--max-rounds-total 4,5,6] [--zones 1,4]
+//                  [--remote 0.1,0.25] [--runs 200] [--target 0.99] [--threads N] [--seed S]
+//                  [--format csv|json]
+//
+// When '--max-rounds-total' is omitted, the theoretical default of 'NetworkConfig(size)' and the
+// values around it are swept.
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <NetworkConfig.h>
+#include <PeerSchedule.h>
+#include <RumorMember.h>
+
+using namespace RRS;
+
+namespace {
+
+struct Options {
+    std::vector<int>    m_sizes = {64, 256, 1024};
+    std::vector<double> m_lossRates = {0, 0.01, 0.05};
+    std::vector<int>    m_maxRoundsInB = {1, 2, 3};
+    std::vector<int>    m_maxRoundsInC = {1, 2, 3};
+    std::vector<int>    m_maxRoundsTotal;  // empty: derived from the network size
+    std::vector<int>    m_zones = {1};
+    std::vector<double> m_remoteProbabilities = {0.1};
+    int                 m_runs = 200;
+    double              m_targetCoverage = 0.99;
+    unsigned            m_threads = std::max(1u, std::thread::hardware_concurrency());
+    unsigned            m_seed = 1;
+    std::string         m_format = "csv";
+};
+
+struct GridPoint {
+    int    m_size;
+    double m_lossRate;
+    int    m_maxRoundsInB;
+    int    m_maxRoundsInC;
+    int    m_maxRoundsTotal;
+    int    m_numZones;
+    double m_remoteProbability;  // Unused with a single zone
+};
+
+struct RunResult {
+    bool   m_fullCoverage = false;
+    double m_coverage = 0;
+    int    m_roundsToOld = 0;
+    int    m_roundsToCoverage = 0;  // Rounds until every member learned the rumor, if it did
+    double m_messagesPerMember = 0;
+    double m_crossZoneFraction = 0;
+};
+
+struct Summary {
+    GridPoint m_point;
+    double    m_coverageProbability = 0;
+    double    m_meanCoverage = 0;
+    double    m_meanRoundsToOld = 0;
+    int       m_maxRoundsToOld = 0;
+    double    m_meanRoundsToCoverage = 0;  // Over the runs with full coverage
+    double    m_messagesPerMember = 0;
+    double    m_crossZoneFraction = 0;
+};
+
+template <typename T>
+std::vector<T> parseList(const std::string& arg)
+{
+    std::vector<T> values;
+    std::stringstream stream(arg);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        std::stringstream itemStream(item);
+        T value;
+        itemStream >> value;
+        values.push_back(value);
+    }
+    return values;
+}
+
+bool parseOptions(int argc, char* argv[], Options& options)
+{
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << std::endl;
+            return false;
+        }
+        const std::string value = argv[++i];
+        if (arg == "--sizes") {
+            options.m_sizes = parseList<int>(value);
+        }
+        else if (arg == "--loss") {
+            options.m_lossRates = parseList<double>(value);
+        }
+        else if (arg == "--max-rounds-b") {
+            options.m_maxRoundsInB = parseList<int>(value);
+        }
+        else if (arg == "--max-rounds-c") {
+            options.m_maxRoundsInC = parseList<int>(value);
+        }
+        else if (arg == "--max-rounds-total") {
+            options.m_maxRoundsTotal = parseList<int>(value);
+        }
+        else if (arg == "--zones") {
+            options.m_zones = parseList<int>(value);
+        }
+        else if (arg == "--remote") {
+            options.m_remoteProbabilities = parseList<double>(value);
+        }
+        else if (arg == "--runs") {
+            options.m_runs = std::atoi(value.c_str());
+        }
+        else if (arg == "--target") {
+            options.m_targetCoverage = std::atof(value.c_str());
+        }
+        else if (arg == "--threads") {
+            options.m_threads = static_cast<unsigned>(std::max(1, std::atoi(value.c_str())));
+        }
+        else if (arg == "--seed") {
+            options.m_seed = static_cast<unsigned>(std::atoi(value.c_str()));
+        }
+        else if (arg == "--format" && (value == "csv" || value == "json")) {
+            options.m_format = value;
+        }
+        else {
+            std::cerr << "Unknown option " << arg << " " << value << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<GridPoint> buildGrid(const Options& options)
+{
+    std::vector<GridPoint> grid;
+    for (int size : options.m_sizes) {
+        std::vector<int> maxRoundsTotal = options.m_maxRoundsTotal;
+        if (maxRoundsTotal.empty()) {
+            const int theory = NetworkConfig(static_cast<size_t>(size)).maxRoundsTotal();
+            for (int total = std::max(1, theory - 1); total <= theory + 2; ++total) {
+                maxRoundsTotal.push_back(total);
+            }
+        }
+
+        for (double lossRate : options.m_lossRates) {
+            for (int roundsInB : options.m_maxRoundsInB) {
+                for (int roundsInC : options.m_maxRoundsInC) {
+                    for (int total : maxRoundsTotal) {
+                        for (int zones : options.m_zones) {
+                            // The remote probability only matters with several zones
+                            for (double remote : options.m_remoteProbabilities) {
+                                grid.push_back({size, lossRate, roundsInB, roundsInC, total, zones, remote});
+                                if (zones <= 1) {
+                                    break;
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return grid;
+}
+
+// Simulate one rumor started by member 0 until every member that knows it considers it OLD.
+RunResult runOnce(const GridPoint& point, unsigned seed)
+{
+    const int n = point.m_size;
+    const NetworkConfig networkConfig(static_cast<size_t>(n),
+                                      point.m_maxRoundsInB,
+                                      point.m_maxRoundsInC,
+                                      point.m_maxRoundsTotal);
+    std::mt19937 gen(seed);
+    std::bernoulli_distribution lost(point.m_lossRate);
+
+    std::unordered_set<int> peerIds;
+    for (int i = 0; i < n; ++i) {
+        peerIds.insert(i);
+    }
+
+    // Peers are chosen from the run's own generator, which keeps runs independent and reproducible.
+    // With zones each member walks its own zone-aware schedule, seeded from that generator.
+    const int numZones = std::max(1, point.m_numZones);
+    std::vector<PeerSchedule> schedules;
+    if (numZones > 1) {
+        for (int i = 0; i < n; ++i) {
+            std::vector<int> localPeers;
+            std::vector<int> remotePeers;
+            for (int peer = 0; peer < n; ++peer) {
+                if (peer != i) {
+                    (peer % numZones == i % numZones ? localPeers : remotePeers).push_back(peer);
+                }
+            }
+            schedules.emplace_back(localPeers, remotePeers, point.m_remoteProbability, gen());
+        }
+    }
+
+    std::vector<RumorMember> members;
+    members.reserve(static_cast<size_t>(n));
+    for (int i = 0; i < n; ++i) {
+        RumorMember::NextMemberCb nextCb = [&gen, i, n]() {
+            std::uniform_int_distribution<int> dis(0, n - 2);
+            int peer = dis(gen);
+            return peer >= i ? peer + 1 : peer;
+        };
+        if (numZones > 1) {
+            nextCb = [&schedules, i]() {
+                return schedules[i].next();
+            };
+        }
+        members.emplace_back(peerIds, networkConfig, nextCb, i);
+    }
+
+    const int rumorId = 0;
+    members[0].addRumor(rumorId);
+
+    long numMessages = 0;
+    long numCrossZone = 0;
+    int roundsToCoverage = 0;
+    int round = 0;
+    const int maxRounds = 4 * (point.m_maxRoundsTotal + point.m_maxRoundsInB + point.m_maxRoundsInC);
+    while (round < maxRounds) {
+        ++round;
+        for (int from = 0; from < n; ++from) {
+            std::pair<int, std::vector<Message>> push = members[from].advanceRound();
+            if (push.first < 0) {
+                continue;
+            }
+
+            const long numCrossing = from % numZones != push.first % numZones ? 1 : 0;
+            for (const Message& pushMsg : push.second) {
+                ++numMessages;
+                numCrossZone += numCrossing;
+                if (lost(gen)) {
+                    continue;
+                }
+
+                std::pair<int, std::vector<Message>> pull =
+                    members[push.first].receivedMessage(pushMsg, from);
+                for (const Message& pullMsg : pull.second) {
+                    ++numMessages;
+                    numCrossZone += numCrossing;
+                    if (!lost(gen)) {
+                        members[pull.first].receivedMessage(pullMsg, push.first);
+                    }
+                }
+            }
+        }
+
+        bool allOld = true;
+        bool allKnow = true;
+        for (const RumorMember& member : members) {
+            allKnow = allKnow && member.rumorExists(rumorId);
+            if (member.rumorExists(rumorId) && !member.isOld(rumorId)) {
+                allOld = false;
+            }
+        }
+        if (allKnow && roundsToCoverage == 0) {
+            roundsToCoverage = round;
+        }
+        if (allOld) {
+            break;
+        }
+    }
+
+    int numCovered = 0;
+    for (const RumorMember& member : members) {
+        numCovered += member.rumorExists(rumorId) ? 1 : 0;
+    }
+
+    RunResult result;
+    result.m_fullCoverage = numCovered == n;
+    result.m_coverage = static_cast<double>(numCovered) / n;
+    result.m_roundsToOld = round;
+    result.m_roundsToCoverage = roundsToCoverage;
+    result.m_messagesPerMember = static_cast<double>(numMessages) / n;
+    result.m_crossZoneFraction = numMessages > 0 ? static_cast<double>(numCrossZone) / numMessages : 0;
+    return result;
+}
+
+std::vector<Summary> runSweep(const std::vector<GridPoint>& grid, const Options& options)
+{
+    const size_t numTasks = grid.size() * static_cast<size_t>(options.m_runs);
+    std::vector<RunResult> results(numTasks);
+    std::atomic<size_t> nextTask(0);
+
+    auto worker = [&]() {
+        for (size_t task = nextTask++; task < numTasks; task = nextTask++) {
+            const GridPoint& point = grid[task / options.m_runs];
+            results[task] = runOnce(point, options.m_seed + static_cast<unsigned>(task));
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned i = 0; i < options.m_threads; ++i) {
+        threads.emplace_back(worker);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::vector<Summary> summaries;
+    for (size_t p = 0; p < grid.size(); ++p) {
+        Summary summary;
+        summary.m_point = grid[p];
+        for (int run = 0; run < options.m_runs; ++run) {
+            const RunResult& result = results[p * options.m_runs + run];
+            summary.m_coverageProbability += result.m_fullCoverage ? 1 : 0;
+            summary.m_meanCoverage += result.m_coverage;
+            summary.m_meanRoundsToOld += result.m_roundsToOld;
+            summary.m_maxRoundsToOld = std::max(summary.m_maxRoundsToOld, result.m_roundsToOld);
+            summary.m_meanRoundsToCoverage += result.m_roundsToCoverage;
+            summary.m_messagesPerMember += result.m_messagesPerMember;
+            summary.m_crossZoneFraction += result.m_crossZoneFraction;
+        }
+        const double numCovered = summary.m_coverageProbability;
+        summary.m_meanRoundsToCoverage /= std::max(1.0, numCovered);
+        summary.m_coverageProbability /= options.m_runs;
+        summary.m_meanCoverage /= options.m_runs;
+        summary.m_meanRoundsToOld /= options.m_runs;
+        summary.m_messagesPerMember /= options.m_runs;
+        summary.m_crossZoneFraction /= options.m_runs;
+        summaries.push_back(summary);
+    }
+    return summaries;
+}
+
+// Cheapest configuration per (size, loss rate, zones, remote probability) that meets the target
+// coverage probability.
+std::vector<Summary> recommend(const std::vector<Summary>& summaries, double targetCoverage)
+{
+    std::map<std::tuple<int, double, int, double>, Summary> best;
+    for (const Summary& summary : summaries) {
+        if (summary.m_coverageProbability < targetCoverage) {
+            continue;
+        }
+        const auto key = std::make_tuple(summary.m_point.m_size, summary.m_point.m_lossRate,
+                                         summary.m_point.m_numZones, summary.m_point.m_remoteProbability);
+        auto iter = best.find(key);
+        if (iter == best.end() || summary.m_messagesPerMember < iter->second.m_messagesPerMember) {
+            best[key] = summary;
+        }
+    }
+
+    std::vector<Summary> recommendations;
+    for (const auto& kv : best) {
+        recommendations.push_back(kv.second);
+    }
+    return recommendations;
+}
+
+void printCsvRows(std::ostream& os, const std::vector<Summary>& summaries)
+{
+    os << "size,loss,maxRoundsInB,maxRoundsInC,maxRoundsTotal,zones,remote,coverageProbability,"
+       << "meanCoverage,meanRoundsToCoverage,meanRoundsToOld,maxRoundsToOld,messagesPerMember,"
+       << "crossZoneFraction\n";
+    for (const Summary& s : summaries) {
+        os << s.m_point.m_size << "," << s.m_point.m_lossRate << ","
+           << s.m_point.m_maxRoundsInB << "," << s.m_point.m_maxRoundsInC << ","
+           << s.m_point.m_maxRoundsTotal << "," << s.m_point.m_numZones << ","
+           << s.m_point.m_remoteProbability << "," << s.m_coverageProbability << ","
+           << s.m_meanCoverage << "," << s.m_meanRoundsToCoverage << "," << s.m_meanRoundsToOld << ","
+           << s.m_maxRoundsToOld << "," << s.m_messagesPerMember << "," << s.m_crossZoneFraction << "\n";
+    }
+}
+
+void printJsonRows(std::ostream& os, const std::vector<Summary>& summaries)
+{
+    os << "[";
+    for (size_t i = 0; i < summaries.size(); ++i) {
+        const Summary& s = summaries[i];
+        os << (i == 0 ? "\n" : ",\n")
+           << "    {\"size\": " << s.m_point.m_size
+           << ", \"loss\": " << s.m_point.m_lossRate
+           << ", \"maxRoundsInB\": " << s.m_point.m_maxRoundsInB
+           << ", \"maxRoundsInC\": " << s.m_point.m_maxRoundsInC
+           << ", \"maxRoundsTotal\": " << s.m_point.m_maxRoundsTotal
+           << ", \"zones\": " << s.m_point.m_numZones
+           << ", \"remote\": " << s.m_point.m_remoteProbability
+           << ", \"coverageProbability\": " << s.m_coverageProbability
+           << ", \"meanCoverage\": " << s.m_meanCoverage
+           << ", \"meanRoundsToCoverage\": " << s.m_meanRoundsToCoverage
+           << ", \"meanRoundsToOld\": " << s.m_meanRoundsToOld
+           << ", \"maxRoundsToOld\": " << s.m_maxRoundsToOld
+           << ", \"messagesPerMember\": " << s.m_messagesPerMember
+           << ", \"crossZoneFraction\": " << s.m_crossZoneFraction
+           << "}";
+    }
+    os << "\n  ]";
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[])
+{
+    Options options;
+    if (!parseOptions(argc, argv, options) || options.m_runs <= 0) {
+        return 1;
+    }
+
+    const std::vector<GridPoint> grid = buildGrid(options);
+    const std::vector<Summary> summaries = runSweep(grid, options);
+    const std::vector<Summary> recommendations = recommend(summaries, options.m_targetCoverage);
+
+    if (options.m_format == "json") {
+        std::cout << "{\n  \"targetCoverage\": " << options.m_targetCoverage
+                  << ",\n  \"runsPerPoint\": " << options.m_runs
+                  << ",\n  \"results\": ";
+        printJsonRows(std::cout, summaries);
+        std::cout << ",\n  \"recommendations\": ";
+        printJsonRows(std::cout, recommendations);
+        std::cout << "\n}" << std::endl;
+    }
+    else {
+        printCsvRows(std::cout, summaries);
+        std::cout << "\n# recommendations for target coverage " << options.m_targetCoverage << "\n";
+        printCsvRows(std::cout, recommendations);
+    }
+
+    return 0;
+}
@@ -0,0 +1,240 @@
+// Receive path benchmark under duplicate traffic.
+//
+// Feeds a member the PUSH messages of its peers round after round, as a transport would deliver
+// them, and reports the throughput of 'RumorMember::receivedMessage' for each duplicate rate.
+// Every round the member starts '--rumors' rumors and each peer pushes '--messages' of the rumors
+// of the last rounds, some not known by the member yet, all NEW. A duplicate is a copy of a
+// message of the round delivered again later in the same round, like a retransmit or a duplicated
+// datagram. The messages are generated up front so that only the member is measured. The rumor
+// table is bounded by '--max-rumors', see 'RumorMember::setMaxRumors', so that the PULL messages
+// answering the first PUSH of each peer do not grow with the run.
+//
+// The sparse runs then fill an unbounded table of each of the '--sparse' sizes with rumors that are
+// not consecutive, one message per rumor, within a round. The time per message must not grow with
+// the table, every message changes the published 'RumorView'.
+//
+// Usage:
+//   ReceiveBench [--peers 32] [--rumors 16] [--messages 16] [--rounds 200] [--max-rumors 256]
+//                [--duplicates 0,0.05,0.1,0.2] [--sparse 10000,20000,40000] [--seed 1]
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <Message.h>
+#include <NetworkConfig.h>
+#include <RumorMember.h>
+
+using namespace RRS;
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+struct Options {
+    int                 m_peers = 32;
+    int                 m_rumors = 16;     // new rumors per round at the member
+    int                 m_messages = 16;   // messages per peer and round
+    int                 m_rounds = 200;
+    int                 m_maxRumors = 256;
+    std::vector<double> m_duplicateRates = {0, 0.05, 0.1, 0.2};
+    std::vector<int>    m_sparseSizes = {10000, 20000, 40000};
+    unsigned            m_seed = 1;
+};
+
+struct Result {
+    double m_duplicateRate;
+    long   m_numMessages;          // including the duplicates
+    long   m_numDuplicates;
+    double m_duplicateRumors;      // 'NumDuplicateRumors' of the member
+    double m_seconds;
+};
+
+struct SparseResult {
+    int    m_numRumors;
+    double m_seconds;
+};
+
+// (from member, message) in delivery order
+typedef std::vector<std::pair<int, Message>> Round;
+
+bool parseOptions(int argc, char* argv[], Options& options)
+{
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << std::endl;
+            return false;
+        }
+        const std::string value = argv[++i];
+        if (arg == "--peers") {
+            options.m_peers = std::stoi(value);
+        }
+        else if (arg == "--rumors") {
+            options.m_rumors = std::stoi(value);
+        }
+        else if (arg == "--messages") {
+            options.m_messages = std::stoi(value);
+        }
+        else if (arg == "--rounds") {
+            options.m_rounds = std::stoi(value);
+        }
+        else if (arg == "--max-rumors") {
+            options.m_maxRumors = std::stoi(value);
+        }
+        else if (arg == "--duplicates") {
+            options.m_duplicateRates.clear();
+            std::stringstream stream(value);
+            std::string item;
+            while (std::getline(stream, item, ',')) {
+                options.m_duplicateRates.push_back(std::stod(item));
+            }
+        }
+        else if (arg == "--sparse") {
+            options.m_sparseSizes.clear();
+            std::stringstream stream(value);
+            std::string item;
+            while (std::getline(stream, item, ',')) {
+                options.m_sparseSizes.push_back(std::stoi(item));
+            }
+        }
+        else if (arg == "--seed") {
+            options.m_seed = static_cast<unsigned>(std::stoul(value));
+        }
+        else {
+            std::cerr << "Unknown option " << arg << std::endl;
+            return false;
+        }
+    }
+    return options.m_peers > 0 && options.m_rumors > 0 && options.m_messages > 0 && options.m_rounds > 0 &&
+           options.m_maxRumors >= 0 &&
+           std::all_of(options.m_sparseSizes.begin(), options.m_sparseSizes.end(), [](int n) { return n > 0; });
+}
+
+// The traffic of every round, with each message copied later in its round with probability
+// 'duplicateRate'
+std::vector<Round> makeRounds(const Options& options, double duplicateRate, long& numDuplicates)
+{
+    std::mt19937 rng(options.m_seed);
+    std::bernoulli_distribution isDuplicated(duplicateRate);
+    std::vector<Round> rounds(static_cast<size_t>(options.m_rounds));
+    numDuplicates = 0;
+    for (int round = 0; round < options.m_rounds; ++round) {
+        // The rumors of the last two rounds and of the next one
+        const int first = std::max(0, (round - 2) * options.m_rumors);
+        std::uniform_int_distribution<int> rumorId(first, (round + 1) * options.m_rumors - 1);
+        std::uniform_int_distribution<int> age(0, 2);
+
+        Round& messages = rounds[round];
+        for (int peer = 1; peer <= options.m_peers; ++peer) {
+            for (int i = 0; i < options.m_messages; ++i) {
+                messages.emplace_back(peer, Message(Message::Type::PUSH, rumorId(rng), age(rng)));
+            }
+        }
+        std::shuffle(messages.begin(), messages.end(), rng);
+
+        const size_t numOriginal = messages.size();
+        for (size_t i = 0; i < numOriginal; ++i) {
+            if (isDuplicated(rng)) {
+                const size_t at = std::uniform_int_distribution<size_t>(i + 1, messages.size())(rng);
+                messages.insert(messages.begin() + at, messages[i]);
+                ++numDuplicates;
+            }
+        }
+    }
+    return rounds;
+}
+
+Result run(const Options& options, double duplicateRate)
+{
+    Result result = {duplicateRate, 0, 0, 0, 0};
+    const std::vector<Round> rounds = makeRounds(options, duplicateRate, result.m_numDuplicates);
+
+    std::unordered_set<int> peerIds;
+    for (int i = 0; i <= options.m_peers; ++i) {
+        peerIds.insert(i);
+    }
+    RumorMember member(peerIds, NetworkConfig(peerIds.size()), [] { return 1; }, 0);
+    member.setMaxRumors(static_cast<size_t>(options.m_maxRumors));
+
+    // Only the delivery of the messages is timed, not the rounds
+    Clock::duration elapsed = Clock::duration::zero();
+    for (int round = 0; round < options.m_rounds; ++round) {
+        member.addRumors(round * options.m_rumors, static_cast<size_t>(options.m_rumors));
+        const Clock::time_point start = Clock::now();
+        for (const std::pair<int, Message>& delivery : rounds[round]) {
+            member.receivedMessage(delivery.second, delivery.first);
+        }
+        elapsed += Clock::now() - start;
+        result.m_numMessages += static_cast<long>(rounds[round].size());
+        member.advanceRound();
+    }
+
+    const auto& found = member.statistics().find(RumorMember::StatisticKey::NumDuplicateRumors);
+    result.m_duplicateRumors = found == member.statistics().end() ? 0 : found->second;
+    result.m_seconds = std::chrono::duration<double>(elapsed).count();
+    return result;
+}
+
+SparseResult runSparse(const Options& options, int numRumors)
+{
+    std::unordered_set<int> peerIds;
+    for (int i = 0; i <= options.m_peers; ++i) {
+        peerIds.insert(i);
+    }
+    RumorMember member(peerIds, NetworkConfig(peerIds.size()), [] { return 1; }, 0);
+
+    // Every other ID so that no two rumors share a range, in a shuffled order
+    std::vector<int> rumorIds(static_cast<size_t>(numRumors));
+    for (int i = 0; i < numRumors; ++i) {
+        rumorIds[i] = 2 * i;
+    }
+    std::mt19937 rng(options.m_seed);
+    std::shuffle(rumorIds.begin(), rumorIds.end(), rng);
+
+    const Clock::time_point start = Clock::now();
+    for (const int rumorId : rumorIds) {
+        member.receivedMessage(Message(Message::Type::PUSH, rumorId, 0), 1);
+    }
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return {numRumors, seconds};
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[])
+{
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        return 1;
+    }
+
+    std::cout << "{\n  \"peers\": " << options.m_peers
+              << ",\n  \"messagesPerPeer\": " << options.m_messages
+              << ",\n  \"rounds\": " << options.m_rounds
+              << ",\n  \"results\": [";
+    for (size_t i = 0; i < options.m_duplicateRates.size(); ++i) {
+        const Result result = run(options, options.m_duplicateRates[i]);
+        std::cout << (i > 0 ? "," : "") << "\n    {\"duplicates\": " << result.m_duplicateRate
+                  << ", \"messages\": " << result.m_numMessages
+                  << ", \"duplicateMessages\": " << result.m_numDuplicates
+                  << ", \"duplicateRumors\": " << result.m_duplicateRumors
+                  << ", \"messagesPerSecond\": " << result.m_numMessages / result.m_seconds
+                  << ", \"nsPerMessage\": " << 1e9 * result.m_seconds / result.m_numMessages << "}";
+    }
+    std::cout << "\n  ],\n  \"sparse\": [";
+    for (size_t i = 0; i < options.m_sparseSizes.size(); ++i) {
+        const SparseResult result = runSparse(options, options.m_sparseSizes[i]);
+        std::cout << (i > 0 ? "," : "") << "\n    {\"rumors\": " << result.m_numRumors
+                  << ", \"seconds\": " << result.m_seconds
+                  << ", \"nsPerMessage\": " << 1e9 * result.m_seconds / result.m_numRumors << "}";
+    }
+    std::cout << "\n  ]\n}" << std::endl;
+    return 0;
+}
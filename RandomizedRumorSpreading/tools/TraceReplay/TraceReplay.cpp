@@ -0,0 +1,231 @@
+// Record and replay the inputs of a member.
+//
+// Replaying feeds a recorded trace (see 'RumorMember::record') to a fresh member as fast as it
+// can process it and reports the throughput, which isolates the cost of the protocol logic from
+// the transport and the other members. With '--repeat' the trace is replayed several times and
+// the fastest pass is reported. Phase times are included when the library is built with
+// 'RRS_PHASE_TIMERS'.
+//
+// Recording runs a round-synchronous simulation in which member 0 is recorded, as a quick way to
+// produce a trace without a deployment. Every member starts '--rumors' rumors per round during the
+// first half of the rounds.
+//
+// Usage:
+//   TraceReplay trace.bin [--repeat 1]
+//   TraceReplay --record trace.bin [--members 64] [--rounds 30] [--rumors 1] [--seed 1]
+//               [--ranges]
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <NetworkConfig.h>
+#include <PhaseTimers.h>
+#include <RumorMember.h>
+#include <TraceRecorder.h>
+#include <TraceReplayer.h>
+
+using namespace RRS;
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+struct Options {
+    std::string m_trace;
+    bool        m_record = false;
+    int         m_repeat = 1;
+    int         m_members = 64;
+    int         m_rounds = 30;
+    int         m_rumors = 1;      // new rumors per member and round
+    unsigned    m_seed = 1;
+    bool        m_ranges = false;
+};
+
+bool parseOptions(int argc, char* argv[], Options& options)
+{
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--ranges") {
+            options.m_ranges = true;
+            continue;
+        }
+        if (arg.compare(0, 2, "--") != 0) {
+            options.m_trace = arg;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << std::endl;
+            return false;
+        }
+        const std::string value = argv[++i];
+        if (arg == "--record") {
+            options.m_record = true;
+            options.m_trace = value;
+        }
+        else if (arg == "--repeat") {
+            options.m_repeat = std::stoi(value);
+        }
+        else if (arg == "--members") {
+            options.m_members = std::stoi(value);
+        }
+        else if (arg == "--rounds") {
+            options.m_rounds = std::stoi(value);
+        }
+        else if (arg == "--rumors") {
+            options.m_rumors = std::stoi(value);
+        }
+        else if (arg == "--seed") {
+            options.m_seed = static_cast<unsigned>(std::stoul(value));
+        }
+        else {
+            std::cerr << "Unknown option " << arg << std::endl;
+            return false;
+        }
+    }
+    if (options.m_trace.empty()) {
+        std::cerr << "Missing trace file" << std::endl;
+        return false;
+    }
+    return options.m_repeat > 0 && options.m_members > 1 && options.m_rounds > 0 && options.m_rumors >= 0;
+}
+
+// NEW rumors a member received again from a peer within a round
+long numDuplicateRumors(const RumorMember& member)
+{
+    const auto& found = member.statistics().find(RumorMember::StatisticKey::NumDuplicateRumors);
+    return found == member.statistics().end() ? 0 : static_cast<long>(found->second);
+}
+
+int record(const Options& options)
+{
+    std::ofstream out(options.m_trace, std::ios::binary);
+    if (!out) {
+        std::cerr << "Cannot open " << options.m_trace << std::endl;
+        return 1;
+    }
+
+    const int n = options.m_members;
+    std::mt19937 gen(options.m_seed);
+    std::unordered_set<int> peerIds;
+    for (int i = 0; i < n; ++i) {
+        peerIds.insert(i);
+    }
+
+    std::vector<RumorMember> members;
+    members.reserve(static_cast<size_t>(n));
+    for (int i = 0; i < n; ++i) {
+        auto nextCb = [&gen, i, n]() {
+            std::uniform_int_distribution<int> dis(0, n - 2);
+            int peer = dis(gen);
+            return peer >= i ? peer + 1 : peer;
+        };
+        members.emplace_back(peerIds, NetworkConfig(static_cast<size_t>(n)), nextCb, i);
+    }
+
+    TraceRecorder recorder(out);
+    members[0].record(&recorder);
+    for (RumorMember& member : members) {
+        member.setRangeMessages(options.m_ranges);
+    }
+
+    int nextRumorId = 0;
+    for (int round = 0; round < options.m_rounds; ++round) {
+        if (round < options.m_rounds / 2) {
+            for (RumorMember& member : members) {
+                member.addRumors(nextRumorId, static_cast<size_t>(options.m_rumors));
+                nextRumorId += options.m_rumors;
+            }
+        }
+
+        for (int from = 0; from < n; ++from) {
+            const std::pair<int, std::vector<Message>> push = members[from].advanceRound();
+            if (push.first < 0) {
+                continue;
+            }
+            for (const Message& pushMsg : push.second) {
+                const std::pair<int, std::vector<Message>> pull = members[push.first].receivedMessage(pushMsg, from);
+                for (const Message& pullMsg : pull.second) {
+                    members[pull.first].receivedMessage(pullMsg, push.first);
+                }
+            }
+        }
+    }
+    recorder.flush();
+
+    std::cout << "{\n  \"trace\": \"" << options.m_trace << "\""
+              << ",\n  \"members\": " << n
+              << ",\n  \"rounds\": " << options.m_rounds
+              << ",\n  \"records\": " << recorder.numRecords()
+              << ",\n  \"bytes\": " << out.tellp()
+              << ",\n  \"duplicateRumors\": " << numDuplicateRumors(members[0]) << "\n}" << std::endl;
+    return 0;
+}
+
+int replay(const Options& options)
+{
+    std::ifstream in(options.m_trace, std::ios::binary);
+    if (!in) {
+        std::cerr << "Cannot open " << options.m_trace << std::endl;
+        return 1;
+    }
+    TraceReplayer replayer(in);
+    if (!replayer.valid()) {
+        std::cerr << "Not a trace: " << options.m_trace << std::endl;
+        return 1;
+    }
+
+    double bestSeconds = 0;
+    for (int i = 0; i < options.m_repeat; ++i) {
+        replayer.reset();
+        const Clock::time_point start = Clock::now();
+        replayer.run();
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        if (replayer.failed()) {
+            std::cerr << "Trace is truncated or diverged after " << replayer.numRecords() << " records"
+                      << std::endl;
+            return 1;
+        }
+        if (i == 0 || seconds < bestSeconds) {
+            bestSeconds = seconds;
+        }
+    }
+
+    std::cout << "{\n  \"trace\": \"" << options.m_trace << "\""
+              << ",\n  \"records\": " << replayer.numRecords()
+              << ",\n  \"rounds\": " << replayer.numRounds()
+              << ",\n  \"messages\": " << replayer.numMessages()
+              << ",\n  \"duplicateRumors\": " << numDuplicateRumors(replayer.member())
+              << ",\n  \"outputMessages\": " << replayer.numOutputMessages()
+              << ",\n  \"seconds\": " << bestSeconds
+              << ",\n  \"recordsPerSecond\": " << replayer.numRecords() / bestSeconds
+              << ",\n  \"messagesPerSecond\": " << replayer.numMessages() / bestSeconds;
+    if (PhaseTimers::k_enabled) {
+        static const char* const phaseNames[] = {"lockWait", "stateUpdate", "messageBuild", "callbacks"};
+        const PhaseTimers::Snapshot snapshot = replayer.member().phaseTimes();
+        std::cout << ",\n  \"phases\": {";
+        for (size_t phase = 0; phase < PhaseTimers::k_numPhases; ++phase) {
+            std::cout << (phase > 0 ? ", " : "") << "\"" << phaseNames[phase] << "\": {\"count\": "
+                      << snapshot[phase].m_count << ", \"p50ns\": " << snapshot[phase].percentile(0.5)
+                      << ", \"p99ns\": " << snapshot[phase].percentile(0.99) << "}";
+        }
+        std::cout << "}";
+    }
+    std::cout << "\n}" << std::endl;
+    return 0;
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[])
+{
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        return 1;
+    }
+    return options.m_record ? record(options) : replay(options);
+}
@@ -0,0 +1,183 @@
+// Wire format benchmark.
+//
+// Encodes batches of messages shaped like the traffic of a member and reports, per workload, the
+// encoded bytes per message and per rumor next to the 21 bytes per message of the previous fixed
+// size encoding, and the decode throughput of 'WireFormat::decode' into a reused vector and of a
+// 'MessageView' iterated in place. Workloads:
+//   fresh:  pushes of consecutive rumor IDs with small ages, one size sample per batch
+//   ranges: pushes of runs of consecutive rumor IDs ('RumorMember::setRangeMessages')
+//   sparse: pushes of random rumor IDs with ages up to 'maxRoundsTotal'
+//
+// Usage:
+//   WireBench [--batch 64] [--frames 4096] [--iterations 50] [--seed 1]
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <Message.h>
+#include <MessageView.h>
+#include <WireFormat.h>
+
+using namespace RRS;
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+struct Options {
+    int      m_batch = 64;         // messages per frame
+    int      m_frames = 4096;      // distinct frames per workload
+    int      m_iterations = 50;    // decode passes over all the frames
+    unsigned m_seed = 1;
+};
+
+struct Result {
+    std::string m_workload;
+    double      m_bytesPerMessage;
+    double      m_bytesPerRumor;
+    double      m_decodeGBps;
+    double      m_viewGBps;
+};
+
+bool parseOptions(int argc, char* argv[], Options& options)
+{
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << std::endl;
+            return false;
+        }
+        const std::string value = argv[++i];
+        if (arg == "--batch") {
+            options.m_batch = std::stoi(value);
+        }
+        else if (arg == "--frames") {
+            options.m_frames = std::stoi(value);
+        }
+        else if (arg == "--iterations") {
+            options.m_iterations = std::stoi(value);
+        }
+        else if (arg == "--seed") {
+            options.m_seed = static_cast<unsigned>(std::stoul(value));
+        }
+        else {
+            std::cerr << "Unknown option " << arg << std::endl;
+            return false;
+        }
+    }
+    return options.m_batch > 0 && options.m_frames > 0 && options.m_iterations > 0;
+}
+
+std::vector<Message> makeBatch(const std::string& workload, int batch, int frame, std::mt19937& rng)
+{
+    std::vector<Message> messages;
+    messages.reserve(batch);
+    if (workload == "fresh") {
+        std::uniform_int_distribution<int> age(0, 12);
+        for (int i = 0; i < batch; ++i) {
+            messages.emplace_back(Message::Type::PUSH, frame * batch + i, age(rng));
+        }
+    }
+    else if (workload == "ranges") {
+        std::uniform_int_distribution<int> count(1, 64);
+        std::uniform_int_distribution<int> age(0, 12);
+        int rumorId = frame * batch * 32;
+        for (int i = 0; i < batch; ++i) {
+            const int numRumors = count(rng);
+            messages.emplace_back(Message::Type::PUSH, rumorId, age(rng), numRumors);
+            rumorId += numRumors + 1;
+        }
+    }
+    else {
+        std::uniform_int_distribution<int> id(0, 1 << 30);
+        std::uniform_int_distribution<int> age(0, 40);
+        for (int i = 0; i < batch; ++i) {
+            messages.emplace_back(Message::Type::PUSH, id(rng), age(rng));
+        }
+    }
+    messages.front().setSizeSample(rng() | (uint64_t(1) << 51));
+    return messages;
+}
+
+Result run(const std::string& workload, const Options& options)
+{
+    std::mt19937 rng(options.m_seed);
+    std::vector<std::vector<char>> frames;
+    size_t numBytes = 0;
+    size_t numMessages = 0;
+    size_t numRumors = 0;
+    for (int frame = 0; frame < options.m_frames; ++frame) {
+        const std::vector<Message> messages = makeBatch(workload, options.m_batch, frame, rng);
+        std::vector<char> buffer(WireFormat::maxFrameSize(messages.size()));
+        buffer.resize(WireFormat::encode(frame, messages.data(), messages.size(), buffer.data()));
+        numBytes += buffer.size();
+        numMessages += messages.size();
+        for (const Message& message : messages) {
+            numRumors += message.count();
+        }
+        frames.push_back(std::move(buffer));
+    }
+
+    // The checksums keep the compiler from dropping the decoding
+    uint64_t checksum = 0;
+    std::vector<Message> decoded;
+    int fromMember;
+    Clock::time_point start = Clock::now();
+    for (int i = 0; i < options.m_iterations; ++i) {
+        for (const std::vector<char>& frame : frames) {
+            if (WireFormat::decode(frame.data(), frame.size(), fromMember, decoded)) {
+                checksum += decoded.back().rumorId();
+            }
+        }
+    }
+    const double decodeSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    start = Clock::now();
+    for (int i = 0; i < options.m_iterations; ++i) {
+        for (const std::vector<char>& frame : frames) {
+            for (const Message& message : MessageView(frame.data(), frame.size())) {
+                checksum += message.age();
+            }
+        }
+    }
+    const double viewSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+    if (checksum == 1) {
+        std::cerr << "";
+    }
+
+    const double decodedBytes = static_cast<double>(numBytes) * options.m_iterations;
+    return {workload,
+            static_cast<double>(numBytes) / numMessages,
+            static_cast<double>(numBytes) / numRumors,
+            decodedBytes / decodeSeconds / 1e9,
+            decodedBytes / viewSeconds / 1e9};
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[])
+{
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        return 1;
+    }
+
+    std::cout << "{\n  \"batch\": " << options.m_batch
+              << ",\n  \"fixedBytesPerMessage\": 21"
+              << ",\n  \"results\": [";
+    const std::vector<std::string> workloads = {"fresh", "ranges", "sparse"};
+    for (size_t i = 0; i < workloads.size(); ++i) {
+        const Result result = run(workloads[i], options);
+        std::cout << (i > 0 ? "," : "") << "\n    {\"workload\": \"" << result.m_workload
+                  << "\", \"bytesPerMessage\": " << result.m_bytesPerMessage
+                  << ", \"bytesPerRumor\": " << result.m_bytesPerRumor
+                  << ", \"decodeGBps\": " << result.m_decodeGBps
+                  << ", \"viewGBps\": " << result.m_viewGBps << "}";
+    }
+    std::cout << "\n  ]\n}" << std::endl;
+    return 0;
+}